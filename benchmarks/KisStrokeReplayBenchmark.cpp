@@ -0,0 +1,257 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeReplayBenchmark.h"
+
+#include <simpletest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <algorithm>
+
+#include <KoCanvasResourceProvider.h>
+#include <KoColor.h>
+#include <KoCompositeOpRegistry.h>
+#include <kundo2magicstring.h>
+
+#include "KisPart.h"
+#include "KisDocument.h"
+#include "KisViewManager.h"
+#include "kis_image.h"
+#include "kis_layer_utils.h"
+#include "kis_node.h"
+#include "kis_resources_snapshot.h"
+#include "kis_canvas_resource_provider.h"
+#include <brushengine/kis_paintop_preset.h>
+#include <KisGlobalResourcesInterface.h>
+#include "KisRunnableStrokeJobData.h"
+#include "KisAsyncronousStrokeUpdateHelper.h"
+#include "KisFreehandStrokeRecorder.h"
+#include "strokes/freehand_stroke.h"
+#include "strokes/KisFreehandStrokeInfo.h"
+
+/**
+ * Replays a session recorded by KisFreehandStrokeRecorder against
+ * the image it was recorded on:
+ *
+ * KRITA_REPLAY_IMAGE    --- the .kra file to paint on
+ * KRITA_REPLAY_LOG      --- the log written via KRITA_STROKE_LOG
+ * KRITA_REPLAY_REALTIME --- if set to 0, all the jobs of a stroke are
+ *                           submitted at once, otherwise they are
+ *                           submitted with the recorded timing
+ *
+ * The gaps between the strokes are not reproduced, every stroke starts
+ * as soon as the previous one is completed.
+ *
+ * The latency of a job is the time between its submission and the end
+ * of its execution. The completion time of a stroke is the time from
+ * ending the stroke till the scheduler is idle, including the final
+ * update of the projection.
+ */
+
+namespace {
+
+struct LatencyStats {
+    qint64 p50 = 0;
+    qint64 p90 = 0;
+    qint64 p99 = 0;
+    qint64 max = 0;
+};
+
+LatencyStats calculateStats(QVector<qint64> values)
+{
+    LatencyStats stats;
+    if (values.isEmpty()) return stats;
+
+    std::sort(values.begin(), values.end());
+
+    auto percentile = [&values] (int p) {
+        const int index = qBound(0, (values.size() * p + 99) / 100 - 1, values.size() - 1);
+        return values[index];
+    };
+
+    stats.p50 = percentile(50);
+    stats.p90 = percentile(90);
+    stats.p99 = percentile(99);
+    stats.max = values.last();
+
+    return stats;
+}
+
+QString formatStats(const LatencyStats &stats)
+{
+    return QString("p50 %1 p90 %2 p99 %3 max %4 (ms)")
+        .arg(stats.p50 / 1000.0, 0, 'f', 2)
+        .arg(stats.p90 / 1000.0, 0, 'f', 2)
+        .arg(stats.p99 / 1000.0, 0, 'f', 2)
+        .arg(stats.max / 1000.0, 0, 'f', 2);
+}
+
+void setupResourceManager(KoCanvasResourceProvider *manager,
+                          KisNodeSP node,
+                          const KisFreehandStrokeRecorder::Stroke &stroke)
+{
+    QVariant i;
+
+    i.setValue(stroke.fgColor);
+    manager->setResource(KoCanvasResource::ForegroundColor, i);
+
+    i.setValue(stroke.bgColor);
+    manager->setResource(KoCanvasResource::BackgroundColor, i);
+
+    i.setValue(node);
+    manager->setResource(KoCanvasResource::CurrentKritaNode, i);
+
+    i.setValue(stroke.preset);
+    manager->setResource(KoCanvasResource::CurrentPaintOpPreset, i);
+
+    i.setValue(stroke.compositeOpId.isEmpty() ? COMPOSITE_OVER : stroke.compositeOpId);
+    manager->setResource(KoCanvasResource::CurrentCompositeOp, i);
+
+    i.setValue(qreal(stroke.opacity) / OPACITY_OPAQUE_U8);
+    manager->setResource(KoCanvasResource::Opacity, i);
+}
+
+FreehandStrokeStrategy::Data* createJobData(const KisFreehandStrokeRecorder::Job &job)
+{
+    switch (job.type) {
+    case KisFreehandStrokeRecorder::Job::POINT:
+        return new FreehandStrokeStrategy::Data(job.strokeInfoId, job.pi1);
+    case KisFreehandStrokeRecorder::Job::LINE:
+        return new FreehandStrokeStrategy::Data(job.strokeInfoId, job.pi1, job.pi2);
+    case KisFreehandStrokeRecorder::Job::CURVE:
+        return new FreehandStrokeStrategy::Data(job.strokeInfoId, job.pi1, job.control1, job.control2, job.pi2);
+    }
+
+    return 0;
+}
+
+}
+
+void KisStrokeReplayBenchmark::testReplay()
+{
+    const QString imageFileName = QString::fromLocal8Bit(qgetenv("KRITA_REPLAY_IMAGE"));
+    const QString logFileName = QString::fromLocal8Bit(qgetenv("KRITA_REPLAY_LOG"));
+    const bool realtime = qgetenv("KRITA_REPLAY_REALTIME") != "0";
+
+    if (imageFileName.isEmpty() || logFileName.isEmpty()) {
+        QSKIP("Set KRITA_REPLAY_IMAGE and KRITA_REPLAY_LOG to run the replay benchmark");
+    }
+
+    QVector<KisFreehandStrokeRecorder::Stroke> strokes;
+    QVERIFY(KisFreehandStrokeRecorder::loadLog(logFileName, KisGlobalResourcesInterface::instance(), &strokes));
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    QVERIFY(doc->loadNativeFormat(imageFileName));
+
+    KisImageSP image = doc->image();
+    image->barrierLock();
+    image->unlock();
+
+    QScopedPointer<KoCanvasResourceProvider> manager(new KoCanvasResourceProvider());
+    KisViewManager::initializeResourceManager(manager.data());
+
+    QVector<qint64> allLatencies;
+    QVector<qint64> completionTimes;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int strokeIndex = 0; strokeIndex < strokes.size(); strokeIndex++) {
+        const KisFreehandStrokeRecorder::Stroke &stroke = strokes[strokeIndex];
+
+        KisNodeSP node = KisLayerUtils::recursiveFindNode(image->root(),
+            [&stroke] (KisNodeSP node) { return node->name() == stroke.nodeName; });
+
+        if (!node || !stroke.preset) {
+            qWarning() << "Skipping stroke" << strokeIndex << "on" << stroke.nodeName
+                       << ": the node or the preset is missing";
+            continue;
+        }
+
+        setupResourceManager(manager.data(), node, stroke);
+        KisResourcesSnapshotSP resources = new KisResourcesSnapshot(image, node, manager.data());
+
+        QVector<KisFreehandStrokeInfo*> strokeInfos;
+        for (int i = 0; i < stroke.numStrokeInfos; i++) {
+            strokeInfos << new KisFreehandStrokeInfo();
+        }
+
+        KisStrokeId strokeId =
+            image->startStroke(new FreehandStrokeStrategy(resources, strokeInfos,
+                                                          kundo2_noi18n(stroke.name)));
+
+        QVector<qint64> submitTimes(stroke.jobs.size(), 0);
+        QVector<qint64> finishTimes(stroke.jobs.size(), 0);
+
+        const qint64 strokeStart = timer.nsecsElapsed() / 1000;
+
+        for (int i = 0; i < stroke.jobs.size(); i++) {
+            const KisFreehandStrokeRecorder::Job &job = stroke.jobs[i];
+
+            if (realtime) {
+                const qint64 delay = strokeStart + job.time - timer.nsecsElapsed() / 1000;
+                if (delay > 0) {
+                    QThread::usleep(delay);
+                }
+            }
+
+            submitTimes[i] = timer.nsecsElapsed() / 1000;
+            image->addJob(strokeId, createJobData(job));
+
+            /**
+             * The painting jobs are uniquely concurrent, so the probe is
+             * executed right after the job it follows is completed
+             */
+            qint64 *finishTime = &finishTimes[i];
+            image->addJob(strokeId,
+                new KisRunnableStrokeJobData([finishTime, &timer] () {
+                    *finishTime = timer.nsecsElapsed() / 1000;
+                }, KisStrokeJobData::UNIQUELY_CONCURRENT));
+        }
+
+        image->addJob(strokeId, new KisAsyncronousStrokeUpdateHelper::UpdateData(true));
+
+        const qint64 strokeEnd = timer.nsecsElapsed() / 1000;
+
+        if (stroke.cancelled) {
+            image->cancelStroke(strokeId);
+        } else {
+            image->endStroke(strokeId);
+        }
+
+        image->waitForDone();
+
+        const qint64 completionTime = timer.nsecsElapsed() / 1000 - strokeEnd;
+        completionTimes.append(completionTime);
+
+        QVector<qint64> latencies;
+        for (int i = 0; i < stroke.jobs.size(); i++) {
+            // the jobs of a cancelled stroke may be dropped
+            if (finishTimes[i] <= 0) continue;
+            latencies.append(finishTimes[i] - submitTimes[i]);
+        }
+        allLatencies += latencies;
+
+        qDebug() << qPrintable(QString("Stroke %1 \"%2\" on \"%3\": jobs %4 latency %5 completion %6 (ms)")
+                               .arg(strokeIndex)
+                               .arg(stroke.preset->name())
+                               .arg(stroke.nodeName)
+                               .arg(latencies.size())
+                               .arg(formatStats(calculateStats(latencies)))
+                               .arg(completionTime / 1000.0, 0, 'f', 2));
+    }
+
+    qDebug() << qPrintable(QString("Total: strokes %1 jobs %2 time %3 (ms)")
+                           .arg(completionTimes.size())
+                           .arg(allLatencies.size())
+                           .arg(timer.elapsed()));
+    qDebug() << qPrintable(QString("Job latency: %1").arg(formatStats(calculateStats(allLatencies))));
+    qDebug() << qPrintable(QString("Stroke completion: %1").arg(formatStats(calculateStats(completionTimes))));
+}
+
+SIMPLE_TEST_MAIN(KisStrokeReplayBenchmark)
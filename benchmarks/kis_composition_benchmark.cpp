@@ -34,11 +34,14 @@
 #include <KoColorSpace.h>
 #include <KoCompositeOp.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
 
 #include <KoColorSpaceTraits.h>
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpRegistry.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -169,6 +172,25 @@ struct RandomGenerator<double> : RandomGenerator<float>
     }
 };
 
+#ifdef HAVE_OPENEXR
+template <>
+struct RandomGenerator<half> : RandomGenerator<float>
+{
+    RandomGenerator(int seed)
+        : RandomGenerator<float>(seed)
+    {
+    }
+
+    half operator() () {
+        return half(RandomGenerator<float>::operator()());
+    }
+
+    half unit() {
+        return KoColorSpaceMathsTraits<half>::unitValue;
+    }
+};
+#endif
+
 
 template <typename channel_type>
 void generateDataLine(uint seed, int numPixels, quint8 *srcPixels, quint8 *dstPixels, quint8 *mask, AlphaRange srcAlphaRange, AlphaRange dstAlphaRange)
@@ -234,7 +256,8 @@ QVector<Tile> generateTiles(int size,
                             const int dstAlignmentShift,
                             AlphaRange srcAlphaRange,
                             AlphaRange dstAlphaRange,
-                            const quint32 pixelSize)
+                            const quint32 pixelSize,
+                            bool halfFloat = false)
 {
     QVector<Tile> tiles(size);
 
@@ -267,8 +290,12 @@ QVector<Tile> generateTiles(int size,
 
         if (pixelSize == 4) {
             generateDataLine<quint8>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
-        } else if (pixelSize == 8) {
+        } else if (pixelSize == 8 && !halfFloat) {
             generateDataLine<quint16>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#ifdef HAVE_OPENEXR
+        } else if (pixelSize == 8 && halfFloat) {
+            generateDataLine<half>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#endif
         } else if (pixelSize == 16) {
             generateDataLine<float>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
         } else {
@@ -295,6 +322,25 @@ inline bool fuzzyCompare(channel_type a, channel_type b, channel_type prec) {
     return qAbs(a - b) <= prec;
 }
 
+template <>
+inline bool fuzzyCompare<float>(float a, float b, float prec) {
+    // some blending modes, e.g. Color Dodge, give values
+    // above the unit in floating point color spaces
+    return qAbs(a - b) <= prec * qMax(1.0f, qAbs(b));
+}
+
+#ifdef HAVE_OPENEXR
+template <>
+inline bool fuzzyCompare<half>(half a, half b, half prec) {
+    return qAbs(float(a) - float(b)) <= float(prec) * qMax(1.0f, qAbs(float(b)));
+}
+#endif
+
+bool isHalfFloatColorSpace(const KoColorSpace *cs)
+{
+    return cs->colorDepthId() == Float16BitsColorDepthID;
+}
+
 template <typename channel_type>
 inline bool comparePixels(channel_type *p1, channel_type *p2, channel_type prec) {
     return (p1[3] == p2[3] && p1[3] == 0) ||
@@ -336,12 +382,14 @@ bool compareTwoOpsPixels(QVector<Tile> &tiles, channel_type prec) {
     return true;
 }
 
-bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2)
+bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2,
+                   quint8 precisionU8 = 10, float precisionF32 = 2e-7)
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
     const quint32 pixelSize = op1->colorSpace()->pixelSize();
+    const bool halfFloat = isHalfFloatColorSpace(op1->colorSpace());
     const int alignment = 16;
-    QVector<Tile> tiles = generateTiles(2, alignment, alignment, ALPHA_RANDOM, ALPHA_RANDOM, op1->colorSpace()->pixelSize());
+    QVector<Tile> tiles = generateTiles(2, alignment, alignment, ALPHA_RANDOM, ALPHA_RANDOM, pixelSize, halfFloat);
 
     KoCompositeOp::ParameterInfo params;
     params.dstRowStride  = 4 * rowStride;
@@ -366,13 +414,20 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
 
     bool compareResult = true;
     if (pixelSize == 4) {
-        compareResult = compareTwoOpsPixels<quint8>(tiles, 10);
+        compareResult = compareTwoOpsPixels<quint8>(tiles, precisionU8);
     }
-    else if (pixelSize == 8) {
+    else if (pixelSize == 8 && !halfFloat) {
         compareResult = compareTwoOpsPixels<quint16>(tiles, 90);
     }
+#ifdef HAVE_OPENEXR
+    else if (pixelSize == 8 && halfFloat) {
+        // the optimized ops round to half once, the legacy ones
+        // after every arithmetic operation
+        compareResult = compareTwoOpsPixels<half>(tiles, half(4e-3f));
+    }
+#endif
     else if (pixelSize == 16) {
-        compareResult = compareTwoOpsPixels<float>(tiles, 2e-7);
+        compareResult = compareTwoOpsPixels<float>(tiles, precisionF32);
     }
     else {
         qFatal("Pixel size %i is not implemented", pixelSize);
@@ -424,7 +479,8 @@ void benchmarkCompositeOp(const KoCompositeOp *op,
     QString testName = getTestName(haveMask, srcAlignmentShift, dstAlignmentShift, srcAlphaRange, dstAlphaRange);
 
     QVector<Tile> tiles =
-        generateTiles(numTiles, srcAlignmentShift, dstAlignmentShift, srcAlphaRange, dstAlphaRange, op->colorSpace()->pixelSize());
+        generateTiles(numTiles, srcAlignmentShift, dstAlignmentShift, srcAlphaRange, dstAlphaRange,
+                      op->colorSpace()->pixelSize(), isHalfFloatColorSpace(op->colorSpace()));
 
     const int tileOffset = 4 * (processRect.y() * rowStride + processRect.x());
 
@@ -481,6 +537,71 @@ void benchmarkCompositeOp(const KoCompositeOp *op, const QString &postfix)
     benchmarkCompositeOp(op, false, 1.0, 1.0, 0, 0, ALPHA_UNIT, ALPHA_UNIT);
 }
 
+template <class Traits>
+QVector<KoCompositeOp*> createLegacyBlendingOps(const KoColorSpace *cs)
+{
+    typedef typename Traits::channels_type T;
+
+    return QVector<KoCompositeOp*>()
+        << new KoCompositeOpGenericSC<Traits, &cfMultiply<T>>(cs, COMPOSITE_MULT, "Multiply", "")
+        << new KoCompositeOpGenericSC<Traits, &cfScreen<T>>(cs, COMPOSITE_SCREEN, "Screen", "")
+        << new KoCompositeOpGenericSC<Traits, &cfOverlay<T>>(cs, COMPOSITE_OVERLAY, "Overlay", "")
+        << new KoCompositeOpGenericSC<Traits, &cfColorDodge<T>>(cs, COMPOSITE_DODGE, "Color Dodge", "")
+        << new KoCompositeOpGenericSC<Traits, &cfLinearLight<T>>(cs, COMPOSITE_LINEAR_LIGHT, "Linear Light", "");
+}
+
+QVector<KoCompositeOp*> createOptimizedBlendingOps32(const KoColorSpace *cs)
+{
+    return QVector<KoCompositeOp*>()
+        << KoOptimizedCompositeOpFactory::createMultiplyOp32(cs)
+        << KoOptimizedCompositeOpFactory::createScreenOp32(cs)
+        << KoOptimizedCompositeOpFactory::createOverlayOp32(cs)
+        << KoOptimizedCompositeOpFactory::createColorDodgeOp32(cs)
+        << KoOptimizedCompositeOpFactory::createLinearLightOp32(cs);
+}
+
+QVector<KoCompositeOp*> createOptimizedBlendingOps128(const KoColorSpace *cs)
+{
+    return QVector<KoCompositeOp*>()
+        << KoOptimizedCompositeOpFactory::createMultiplyOp128(cs)
+        << KoOptimizedCompositeOpFactory::createScreenOp128(cs)
+        << KoOptimizedCompositeOpFactory::createOverlayOp128(cs)
+        << KoOptimizedCompositeOpFactory::createColorDodgeOp128(cs)
+        << KoOptimizedCompositeOpFactory::createLinearLightOp128(cs);
+}
+
+bool compareBlendingOps(const QVector<KoCompositeOp*> &actOps,
+                        const QVector<KoCompositeOp*> &expOps,
+                        quint8 precisionU8, float precisionF32)
+{
+    bool result = true;
+
+    for (int i = 0; i < actOps.size(); i++) {
+        Q_ASSERT(actOps[i]->id() == expOps[i]->id());
+
+        for (int haveMask = 0; haveMask <= 1; haveMask++) {
+            if (!compareTwoOps(haveMask, actOps[i], expOps[i], precisionU8, precisionF32)) {
+                qDebug() << "Failed op:" << actOps[i]->id() << "haveMask:" << bool(haveMask);
+                result = false;
+            }
+        }
+    }
+
+    qDeleteAll(actOps);
+    qDeleteAll(expOps);
+
+    return result;
+}
+
+void benchmarkBlendingOps(const QVector<KoCompositeOp*> &ops, const QString &postfix)
+{
+    Q_FOREACH (KoCompositeOp *op, ops) {
+        benchmarkCompositeOp(op, postfix);
+    }
+
+    qDeleteAll(ops);
+}
+
 #ifdef HAVE_VC
 
 template <typename channels_type>
@@ -745,6 +866,22 @@ void KisCompositionBenchmark::compareRgbU16AlphaDarkenOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16AlphaDarkenOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs);
+    KoCompositeOp *opExp = new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 void KisCompositionBenchmark::compareOverOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -781,6 +918,22 @@ void KisCompositionBenchmark::compareRgbU16OverOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16OverOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoRgbF16Traits>(cs);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 void KisCompositionBenchmark::compareRgbF32OverOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
@@ -817,6 +970,22 @@ void KisCompositionBenchmark::compareRgbU16CopyOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16CopyOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    KoCompositeOp *opExp = new KoCompositeOpCopy2<KoRgbF16Traits>(cs);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 void KisCompositionBenchmark::compareRgbF32CopyOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
@@ -829,6 +998,26 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU8BlendingOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // the integer math of the generic ops is reproduced exactly
+    QVERIFY(compareBlendingOps(createOptimizedBlendingOps32(cs),
+                               createLegacyBlendingOps<KoBgrU8Traits>(cs),
+                               0, 0));
+}
+
+void KisCompositionBenchmark::compareRgbF32BlendingOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+
+    // the generic ops use doubles for the intermediate values
+    QVERIFY(compareBlendingOps(createOptimizedBlendingOps128(cs),
+                               createLegacyBlendingOps<KoRgbF32Traits>(cs),
+                               0, 1e-6));
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -909,6 +1098,79 @@ void KisCompositionBenchmark::testRgb16CompositeCopyOptimized()
     benchmarkCompositeOp(op, "Optimized");
     delete op;
 }
+
+void KisCompositionBenchmark::testRgbF16CompositeAlphaDarkenLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeAlphaDarkenOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeOverLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpOver<KoRgbF16Traits>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeOverOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeCopyLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpCopy2<KoRgbF16Traits>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeCopyOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 void KisCompositionBenchmark::testRgbF32CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
@@ -957,6 +1219,30 @@ void KisCompositionBenchmark::testRgbF32CompositeCopyOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testRgb8CompositeBlendingLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    benchmarkBlendingOps(createLegacyBlendingOps<KoBgrU8Traits>(cs), "Legacy");
+}
+
+void KisCompositionBenchmark::testRgb8CompositeBlendingOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    benchmarkBlendingOps(createOptimizedBlendingOps32(cs), "Optimized");
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeBlendingLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    benchmarkBlendingOps(createLegacyBlendingOps<KoRgbF32Traits>(cs), "RGBF32 Legacy");
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeBlendingOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    benchmarkBlendingOps(createOptimizedBlendingOps128(cs), "RGBF32 Optimized");
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenReal_Aligned()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -34,17 +34,23 @@ private Q_SLOTS:
     void compareAlphaDarkenOps();
     void compareAlphaDarkenOpsNoMask();
     void compareRgbU16AlphaDarkenOps();
+    void compareRgbF16AlphaDarkenOps();
     void compareRgbF32AlphaDarkenOps();
 
     void compareOverOps();
     void compareOverOpsNoMask();
     void compareRgbU16OverOps();
+    void compareRgbF16OverOps();
     void compareRgbF32OverOps();
 
     void compareRgbU8CopyOps();
     void compareRgbU16CopyOps();
+    void compareRgbF16CopyOps();
     void compareRgbF32CopyOps();
 
+    void compareRgbU8BlendingOps();
+    void compareRgbF32BlendingOps();
+
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
 
@@ -60,6 +66,15 @@ private Q_SLOTS:
     void testRgb16CompositeCopyLegacy();
     void testRgb16CompositeCopyOptimized();
 
+    void testRgbF16CompositeAlphaDarkenLegacy();
+    void testRgbF16CompositeAlphaDarkenOptimized();
+
+    void testRgbF16CompositeOverLegacy();
+    void testRgbF16CompositeOverOptimized();
+
+    void testRgbF16CompositeCopyLegacy();
+    void testRgbF16CompositeCopyOptimized();
+
     void testRgbF32CompositeAlphaDarkenLegacy();
     void testRgbF32CompositeAlphaDarkenOptimized();
 
@@ -69,6 +84,12 @@ private Q_SLOTS:
     void testRgbF32CompositeCopyLegacy();
     void testRgbF32CompositeCopyOptimized();
 
+    void testRgb8CompositeBlendingLegacy();
+    void testRgb8CompositeBlendingOptimized();
+
+    void testRgbF32CompositeBlendingLegacy();
+    void testRgbF32CompositeBlendingOptimized();
+
     void testRgb8CompositeAlphaDarkenReal_Aligned();
     void testRgb8CompositeOverReal_Aligned();
 
@@ -8,7 +8,9 @@
 #include "kis_benchmark_values.h"
 
 #include <simpletest.h>
+#include <QtConcurrent>
 #include <kis_datamanager.h>
+#include "tiles3/kis_tile_data_allocator.h"
 
 // RGBA
 #define PIXEL_SIZE 4
@@ -186,5 +188,61 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+void KisDatamanagerBenchmark::benchmarkTileAllocation_data()
+{
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<bool>("useAllocator");
+
+    QTest::newRow("4bpp-allocator") << 4 << true;
+    QTest::newRow("4bpp-malloc") << 4 << false;
+    QTest::newRow("8bpp-allocator") << 8 << true;
+    QTest::newRow("8bpp-malloc") << 8 << false;
+    QTest::newRow("16bpp-allocator") << 16 << true;
+    QTest::newRow("16bpp-malloc") << 16 << false;
+}
+
+void KisDatamanagerBenchmark::benchmarkTileAllocation()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(bool, useAllocator);
+
+    /**
+     * Emulates COW of the updater context threads: every thread
+     * allocates a bunch of tiles, touches them and frees them back
+     */
+    const int numThreads = QThread::idealThreadCount();
+    const int numTiles = 256;
+    const int numCycles = 16;
+    const int tileSize = pixelSize * 64 * 64;
+
+    KisTileDataAllocator *allocator = KisTileDataAllocator::instance();
+
+    QVector<int> threads(numThreads);
+
+    auto worker = [&] (int) {
+        QVector<quint8*> tiles(numTiles);
+
+        for (int cycle = 0; cycle < numCycles; cycle++) {
+            for (int i = 0; i < numTiles; i++) {
+                tiles[i] = useAllocator ?
+                    allocator->allocate(pixelSize) :
+                    static_cast<quint8*>(malloc(tileSize));
+                tiles[i][i % tileSize] = quint8(i);
+            }
+
+            for (int i = 0; i < numTiles; i++) {
+                if (useAllocator) {
+                    allocator->free(tiles[i], pixelSize);
+                } else {
+                    free(tiles[i]);
+                }
+            }
+        }
+    };
+
+    QBENCHMARK {
+        QtConcurrent::blockingMap(threads, worker);
+    }
+}
 
 SIMPLE_TEST_MAIN(KisDatamanagerBenchmark)
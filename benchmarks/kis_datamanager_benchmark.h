@@ -24,6 +24,8 @@ private Q_SLOTS:
     void benchmarkExtent();
     void benchmarkClear();
     void benchmarkMemCpy();
+    void benchmarkTileAllocation_data();
+    void benchmarkTileAllocation();
 };
 
 #endif
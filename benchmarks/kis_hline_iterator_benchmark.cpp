@@ -14,6 +14,7 @@
 #include <KoColor.h>
 
 #include <simpletest.h>
+#include <QtConcurrent>
 
 #include "kis_iterator_ng.h"
 
@@ -84,6 +85,27 @@ void KisHLineIteratorBenchmark::benchmarkConstReadBytes()
     }
 }
 
+void KisHLineIteratorBenchmark::benchmarkConcurrentConstReadBytes()
+{
+    QVector<int> threads(QThread::idealThreadCount());
+
+    auto reader = [this] (int) {
+        KisHLineConstIteratorSP cit = m_device->createHLineConstIteratorNG(0, 0, TEST_IMAGE_WIDTH);
+        quint8 pixel[4];
+
+        for (int j = 0; j < TEST_IMAGE_HEIGHT; j++) {
+            do {
+                memcpy(pixel, cit->oldRawData(), m_colorSpace->pixelSize());
+            } while (cit->nextPixel());
+            cit->nextRow();
+        }
+    };
+
+    QBENCHMARK{
+        QtConcurrent::blockingMap(threads, reader);
+    }
+}
+
 void KisHLineIteratorBenchmark::benchmarkReadWriteBytes(){
     KoColor c(m_colorSpace);
     c.fromQColor(QColor(250,120,0));
@@ -35,6 +35,8 @@ private Q_SLOTS:
     void benchmarkReadBytes();
     // const hline iterator used
     void benchmarkConstReadBytes();
+    // const hline iterators reading the same tiles from all threads
+    void benchmarkConcurrentConstReadBytes();
     // copy from one device to another
     void benchmarkReadWriteBytes();
     
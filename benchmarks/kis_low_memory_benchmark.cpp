@@ -27,8 +27,14 @@
 #include "KisGlobalResourcesInterface.h"
 
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/kis_tile_data.h"
+#include "kis_datamanager.h"
+#include "tiles3/swap/kis_tile_compressor_2.h"
+#include "tiles3/swap/kis_swapped_data_store.h"
+#include "tiles3/swap/kis_mapped_swap_file.h"
 #include "kis_surrogate_undo_adapter.h"
 #include "kis_image_config.h"
+#include "kis_algebra_2d.h"
 #define LOAD_PRESET_OR_RETURN(preset, fileName)                         \
     if(!preset->load(KisGlobalResourcesInterface::instance())) { dbgKrita << "Preset" << fileName << "was NOT loaded properly. Done."; return; } \
     else dbgKrita << "Loaded preset:" << fileName
@@ -218,4 +224,180 @@ void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
                       2000, 600, 500, 0);
 }
 
+/**
+ * Compares the codecs available for the swap file. The tiles of
+ * a layer with a few dozens of real brush strokes are compressed
+ * and decompressed with every codec, the throughput and the
+ * compression ratio are printed in a table.
+ */
+void KisLowMemoryBenchmark::benchmarkSwapCompressionCodecs()
+{
+    QString presetFileName = "autobrush_300px.kpp";
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(QString(FILES_DATA_DIR) + '/' + presetFileName));
+    LOAD_PRESET_OR_RETURN(preset, presetFileName);
+
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 4000, 4000, colorSpace, "stroke sample image");
+    KisLayerSP layer = new KisPaintLayer(image, "temporary for stroke sample", OPACITY_OPAQUE_U8, colorSpace);
+    image->addNode(layer, image->root());
+
+    KisPainter painter(layer->paintDevice());
+    painter.setPaintColor(KoColor(Qt::black, colorSpace));
+    painter.setPaintOpPreset(preset, layer, image);
+
+    KisDistanceInformation currentDistance;
+    for (int i = 0; i < 16; i++) {
+        KisPaintInformation pi1(QPointF(150, 150 + i * 250), 0.0);
+        KisPaintInformation pi2(QPointF(3850, 150 + i * 250 + 125), 1.0);
+        painter.paintLine(pi1, pi2, &currentDistance);
+    }
+
+    KisTiledDataManager *dm = layer->paintDevice()->dataManager().data();
+
+    QVector<KisTileSP> tiles;
+    const QRect extent = dm->extent();
+    const int firstColumn = KisAlgebra2D::divideFloor(extent.left(), KisTileData::WIDTH);
+    const int firstRow = KisAlgebra2D::divideFloor(extent.top(), KisTileData::HEIGHT);
+    const int lastColumn = KisAlgebra2D::divideFloor(extent.right(), KisTileData::WIDTH);
+    const int lastRow = KisAlgebra2D::divideFloor(extent.bottom(), KisTileData::HEIGHT);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            tiles << dm->getTile(column, row, false);
+        }
+    }
+
+    QList<KisTileCompressor2::Codec> codecs;
+    codecs << KisTileCompressor2::LZF
+           << KisTileCompressor2::LZ4
+           << KisTileCompressor2::ZSTD;
+
+    const int numPasses = 10;
+
+    Q_FOREACH (KisTileCompressor2::Codec codec, codecs) {
+        if (!KisTileCompressor2::isCodecSupported(codec)) {
+            qDebug() << KisTileCompressor2::codecToString(codec) << "is not supported, skipping";
+            continue;
+        }
+
+        KisTileCompressor2 compressor(codec, 1);
+
+        QVector<QByteArray> buffers(tiles.size());
+        qint64 rawBytes = 0;
+        qint64 compressedBytes = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int pass = 0; pass < numPasses; pass++) {
+            for (int i = 0; i < tiles.size(); i++) {
+                KisTileData *td = tiles[i]->tileData();
+                tiles[i]->lockForRead();
+
+                buffers[i].resize(compressor.tileDataBufferSize(td));
+                qint32 bytesWritten = 0;
+                compressor.compressTileData(td, (quint8*)buffers[i].data(), buffers[i].size(), bytesWritten);
+                buffers[i].resize(bytesWritten);
+
+                tiles[i]->unlockForRead();
+
+                rawBytes += td->pixelSize() * KisTileData::WIDTH * KisTileData::HEIGHT;
+                compressedBytes += bytesWritten;
+            }
+        }
+
+        const qint64 compressionTime = timer.restart();
+
+        KisTileSP scratchTile = dm->getTile(extent.right() / KisTileData::WIDTH + 2, 0, true);
+        scratchTile->lockForWrite();
+
+        for (int pass = 0; pass < numPasses; pass++) {
+            for (int i = 0; i < tiles.size(); i++) {
+                compressor.decompressTileData((quint8*)buffers[i].data(), buffers[i].size(), scratchTile->tileData());
+            }
+        }
+
+        scratchTile->unlockForWrite();
+
+        const qint64 decompressionTime = timer.elapsed();
+
+        const qreal rawMiB = qreal(rawBytes) / (1 << 20);
+
+        qDebug().nospace()
+            << KisTileCompressor2::codecToString(codec)
+            << ": ratio " << qreal(compressedBytes) / rawBytes
+            << ", compression " << rawMiB / qMax(qint64(1), compressionTime) * 1000 << " MiB/s"
+            << ", decompression " << rawMiB / qMax(qint64(1), decompressionTime) * 1000 << " MiB/s";
+    }
+}
+
+/**
+ * Swaps a set of tiles out and in through KisSwappedDataStore
+ * several times and measures the time spent in the swap space
+ * backend (the compression codec is the same for both runs).
+ */
+void KisLowMemoryBenchmark::benchmarkSwapSpace(bool useMappedSwapFile)
+{
+    const qint32 pixelSize = 4;
+    const quint8 defaultPixel[4] = {0, 0, 0, 0};
+    const int numTiles = 20000;
+    const int numCycles = 5;
+
+    KisImageConfig config(false);
+    const bool oldUseMappedSwapFile = config.useMappedSwapFile();
+    config.setUseMappedSwapFile(useMappedSwapFile);
+
+    {
+        KisSwappedDataStore store;
+
+        QVector<KisTileData*> tileDataList;
+        for (int i = 0; i < numTiles; i++) {
+            KisTileData *td = new KisTileData(pixelSize, defaultPixel, KisTileDataStore::instance());
+
+            // a gradient-like pattern, so that the tiles are compressible
+            quint8 *ptr = td->data();
+            for (int j = 0; j < KisTileData::WIDTH * KisTileData::HEIGHT * pixelSize; j++) {
+                ptr[j] = quint8((i + j / (pixelSize * 16)) & 0xFF);
+            }
+
+            tileDataList << td;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int cycle = 0; cycle < numCycles; cycle++) {
+            Q_FOREACH (KisTileData *td, tileDataList) {
+                store.trySwapOutTileData(td);
+            }
+
+            Q_FOREACH (KisTileData *td, tileDataList) {
+                store.swapInTileData(td);
+            }
+        }
+
+        const qint64 elapsed = timer.elapsed();
+        const qreal totalMiB = qreal(numCycles) * numTiles *
+            KisTileData::WIDTH * KisTileData::HEIGHT * pixelSize / (1 << 20);
+
+        qDebug().nospace()
+            << (useMappedSwapFile ? "mapped swap file" : "memory window")
+            << ": " << elapsed << " ms, "
+            << totalMiB / qMax(qint64(1), elapsed) * 1000 << " MiB/s";
+
+        qDeleteAll(tileDataList);
+    }
+
+    config.setUseMappedSwapFile(oldUseMappedSwapFile);
+}
+
+void KisLowMemoryBenchmark::benchmarkSwapSpaceBackends()
+{
+    benchmarkSwapSpace(false);
+
+    if (KisMappedSwapFile::isSupported()) {
+        benchmarkSwapSpace(true);
+    }
+}
+
 SIMPLE_TEST_MAIN(KisLowMemoryBenchmark)
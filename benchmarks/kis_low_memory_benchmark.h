@@ -19,7 +19,12 @@ private Q_SLOTS:
 
     void memory2000History100Pool500HugeBrush();
 
+    void benchmarkSwapCompressionCodecs();
+    void benchmarkSwapSpaceBackends();
+
 private:
+    void benchmarkSwapSpace(bool useMappedSwapFile);
+
     void benchmarkWideArea(const QString presetFileName,
                            const QRectF &rect, qreal vstep,
                            int numCycles,
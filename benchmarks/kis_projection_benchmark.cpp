@@ -16,6 +16,11 @@
 #include <kis_image.h>
 #include <KisPart.h>
 
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <KisWorkStealingExecutor.h>
+#include <job_burst_testing_utils.h>
+
 void KisProjectionBenchmark::initTestCase()
 {
 
@@ -46,5 +51,37 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+template <class Executor>
+void runJobBursts(Executor *executor)
+{
+    const int numBursts = 2000;
+    const int numChildren = 2 * QThread::idealThreadCount();
+
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        counter = 0;
+
+        for (int i = 0; i < numBursts; i++) {
+            executor->start(new TestUtil::BurstRunnable<Executor>(executor, counter, numChildren, 2000));
+            executor->waitForDone();
+        }
+    }
+
+    QCOMPARE(counter.loadAcquire(), numBursts * (numChildren + 1));
+}
+
+void KisProjectionBenchmark::benchmarkJobBurstsQThreadPool()
+{
+    QThreadPool pool;
+    runJobBursts(&pool);
+}
+
+void KisProjectionBenchmark::benchmarkJobBurstsWorkStealing()
+{
+    KisWorkStealingExecutor executor;
+    runJobBursts(&executor);
+}
+
 
 SIMPLE_TEST_MAIN(KisProjectionBenchmark)
@@ -20,6 +20,9 @@ private Q_SLOTS:
 
     void benchmarkProjection();
     void benchmarkLoading();
+
+    void benchmarkJobBurstsQThreadPool();
+    void benchmarkJobBurstsWorkStealing();
 };
 
 #endif
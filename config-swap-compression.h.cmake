@@ -0,0 +1,7 @@
+/* config-swap-compression.h.  Generated by cmake from config-swap-compression.h.cmake */
+
+/* Define if you have LZ4, the fast compression library */
+#cmakedefine HAVE_LZ4 1
+
+/* Define if you have Zstandard, the compression library by Facebook */
+#cmakedefine HAVE_ZSTD 1
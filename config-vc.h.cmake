@@ -2,3 +2,6 @@
 
 /* Define if you have Vc, the vectorization library */
 #cmakedefine HAVE_VC 1
+
+/* Define if the compiler can build the AVX-512 kernels */
+#cmakedefine HAVE_AVX512_KERNELS 1
@@ -0,0 +1,252 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAdaptiveThreadCountController.h"
+
+#include <QMutexLocker>
+
+#include "kis_assert.h"
+
+namespace {
+
+/**
+ * A window is processed when it lasts at least MIN_WINDOW_TIME and
+ * has at least MIN_WINDOW_JOBS jobs. When the jobs are long (e.g.
+ * filters), the window is processed after LONG_WINDOW_TIME when there
+ * is at least one job per active thread.
+ */
+const int MIN_WINDOW_JOBS = 32;
+const qint64 MIN_WINDOW_TIME = 50000000; // 50 ms
+const qint64 LONG_WINDOW_TIME = 500000000; // 500 ms
+
+/**
+ * If no job has been finished for that long, the scheduler is
+ * considered idle
+ */
+const qint64 IDLE_TIME = 1000000000; // 1 s
+
+/**
+ * The share of the time the active threads should be busy to
+ * consider probing a different number of threads
+ */
+const qreal SATURATION_THRESHOLD = 0.75;
+
+/**
+ * Removing threads should improve the estimated throughput at least
+ * that much, otherwise the threads are returned
+ */
+const qreal SHRINK_GAIN_THRESHOLD = 0.1;
+
+/**
+ * A job type takes part in the comparison of two windows only if it
+ * has that many jobs in both of them
+ */
+const int MIN_TYPE_JOBS = 8;
+
+const int COOLDOWN_WINDOWS = 20;
+
+}
+
+int KisAdaptiveThreadCountController::minThreads() const
+{
+    return qMax(1, (m_maxThreads + 1) / 2);
+}
+
+void KisAdaptiveThreadCountController::resetStatistics()
+{
+    m_activeThreads.storeRelease(m_maxThreads);
+    m_isProbing = false;
+    m_probeRemovesThreads = true;
+    m_baselineThreads = 0;
+    m_cooldownWindows = 0;
+    m_hasWindow = false;
+}
+
+KisAdaptiveThreadCountController::KisAdaptiveThreadCountController(int maxThreads)
+{
+    setMaxThreads(maxThreads);
+}
+
+void KisAdaptiveThreadCountController::setMaxThreads(int value)
+{
+    KIS_SAFE_ASSERT_RECOVER(value > 0) { value = 1; }
+
+    QMutexLocker l(&m_lock);
+
+    m_maxThreads = value;
+    resetStatistics();
+}
+
+int KisAdaptiveThreadCountController::maxThreads() const
+{
+    QMutexLocker l(&m_lock);
+    return m_maxThreads;
+}
+
+void KisAdaptiveThreadCountController::setEnabled(bool value)
+{
+    QMutexLocker l(&m_lock);
+
+    if (m_enabled == value) return;
+
+    m_enabled = value;
+    resetStatistics();
+}
+
+bool KisAdaptiveThreadCountController::isEnabled() const
+{
+    QMutexLocker l(&m_lock);
+    return m_enabled;
+}
+
+void KisAdaptiveThreadCountController::setPendingJobs(int value)
+{
+    m_pendingJobs.storeRelease(value);
+}
+
+void KisAdaptiveThreadCountController::reportJobFinished(JobType type, qint64 duration, qint64 workAmount, qint64 timestamp)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(type >= 0 && type < NJobTypes);
+
+    QMutexLocker l(&m_lock);
+
+    if (!m_enabled) return;
+
+    if (m_hasWindow && timestamp - duration - m_lastJobFinished > IDLE_TIME) {
+        /**
+         * The scheduler has been idle for a while, the next burst
+         * of jobs may be of a totally different kind, so return
+         * all the threads and start measuring from the beginning
+         */
+        resetStatistics();
+    }
+
+    if (!m_hasWindow) {
+        resetWindow(timestamp - duration);
+    }
+
+    TypeStatistics &typeStats = m_window.types[type];
+    typeStats.jobs++;
+    typeStats.duration += duration;
+    typeStats.workAmount += qMax(qint64(1), workAmount);
+
+    m_windowJobs++;
+    m_windowBusyTime += duration;
+    m_windowPendingJobs += m_pendingJobs.loadAcquire();
+    m_lastJobFinished = qMax(m_lastJobFinished, timestamp);
+
+    const qint64 windowTime = timestamp - m_windowStart;
+
+    if (windowTime >= MIN_WINDOW_TIME &&
+        (m_windowJobs >= MIN_WINDOW_JOBS ||
+         (windowTime >= LONG_WINDOW_TIME && m_windowJobs >= m_activeThreads.loadAcquire()))) {
+
+        processWindow(timestamp);
+        resetWindow(timestamp);
+    }
+}
+
+void KisAdaptiveThreadCountController::resetWindow(qint64 timestamp)
+{
+    m_hasWindow = true;
+    m_windowStart = timestamp;
+    m_windowJobs = 0;
+    m_windowBusyTime = 0;
+    m_windowPendingJobs = 0;
+    m_window = WindowStatistics();
+}
+
+qreal KisAdaptiveThreadCountController::estimateSpeedup(int probeThreads) const
+{
+    qreal weightedCostRatio = 0.0;
+    int weight = 0;
+
+    for (int i = 0; i < NJobTypes; i++) {
+        const TypeStatistics &base = m_baseline.types[i];
+        const TypeStatistics &probe = m_window.types[i];
+
+        if (base.jobs < MIN_TYPE_JOBS || probe.jobs < MIN_TYPE_JOBS || !base.duration) continue;
+
+        const qreal baseCost = qreal(base.duration) / base.workAmount;
+        const qreal probeCost = qreal(probe.duration) / probe.workAmount;
+
+        weightedCostRatio += probe.jobs * probeCost / baseCost;
+        weight += probe.jobs;
+    }
+
+    if (!weight) return -1.0;
+
+    /**
+     * The throughput is proportional to the number of threads and
+     * inversely proportional to the cost of a unit of work
+     */
+    const qreal costRatio = weightedCostRatio / weight;
+    return costRatio > 0.0 ? qreal(probeThreads) / m_baselineThreads / costRatio : -1.0;
+}
+
+void KisAdaptiveThreadCountController::startProbe(int activeThreads)
+{
+    if (activeThreads >= m_maxThreads) {
+        m_probeRemovesThreads = true;
+    } else if (activeThreads <= minThreads()) {
+        m_probeRemovesThreads = false;
+    }
+
+    const int step = qMax(1, activeThreads / 4);
+    const int probeThreads = m_probeRemovesThreads ?
+        qMax(minThreads(), activeThreads - step) :
+        qMin(m_maxThreads, activeThreads + step);
+
+    if (probeThreads == activeThreads) return;
+
+    m_baseline = m_window;
+    m_baselineThreads = activeThreads;
+    m_isProbing = true;
+    m_activeThreads.storeRelease(probeThreads);
+}
+
+void KisAdaptiveThreadCountController::processWindow(qint64 timestamp)
+{
+    const int activeThreads = m_activeThreads.loadAcquire();
+
+    const qreal utilization = qreal(m_windowBusyTime) / ((timestamp - m_windowStart) * activeThreads);
+    const qreal averagePendingJobs = qreal(m_windowPendingJobs) / m_windowJobs;
+
+    /**
+     * The number of threads doesn't matter if there is no backlog
+     */
+    const bool isSaturated =
+        averagePendingJobs >= 1.0 &&
+        utilization > SATURATION_THRESHOLD;
+
+    if (m_isProbing) {
+        m_isProbing = false;
+
+        const qreal speedup = isSaturated ? estimateSpeedup(activeThreads) : -1.0;
+        const bool keepProbe =
+            speedup > 0.0 &&
+            (activeThreads < m_baselineThreads ?
+             speedup > 1.0 + SHRINK_GAIN_THRESHOLD :
+             speedup >= 1.0);
+
+        if (!keepProbe) {
+            m_activeThreads.storeRelease(m_baselineThreads);
+            m_probeRemovesThreads = !m_probeRemovesThreads;
+            m_cooldownWindows = COOLDOWN_WINDOWS;
+        }
+
+        return;
+    }
+
+    if (m_cooldownWindows > 0) {
+        m_cooldownWindows--;
+        return;
+    }
+
+    if (isSaturated) {
+        startProbe(activeThreads);
+    }
+}
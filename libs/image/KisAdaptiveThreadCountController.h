@@ -0,0 +1,133 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ADAPTIVE_THREAD_COUNT_CONTROLLER_H
+#define __KIS_ADAPTIVE_THREAD_COUNT_CONTROLLER_H
+
+#include <QAtomicInt>
+#include <QMutex>
+
+#include "kritaimage_export.h"
+
+/**
+ * Decides how many worker threads of KisUpdaterContext may run jobs
+ * at the same time. The number of threads in the executor (the
+ * ceiling) is still defined by the user preference, the controller
+ * only limits the number of the threads that are used.
+ *
+ * The controller starts with all the threads active and only removes
+ * them when it has evidence that fewer threads finish the work faster,
+ * e.g. when the threads compete with each other (or with the other
+ * processes) for the cores and memory bandwidth, or are moved to the
+ * efficiency cores of a hybrid CPU.
+ *
+ * The statistics are collected in windows of several finished jobs.
+ * When the queues have a backlog and the active threads are busy, the
+ * controller probes a different number of threads: the current window
+ * becomes the baseline and the next window is run with the probed
+ * number of threads. The probe is kept only if the estimated
+ * throughput has improved (when removing threads) or has not degraded
+ * (when returning them). Otherwise the previous number of threads is
+ * restored and the controller doesn't probe for a few windows.
+ *
+ * To compare like with like, the cost of the jobs is measured per
+ * job type, and merge jobs are normalized by the area they process.
+ * Only the types present in both windows take part in the comparison.
+ *
+ * The number of active threads never drops below half of the ceiling.
+ * After a period of inactivity all the threads become active again.
+ *
+ * All the methods are thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisAdaptiveThreadCountController
+{
+public:
+    enum JobType {
+        MergeJob = 0,
+        StrokeJob,
+        SpontaneousJob,
+        NJobTypes
+    };
+
+public:
+    KisAdaptiveThreadCountController(int maxThreads = 1);
+
+    /**
+     * Sets the ceiling of the active threads. The statistics
+     * are reset.
+     */
+    void setMaxThreads(int value);
+    int maxThreads() const;
+
+    /**
+     * When disabled, all the threads are active
+     */
+    void setEnabled(bool value);
+    bool isEnabled() const;
+
+    /**
+     * The number of threads that may run jobs at the moment
+     */
+    inline int activeThreads() const {
+        return m_activeThreads.loadAcquire();
+    }
+
+    /**
+     * Reports the current size of the queues of the scheduler
+     */
+    void setPendingJobs(int value);
+
+    /**
+     * Reports a job of \p type that has been finished at \p timestamp
+     * and took \p duration. Both values are in nanoseconds. \p workAmount
+     * is the size of the job in arbitrary units (e.g. the number of
+     * pixels of a merge job), only the jobs of the same type are
+     * compared with each other.
+     */
+    void reportJobFinished(JobType type, qint64 duration, qint64 workAmount, qint64 timestamp);
+
+private:
+    struct TypeStatistics {
+        int jobs = 0;
+        qint64 duration = 0;
+        qint64 workAmount = 0;
+    };
+
+    struct WindowStatistics {
+        TypeStatistics types[NJobTypes];
+    };
+
+    int minThreads() const;
+    void resetStatistics();
+    void resetWindow(qint64 timestamp);
+    void processWindow(qint64 timestamp);
+    void startProbe(int activeThreads);
+    qreal estimateSpeedup(int probeThreads) const;
+
+private:
+    QAtomicInt m_activeThreads;
+    QAtomicInt m_pendingJobs;
+
+    mutable QMutex m_lock;
+    int m_maxThreads = 1;
+    bool m_enabled = false;
+
+    bool m_hasWindow = false;
+    qint64 m_windowStart = 0;
+    int m_windowJobs = 0;
+    qint64 m_windowBusyTime = 0;
+    qint64 m_windowPendingJobs = 0;
+    WindowStatistics m_window;
+    qint64 m_lastJobFinished = 0;
+
+    bool m_isProbing = false;
+    bool m_probeRemovesThreads = true;
+    int m_baselineThreads = 0;
+    WindowStatistics m_baseline;
+    int m_cooldownWindows = 0;
+};
+
+#endif /* __KIS_ADAPTIVE_THREAD_COUNT_CONTROLLER_H */
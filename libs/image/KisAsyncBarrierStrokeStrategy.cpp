@@ -0,0 +1,55 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAsyncBarrierStrokeStrategy.h"
+
+#include "kis_assert.h"
+
+KisAsyncBarrierStrokeStrategy::KisAsyncBarrierStrokeStrategy(std::function<void()> exclusiveFunc,
+                                                             std::function<void()> guiFunc,
+                                                             QObject *guiContext)
+    : KisSimpleStrokeStrategy(QLatin1String("async_barrier_stroke")),
+      m_exclusiveFunc(exclusiveFunc)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_exclusiveFunc);
+
+    enableJob(JOB_INIT, true, KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
+    enableJob(JOB_FINISH, true, KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
+
+    setClearsRedoOnStart(false);
+
+    /**
+     * Like barrierLock(), the barrier waits for the user's stroke
+     * instead of forcing it to end
+     */
+    setRequestsOtherStrokesToEnd(false);
+
+    /**
+     * The queued connection keeps a copy of the functor in the posted
+     * event, so the callback is delivered even when the stroke has
+     * already been deleted by that moment
+     */
+    if (guiFunc && guiContext) {
+        connect(this, &KisAsyncBarrierStrokeStrategy::sigExclusiveFuncCompleted,
+                guiContext, guiFunc, Qt::QueuedConnection);
+    }
+}
+
+KisAsyncBarrierStrokeStrategy::~KisAsyncBarrierStrokeStrategy()
+{
+}
+
+void KisAsyncBarrierStrokeStrategy::initStrokeCallback()
+{
+    if (m_exclusiveFunc) {
+        m_exclusiveFunc();
+    }
+}
+
+void KisAsyncBarrierStrokeStrategy::finishStrokeCallback()
+{
+    emit sigExclusiveFuncCompleted();
+}
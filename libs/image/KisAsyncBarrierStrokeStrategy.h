@@ -0,0 +1,55 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ASYNC_BARRIER_STROKE_STRATEGY_H
+#define __KIS_ASYNC_BARRIER_STROKE_STRATEGY_H
+
+#include <QObject>
+#include <functional>
+
+#include "kis_simple_stroke_strategy.h"
+#include "kritaimage_export.h"
+
+/**
+ * An asynchronous replacement for KisImage::barrierLock(). The stroke
+ * has a single BARRIER and EXCLUSIVE job that executes \p exclusiveFunc,
+ * that is, the function is called when all the strokes started before
+ * are completed, the updates queue is empty and no other job is running.
+ * Therefore the function can access the image in the same way as it
+ * would do under barrierLock(), but the calling thread doesn't need to
+ * wait for it.
+ *
+ * When the function is completed, \p guiFunc is called in the thread
+ * of \p guiContext (usually the GUI thread), unless the context has
+ * been deleted meanwhile. The GUI callback is not called if the stroke
+ * is cancelled, e.g. when the image is closed.
+ *
+ * The stroke doesn't add anything to the undo stack and doesn't clear
+ * the redo part of it. It doesn't ask the stroke in progress to end,
+ * it just waits for it.
+ *
+ * \see KisImage::runBarrierAsync()
+ */
+class KRITAIMAGE_EXPORT KisAsyncBarrierStrokeStrategy : public QObject, public KisSimpleStrokeStrategy
+{
+    Q_OBJECT
+public:
+    KisAsyncBarrierStrokeStrategy(std::function<void()> exclusiveFunc,
+                                  std::function<void()> guiFunc = std::function<void()>(),
+                                  QObject *guiContext = 0);
+    ~KisAsyncBarrierStrokeStrategy() override;
+
+    void initStrokeCallback() override;
+    void finishStrokeCallback() override;
+
+Q_SIGNALS:
+    void sigExclusiveFuncCompleted();
+
+private:
+    std::function<void()> m_exclusiveFunc;
+};
+
+#endif /* __KIS_ASYNC_BARRIER_STROKE_STRATEGY_H */
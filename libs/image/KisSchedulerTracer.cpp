@@ -0,0 +1,286 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSchedulerTracer.h"
+
+#include <QAtomicPointer>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+
+#include "kis_debug.h"
+
+Q_GLOBAL_STATIC(KisSchedulerTracer, s_instance)
+
+namespace {
+
+/**
+ * The number of events kept in the ring buffer. It should be
+ * enough for a few seconds of heavy painting.
+ */
+const int BUFFER_SIZE = 1 << 16;
+
+/**
+ * The payload of the event. It is plain data (the name is stored in
+ * a fixed-size buffer), so that the reader can copy it while a writer
+ * is reusing the slot, and then discard the torn copy
+ */
+struct EventData
+{
+    KisSchedulerTracer::Category category;
+    char phase;
+    char name[64];
+    QRect rect;
+    qint64 start;
+    qint64 duration;
+    quintptr threadId;
+};
+
+struct Event
+{
+    /**
+     * The sequence number of the event plus one. It is reset to zero
+     * before the data is written and set again afterwards, so the
+     * slot works as a seqlock: the reader checks the ticket before and
+     * after copying the data and drops the copy if it has changed.
+     */
+    QAtomicInt ticket;
+    EventData data;
+};
+
+const char* categoryName(KisSchedulerTracer::Category category)
+{
+    switch (category) {
+    case KisSchedulerTracer::StrokeJob:
+        return "stroke";
+    case KisSchedulerTracer::MergeJob:
+        return "merge";
+    case KisSchedulerTracer::SpontaneousJob:
+        return "spontaneous";
+    case KisSchedulerTracer::LodSync:
+        return "lod";
+    case KisSchedulerTracer::BarrierLock:
+        return "barrier";
+    case KisSchedulerTracer::Swapper:
+        return "swapper";
+    }
+
+    return "unknown";
+}
+
+}
+
+struct KisSchedulerTracer::Private
+{
+    ~Private() {
+        delete[] events.loadAcquire();
+    }
+
+    QElapsedTimer timer;
+
+    /**
+     * The ring buffer takes several megabytes, so it is allocated only
+     * when the tracing is enabled for the first time. It is never freed
+     * before the tracer itself, the writers that have passed the check
+     * of isEnabled() may still be using it after the tracing is stopped.
+     */
+    QAtomicPointer<Event> events;
+    QMutex allocationLock;
+    QAtomicInt nextEvent;
+
+    QString exitTraceFileName;
+
+    void allocateEvents() {
+        QMutexLocker l(&allocationLock);
+        if (!events.loadAcquire()) {
+            events.storeRelease(new Event[BUFFER_SIZE]);
+        }
+    }
+
+    void addEvent(Category category, char phase, const QString &name,
+                  qint64 start, qint64 duration, const QRect &rect) {
+
+        Event *buffer = events.loadAcquire();
+        if (!buffer) return;
+
+        const int index = nextEvent.fetchAndAddOrdered(1);
+        Event &event = buffer[index & (BUFFER_SIZE - 1)];
+
+        // the full barrier keeps the data writes after the reset of the ticket
+        event.ticket.fetchAndStoreOrdered(0);
+
+        EventData &data = event.data;
+        data.category = category;
+        data.phase = phase;
+        qstrncpy(data.name, name.toUtf8().constData(), sizeof(data.name));
+        data.rect = rect;
+        data.start = start;
+        data.duration = duration;
+        data.threadId = quintptr(QThread::currentThreadId());
+
+        event.ticket.storeRelease(index + 1);
+    }
+
+    bool readEvent(int index, EventData *data) const {
+        const Event *buffer = events.loadAcquire();
+        if (!buffer) return false;
+
+        const Event &event = buffer[index & (BUFFER_SIZE - 1)];
+
+        // the slot is either empty, or being written or reused
+        if (event.ticket.loadAcquire() != index + 1) return false;
+
+        *data = event.data;
+
+        // the copy must be completed before the ticket is checked again
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return event.ticket.load() == index + 1;
+    }
+};
+
+KisSchedulerTracer::KisSchedulerTracer()
+    : m_d(new Private)
+{
+    m_d->timer.start();
+
+    m_d->exitTraceFileName = QString::fromLocal8Bit(qgetenv("KRITA_SCHEDULER_TRACE"));
+
+    if (!m_d->exitTraceFileName.isEmpty()) {
+        setEnabled(true);
+
+        /**
+         * The trace is written when the event loop quits, while the
+         * application (and the file system) is still fully alive. Writing
+         * it from the destructor of the global static is not an option,
+         * the order of destruction of the statics is undefined.
+         */
+        if (QCoreApplication::instance()) {
+            QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                             [this] () {
+                                 setEnabled(false);
+                                 exportChromeTrace(m_d->exitTraceFileName);
+                             });
+        } else {
+            warnKrita << "KisSchedulerTracer: no application object, the trace will not be written into" << m_d->exitTraceFileName;
+        }
+    }
+}
+
+KisSchedulerTracer::~KisSchedulerTracer()
+{
+}
+
+KisSchedulerTracer* KisSchedulerTracer::instance()
+{
+    return s_instance;
+}
+
+void KisSchedulerTracer::setEnabled(bool value)
+{
+    if (value) {
+        m_d->allocateEvents();
+    }
+
+    m_enabled.storeRelease(value);
+}
+
+qint64 KisSchedulerTracer::timestamp() const
+{
+    return m_d->timer.nsecsElapsed() / 1000;
+}
+
+void KisSchedulerTracer::addEvent(Category category, const QString &name, qint64 start, const QRect &rect)
+{
+    if (!isEnabled()) return;
+    m_d->addEvent(category, 'X', name, start, timestamp() - start, rect);
+}
+
+void KisSchedulerTracer::addInstantEvent(Category category, const QString &name, const QRect &rect)
+{
+    if (!isEnabled()) return;
+    m_d->addEvent(category, 'i', name, timestamp(), 0, rect);
+}
+
+void KisSchedulerTracer::clear()
+{
+    Event *buffer = m_d->events.loadAcquire();
+    if (!buffer) return;
+
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        buffer[i].ticket.storeRelease(0);
+    }
+}
+
+bool KisSchedulerTracer::exportChromeTrace(const QString &fileName) const
+{
+    const int lastEvent = m_d->nextEvent.loadAcquire();
+    const int firstEvent = std::max(0, lastEvent - BUFFER_SIZE);
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QHash<quintptr, int> threadIds;
+    QJsonArray traceEvents;
+
+    for (int index = firstEvent; index < lastEvent; index++) {
+        EventData event;
+        if (!m_d->readEvent(index, &event)) continue;
+
+        auto it = threadIds.find(event.threadId);
+        if (it == threadIds.end()) {
+            it = threadIds.insert(event.threadId, threadIds.size() + 1);
+        }
+
+        QJsonObject object;
+        object["name"] = QString::fromUtf8(event.name);
+        object["cat"] = QLatin1String(categoryName(event.category));
+        object["ph"] = QString(QLatin1Char(event.phase));
+        object["ts"] = event.start;
+        object["pid"] = pid;
+        object["tid"] = it.value();
+
+        if (event.phase == 'X') {
+            object["dur"] = event.duration;
+        } else {
+            object["s"] = QLatin1String("t");
+        }
+
+        if (event.rect.isValid()) {
+            QJsonObject args;
+            args["x"] = event.rect.x();
+            args["y"] = event.rect.y();
+            args["width"] = event.rect.width();
+            args["height"] = event.rect.height();
+            object["args"] = args;
+        }
+
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = QLatin1String("ms");
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        warnKrita << "KisSchedulerTracer: failed to open" << fileName << "for writing";
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
@@ -0,0 +1,160 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_SCHEDULER_TRACER_H
+#define __KIS_SCHEDULER_TRACER_H
+
+#include <QAtomicInt>
+#include <QRect>
+#include <QScopedPointer>
+#include <QString>
+
+#include "kritaimage_export.h"
+
+/**
+ * A lightweight recorder of the scheduler activity. When enabled, the
+ * events (stroke jobs, merge walkers, LoD synchronization, barrier
+ * locks, swapper passes) are written into a fixed-size ring buffer,
+ * so only the latest events are kept. The buffer can be exported in
+ * Chrome trace event format and opened in chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ * When disabled, recording an event costs a single atomic load.
+ *
+ * The tracing can be started by setting KRITA_SCHEDULER_TRACE
+ * environment variable to a file name. The trace is written into
+ * this file when the application is about to quit.
+ */
+class KRITAIMAGE_EXPORT KisSchedulerTracer
+{
+public:
+    enum Category {
+        StrokeJob = 0,
+        MergeJob,
+        SpontaneousJob,
+        LodSync,
+        BarrierLock,
+        Swapper
+    };
+
+public:
+    KisSchedulerTracer();
+    ~KisSchedulerTracer();
+
+    static KisSchedulerTracer* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled.loadAcquire();
+    }
+
+    void setEnabled(bool value);
+
+    /**
+     * The time in microseconds since the tracer has been created
+     */
+    qint64 timestamp() const;
+
+    /**
+     * Records an event that started at \p start and lasted until now.
+     * \p rect is saved into the arguments of the event if it is valid.
+     */
+    void addEvent(Category category, const QString &name, qint64 start, const QRect &rect = QRect());
+
+    /**
+     * Records an event without duration
+     */
+    void addInstantEvent(Category category, const QString &name, const QRect &rect = QRect());
+
+    /**
+     * Drops all the recorded events
+     */
+    void clear();
+
+    /**
+     * Writes the recorded events into \p fileName in Chrome trace
+     * JSON format. Returns false if the file cannot be written.
+     *
+     * It is safe to export while the events are still being recorded:
+     * the slots that are written or reused while being read are
+     * skipped.
+     */
+    bool exportChromeTrace(const QString &fileName) const;
+
+    /**
+     * Records an event for the lifetime of the object
+     */
+    class Scope
+    {
+    public:
+        Scope(Category category, const QString &name, const QRect &rect = QRect())
+            : m_tracer(KisSchedulerTracer::instance())
+        {
+            if (m_tracer->isEnabled()) {
+                m_category = category;
+                m_name = name;
+                m_rect = rect;
+                m_start = m_tracer->timestamp();
+            }
+        }
+
+        Scope(Category category, const char *name, const QRect &rect = QRect())
+            : m_tracer(KisSchedulerTracer::instance())
+        {
+            if (m_tracer->isEnabled()) {
+                m_category = category;
+                m_name = QLatin1String(name);
+                m_rect = rect;
+                m_start = m_tracer->timestamp();
+            }
+        }
+
+        /**
+         * Starts an event without a name. Use it when the name is
+         * expensive to build: check isActive() and only then call
+         * setName().
+         */
+        Scope(Category category, const QRect &rect = QRect())
+            : m_tracer(KisSchedulerTracer::instance())
+        {
+            if (m_tracer->isEnabled()) {
+                m_category = category;
+                m_rect = rect;
+                m_start = m_tracer->timestamp();
+            }
+        }
+
+        inline bool isActive() const {
+            return m_start >= 0;
+        }
+
+        void setName(const QString &name) {
+            m_name = name;
+        }
+
+        ~Scope() {
+            if (m_start >= 0 && m_tracer->isEnabled()) {
+                m_tracer->addEvent(m_category, m_name, m_start, m_rect);
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        KisSchedulerTracer *m_tracer;
+        Category m_category = StrokeJob;
+        QString m_name;
+        QRect m_rect;
+        qint64 m_start = -1;
+    };
+
+private:
+    QAtomicInt m_enabled;
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_SCHEDULER_TRACER_H */
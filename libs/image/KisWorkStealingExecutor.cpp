@@ -0,0 +1,283 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisWorkStealingExecutor.h"
+
+#include <deque>
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "kis_assert.h"
+
+
+struct KisWorkStealingExecutor::Private
+{
+    struct Worker;
+
+    QVector<Worker*> workers;
+
+    /**
+     * The number of workers whose threads have already been started.
+     * The workers are started in order, so the first numStartedWorkers
+     * items of \p workers are running.
+     */
+    QAtomicInt numStartedWorkers;
+    QMutex startWorkerLock;
+
+    QAtomicInt nextQueue;
+
+    /**
+     * The runnables sitting in the queues of the workers
+     */
+    QAtomicInt numQueuedJobs;
+
+    /**
+     * The runnables either queued or currently running
+     */
+    QAtomicInt numPendingJobs;
+
+    QMutex sleepLock;
+    QWaitCondition wakeCondition;
+    QAtomicInt numSleepingWorkers;
+    bool shouldExit = false;
+
+    QMutex doneLock;
+    QWaitCondition doneCondition;
+
+    Worker* currentWorker() const;
+    void tryStartNextWorker();
+    QRunnable* fetchJob(Worker *worker);
+    void runJob(QRunnable *runnable);
+
+    void createWorkers(int numWorkers);
+    void destroyWorkers();
+};
+
+struct KisWorkStealingExecutor::Private::Worker : public QThread
+{
+    Worker(Private *_d, int _index)
+        : d(_d), index(_index)
+    {
+    }
+
+    void run() override;
+
+    inline void push(QRunnable *runnable) {
+        QMutexLocker l(&queueLock);
+        queue.push_back(runnable);
+    }
+
+    /**
+     * The owner takes the newest job, its data is most probably
+     * still in the cache
+     */
+    inline QRunnable* pop() {
+        QMutexLocker l(&queueLock);
+        if (queue.empty()) return 0;
+
+        QRunnable *runnable = queue.back();
+        queue.pop_back();
+        return runnable;
+    }
+
+    /**
+     * The thieves take the oldest job, so that they don't compete
+     * with the owner for the same end of the queue
+     */
+    inline QRunnable* steal() {
+        QMutexLocker l(&queueLock);
+        if (queue.empty()) return 0;
+
+        QRunnable *runnable = queue.front();
+        queue.pop_front();
+        return runnable;
+    }
+
+    Private *d;
+    const int index;
+
+    QMutex queueLock;
+    std::deque<QRunnable*> queue;
+};
+
+void KisWorkStealingExecutor::Private::Worker::run()
+{
+    while (1) {
+        QRunnable *runnable = d->fetchJob(this);
+
+        if (runnable) {
+            d->runJob(runnable);
+            continue;
+        }
+
+        QMutexLocker l(&d->sleepLock);
+        if (d->shouldExit) break;
+
+        /**
+         * The producer first increments numQueuedJobs and then checks
+         * numSleepingWorkers, and we do it in the opposite order, so
+         * at least one of us will notice the other one. The producer
+         * needs sleepLock for waking us up, so the wakeup cannot
+         * happen before we start waiting.
+         */
+        d->numSleepingWorkers.fetchAndAddOrdered(1);
+        if (!d->numQueuedJobs.fetchAndAddOrdered(0)) {
+            d->wakeCondition.wait(&d->sleepLock);
+        }
+        d->numSleepingWorkers.deref();
+    }
+}
+
+KisWorkStealingExecutor::Private::Worker* KisWorkStealingExecutor::Private::currentWorker() const
+{
+    Worker *worker = dynamic_cast<Worker*>(QThread::currentThread());
+    return worker && worker->d == this ? worker : 0;
+}
+
+void KisWorkStealingExecutor::Private::tryStartNextWorker()
+{
+    QMutexLocker l(&startWorkerLock);
+
+    const int index = numStartedWorkers.loadAcquire();
+    if (index < workers.size()) {
+        workers[index]->start();
+        numStartedWorkers.storeRelease(index + 1);
+    }
+}
+
+QRunnable* KisWorkStealingExecutor::Private::fetchJob(Worker *worker)
+{
+    QRunnable *runnable = worker->pop();
+
+    if (!runnable) {
+        const int numWorkers = workers.size();
+
+        for (int i = 1; i < numWorkers && !runnable; i++) {
+            runnable = workers[(worker->index + i) % numWorkers]->steal();
+        }
+    }
+
+    if (runnable) {
+        numQueuedJobs.deref();
+    }
+
+    return runnable;
+}
+
+void KisWorkStealingExecutor::Private::runJob(QRunnable *runnable)
+{
+    const bool autoDelete = runnable->autoDelete();
+    runnable->run();
+
+    if (autoDelete) {
+        delete runnable;
+    }
+
+    if (!numPendingJobs.deref()) {
+        QMutexLocker l(&doneLock);
+        doneCondition.wakeAll();
+    }
+}
+
+void KisWorkStealingExecutor::Private::createWorkers(int numWorkers)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(workers.isEmpty());
+
+    workers.resize(numWorkers);
+    for (int i = 0; i < numWorkers; i++) {
+        workers[i] = new Worker(this, i);
+    }
+
+    numStartedWorkers = 0;
+    shouldExit = false;
+}
+
+void KisWorkStealingExecutor::Private::destroyWorkers()
+{
+    {
+        QMutexLocker l(&sleepLock);
+        shouldExit = true;
+        wakeCondition.wakeAll();
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->wait();
+        KIS_SAFE_ASSERT_RECOVER_NOOP(worker->queue.empty());
+        delete worker;
+    }
+
+    workers.clear();
+    numStartedWorkers = 0;
+}
+
+
+KisWorkStealingExecutor::KisWorkStealingExecutor()
+    : m_d(new Private)
+{
+    const int threadCount = QThread::idealThreadCount();
+    m_d->createWorkers(threadCount > 0 ? threadCount : 1);
+}
+
+KisWorkStealingExecutor::~KisWorkStealingExecutor()
+{
+    waitForDone();
+    m_d->destroyWorkers();
+}
+
+void KisWorkStealingExecutor::start(QRunnable *runnable)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->workers.isEmpty());
+
+    m_d->numPendingJobs.ref();
+
+    Private::Worker *worker = m_d->currentWorker();
+
+    if (!worker) {
+        const int numWorkers = m_d->workers.size();
+        worker = m_d->workers[(m_d->nextQueue.fetchAndAddRelaxed(1) & 0x7fffffff) % numWorkers];
+    }
+
+    m_d->numQueuedJobs.fetchAndAddOrdered(1);
+    worker->push(runnable);
+
+    if (m_d->numSleepingWorkers.fetchAndAddOrdered(0) > 0) {
+        QMutexLocker l(&m_d->sleepLock);
+        m_d->wakeCondition.wakeOne();
+    } else if (m_d->numStartedWorkers.loadAcquire() < m_d->workers.size()) {
+        m_d->tryStartNextWorker();
+    }
+}
+
+void KisWorkStealingExecutor::waitForDone()
+{
+    QMutexLocker l(&m_d->doneLock);
+
+    while (m_d->numPendingJobs.loadAcquire() > 0) {
+        m_d->doneCondition.wait(&m_d->doneLock);
+    }
+}
+
+void KisWorkStealingExecutor::setMaxThreadCount(int value)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(value > 0);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!m_d->numPendingJobs.loadAcquire());
+
+    if (value == m_d->workers.size()) return;
+
+    waitForDone();
+    m_d->destroyWorkers();
+    m_d->createWorkers(value);
+}
+
+int KisWorkStealingExecutor::maxThreadCount() const
+{
+    return m_d->workers.size();
+}
@@ -0,0 +1,64 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_WORK_STEALING_EXECUTOR_H
+#define __KIS_WORK_STEALING_EXECUTOR_H
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+class QRunnable;
+
+/**
+ * A thread pool with a separate queue for every worker thread. It is
+ * used by KisUpdaterContext instead of QThreadPool.
+ *
+ * A runnable started from one of the worker threads (e.g. when a
+ * finishing update job item fetches the next burst of stroke jobs
+ * from the scheduler) is put into the queue of that very thread,
+ * so no global lock is involved. A worker takes the jobs from its
+ * own queue in LIFO order and, when the queue is empty, steals the
+ * oldest jobs from the queues of the other workers. The runnables
+ * started from the other threads are distributed over the queues
+ * in a round-robin manner.
+ *
+ * The worker threads are started lazily, when there is no sleeping
+ * worker to pick up a new job, and live until the executor is
+ * destroyed or the number of threads is changed.
+ */
+class KRITAIMAGE_EXPORT KisWorkStealingExecutor
+{
+public:
+    KisWorkStealingExecutor();
+    ~KisWorkStealingExecutor();
+
+    /**
+     * Queues \p runnable for execution. If QRunnable::autoDelete()
+     * is set, the runnable is deleted after completion.
+     */
+    void start(QRunnable *runnable);
+
+    /**
+     * Block execution of the caller until all the runnables
+     * are finished
+     */
+    void waitForDone();
+
+    /**
+     * Changes the maximum number of the worker threads.
+     * WARNING: there should be no runnables queued or running
+     *          while calling this method
+     */
+    void setMaxThreadCount(int value);
+    int maxThreadCount() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_WORK_STEALING_EXECUTOR_H */
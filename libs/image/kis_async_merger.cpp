@@ -203,12 +203,28 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
-void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
+bool KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones,
+                                const std::atomic<bool> *preemptionRequested) {
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
     const bool useTempProjections = walker.needRectVaries();
+    bool madeProgress = false;
 
     while(!leafStack.isEmpty()) {
+        /**
+         * We can stop only when no intermediate projection is being
+         * composed, otherwise the resumed merge would start from
+         * a half-baked group. At least one leaf is processed on every
+         * call to make sure the walker is finished some day.
+         */
+        if (preemptionRequested && madeProgress &&
+            !m_currentProjection && *preemptionRequested) {
+
+            walker.setMergeInterrupted(true);
+            return false;
+        }
+        madeProgress = true;
+
         KisMergeWalker::JobItem item = leafStack.pop();
         KisProjectionLeafSP currentLeaf = item.m_leaf;
 
@@ -217,11 +233,11 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
          * while the updates are still running. We have no proof
          * of it yet, so just add a safety assert here.
          */
-        KIS_SAFE_ASSERT_RECOVER_RETURN(currentLeaf);
-        KIS_SAFE_ASSERT_RECOVER_RETURN(currentLeaf->node());
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(currentLeaf, true);
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(currentLeaf->node(), true);
 
         // All the masks should be filtered by the walkers
-        KIS_SAFE_ASSERT_RECOVER_RETURN(currentLeaf->isLayer());
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(currentLeaf->isLayer(), true);
 
         QRect applyRect = item.m_applyRect;
 
@@ -303,6 +319,9 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
         // reset projection to avoid artifacts in next merges and allow people to work further
         resetProjection();
     }
+
+    walker.setMergeInterrupted(false);
+    return true;
 }
 
 void KisAsyncMerger::resetProjection() {
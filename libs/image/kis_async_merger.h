@@ -6,6 +6,8 @@
 #ifndef __KIS_ASYNC_MERGER_H
 #define __KIS_ASYNC_MERGER_H
 
+#include <atomic>
+
 #include "kritaimage_export.h"
 #include "kis_types.h"
 
@@ -15,7 +17,22 @@ class KisBaseRectsWalker;
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
 public:
-    void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
+    /**
+     * Executes the merge task collected by \p walker. The leaves are
+     * popped from the walker's stack while being processed.
+     *
+     * If \p preemptionRequested is passed, the merger checks it every
+     * time the intermediate projection of a group is written, that is
+     * when the rest of the task doesn't depend on any state of the
+     * merger. If preemption is requested at such a checkpoint, the
+     * merge is stopped and false is returned. The walker then keeps the
+     * unprocessed leaves and can be passed to startMerge() again later
+     * to finish the task.
+     *
+     * @return true if the merge has been completed
+     */
+    bool startMerge(KisBaseRectsWalker &walker, bool notifyClones = true,
+                    const std::atomic<bool> *preemptionRequested = 0);
 
 private:
     inline void resetProjection();
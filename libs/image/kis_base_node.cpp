@@ -232,6 +232,22 @@ void KisBaseNode::setVisible(bool visible, bool loading)
     m_d->properties.setProperty(KisLayerPropertiesIcons::visible.id(), visible);
     notifyParentVisibilityChanged(visible);
 
+    /**
+     * The tiles of the invisible layers are the first candidates
+     * for swapping out. The layers saved as hidden should get the
+     * low priority right after loading as well.
+     *
+     * NOTE: the constructor calls us with (true, true), when
+     *       paintDevice() cannot be called yet. The devices have
+     *       the normal priority by default anyway.
+     */
+    if (!loading || !visible) {
+        KisPaintDeviceSP device = paintDevice();
+        if (device) {
+            device->setMemoryLowPriority(!visible);
+        }
+    }
+
     if (!loading) {
         baseNodeChangedCallback();
         baseNodeInvalidateAllFramesCallback();
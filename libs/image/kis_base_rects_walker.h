@@ -210,6 +210,18 @@ public:
         return m_levelOfDetail;
     }
 
+    /**
+     * True if the merge task of the walker has been partially
+     * executed and then preempted, \see KisAsyncMerger::startMerge()
+     */
+    inline bool mergeInterrupted() const {
+        return m_mergeInterrupted;
+    }
+
+    inline void setMergeInterrupted(bool value) {
+        m_mergeInterrupted = value;
+    }
+
     virtual UpdateType type() const = 0;
 
 protected:
@@ -252,6 +264,7 @@ protected:
             m_childNeedRect = m_lastNeedRect = QRect();
 
         m_needRectVaries = m_changeRectVaries = false;
+        m_mergeInterrupted = false;
         m_mergeTask.clear();
         m_cloneNotifications.clear();
 
@@ -467,6 +480,7 @@ private:
     QRect m_resultUncroppedChangeRect;
     bool m_needRectVaries {false};
     bool m_changeRectVaries {false};
+    bool m_mergeInterrupted {false};
     LeafStack m_mergeTask;
     CloneNotificationsVector m_cloneNotifications;
 
@@ -73,6 +73,11 @@ void *KisDefaultBounds::sourceCookie() const
     return m_d->image.data();
 }
 
+int KisDefaultBounds::memoryOwner() const
+{
+    return m_d->image ? m_d->image->memoryOwner() : 0;
+}
+
 /******************************************************************/
 /*                  KisSelectionDefaultBounds                     */
 /******************************************************************/
@@ -134,6 +139,12 @@ void *KisSelectionDefaultBounds::sourceCookie() const
     return m_d->parentDevice.data();
 }
 
+int KisSelectionDefaultBounds::memoryOwner() const
+{
+    return m_d->parentDevice ?
+        m_d->parentDevice->defaultBounds()->memoryOwner() : 0;
+}
+
 /******************************************************************/
 /*                   KisSelectionEmptyBounds                      */
 /******************************************************************/
@@ -203,3 +214,8 @@ void *KisWrapAroundBoundsWrapper::sourceCookie() const
 {
     return m_d->base->sourceCookie();
 }
+
+int KisWrapAroundBoundsWrapper::memoryOwner() const
+{
+    return m_d->base->memoryOwner();
+}
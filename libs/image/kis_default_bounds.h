@@ -32,6 +32,7 @@ public:
     int currentTime() const override;
     bool externalFrameActive() const override;
     void * sourceCookie() const override;
+    int memoryOwner() const override;
 
 protected:
     friend class KisPaintDeviceTest;
@@ -57,6 +58,7 @@ public:
     int currentTime() const override;
     bool externalFrameActive() const override;
     void * sourceCookie() const override;
+    int memoryOwner() const override;
 
 private:
     Q_DISABLE_COPY(KisSelectionDefaultBounds)
@@ -90,6 +92,7 @@ public:
     int currentTime() const override;
     bool externalFrameActive() const override;
     void * sourceCookie() const override;
+    int memoryOwner() const override;
 
 protected:
     friend class KisPaintDeviceTest;
@@ -15,3 +15,8 @@ QRect KisDefaultBoundsBase::imageBorderRect() const
     return bounds();
 }
 
+int KisDefaultBoundsBase::memoryOwner() const
+{
+    return 0;
+}
+
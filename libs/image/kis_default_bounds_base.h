@@ -66,6 +66,15 @@ public:
      *       purposes only!
      */
     virtual void* sourceCookie() const = 0;
+
+    /**
+     * Returns the id of the document the paint device belongs
+     * to in the per-document memory accounting of the tile data
+     * store. Zero means the device doesn't belong to any document.
+     *
+     * \see KisTileDataStore::registerMemoryOwner()
+     */
+    virtual int memoryOwner() const;
 };
 
 
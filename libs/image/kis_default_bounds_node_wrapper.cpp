@@ -67,3 +67,8 @@ void *KisDefaultBoundsNodeWrapper::sourceCookie() const
     return m_d->node->original() ? m_d->node->original()->defaultBounds()->sourceCookie() : nullptr;
 }
 
+int KisDefaultBoundsNodeWrapper::memoryOwner() const
+{
+    return m_d->node && m_d->node->image() ? m_d->node->image()->memoryOwner() : 0;
+}
+
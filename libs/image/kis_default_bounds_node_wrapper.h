@@ -26,6 +26,7 @@ public:
     int currentTime() const override;
     bool externalFrameActive() const override;
     void *sourceCookie() const override;
+    int memoryOwner() const override;
 
     static const QRect infiniteRect;
 
@@ -4,6 +4,9 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <QMutex>
+#include <QRegion>
+
 #include <KoIcon.h>
 #include <kis_icon.h>
 #include <KoCompositeOpRegistry.h>
@@ -21,10 +24,114 @@
 #include "kis_busy_progress_indicator.h"
 #include "kis_transaction.h"
 #include "kis_painter.h"
+#include "kis_paint_device.h"
+#include "kis_image_config.h"
+
+/**
+ * The result of the filter is cached, so that it could be reused when
+ * the mask is updated in N_BELOW_FILTHY position, that is, when only
+ * the masks above it have changed and the input of the filter is the
+ * same. The cache is dropped when the filter, the parent layer or its
+ * color space change. The areas passed to setDirty() are dropped as
+ * well.
+ *
+ * The cache works for level of detail 0 only.
+ */
+struct KisFilterMask::Private
+{
+    Private()
+        : enabled(KisImageConfig(true).useFilterMaskResultCache())
+    {
+    }
+
+    const bool enabled;
+
+    QMutex lock;
+    KisPaintDeviceSP device;
+    QRegion validRegion;
+
+    KisFilterConfiguration *config = 0;
+    KisNode *parent = 0;
+    const KoColorSpace *colorSpace = 0;
+
+    void reset() {
+        QMutexLocker l(&lock);
+        resetUnlocked();
+    }
+
+    void resetUnlocked() {
+        device = 0;
+        validRegion = QRegion();
+        config = 0;
+        parent = 0;
+        colorSpace = 0;
+    }
+
+    void invalidate(const QRect &rc) {
+        QMutexLocker l(&lock);
+        validRegion -= rc;
+    }
+
+    bool fetch(KisPaintDeviceSP dst, const QRect &rc,
+               KisFilterConfiguration *_config, KisNode *_parent) {
+        KisPaintDeviceSP srcDevice;
+
+        {
+            QMutexLocker l(&lock);
+
+            if (!device || config != _config || parent != _parent ||
+                colorSpace != dst->colorSpace() ||
+                !QRegion(rc).subtracted(validRegion).isEmpty()) {
+
+                return false;
+            }
+
+            srcDevice = device;
+        }
+
+        KisPainter::copyAreaOptimized(rc.topLeft(), srcDevice, dst, rc);
+        return true;
+    }
+
+    void store(KisPaintDeviceSP src, const QRect &rc,
+               KisFilterConfiguration *_config, KisNode *_parent) {
+        KisPaintDeviceSP dstDevice;
+
+        {
+            QMutexLocker l(&lock);
+
+            if (!device || config != _config || parent != _parent ||
+                colorSpace != src->colorSpace()) {
+
+                resetUnlocked();
+
+                device = new KisPaintDevice(src->colorSpace());
+                config = _config;
+                parent = _parent;
+                colorSpace = src->colorSpace();
+            }
+
+            dstDevice = device;
+        }
+
+        /**
+         * The walkers never process overlapping areas of the same
+         * node concurrently, so the area can be copied without
+         * holding the lock
+         */
+        KisPainter::copyAreaOptimized(rc.topLeft(), src, dstDevice, rc);
+
+        QMutexLocker l(&lock);
+        if (device == dstDevice) {
+            validRegion += rc;
+        }
+    }
+};
 
 KisFilterMask::KisFilterMask(KisImageWSP image, const QString &name)
     : KisEffectMask(image, name),
-      KisNodeFilterInterface(0)
+      KisNodeFilterInterface(0),
+      m_d(new Private)
 {
     setCompositeOpId(COMPOSITE_COPY);
 }
@@ -36,6 +143,7 @@ KisFilterMask::~KisFilterMask()
 KisFilterMask::KisFilterMask(const KisFilterMask& rhs)
         : KisEffectMask(rhs)
         , KisNodeFilterInterface(rhs)
+        , m_d(new Private)
 {
 }
 
@@ -47,6 +155,18 @@ QIcon KisFilterMask::icon() const
 void KisFilterMask::setFilter(KisFilterConfigurationSP  filterConfig)
 {
     KisNodeFilterInterface::setFilter(filterConfig);
+    m_d->reset();
+}
+
+void KisFilterMask::setDirty(const QVector<QRect> &rects)
+{
+    if (m_d->enabled) {
+        Q_FOREACH (const QRect &rc, rects) {
+            m_d->invalidate(changeRect(rc));
+        }
+    }
+
+    KisEffectMask::setDirty(rects);
 }
 
 QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
@@ -54,8 +174,6 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
                                   const QRect & rc,
                                   PositionToFilthy maskPos) const
 {
-    Q_UNUSED(maskPos);
-
     KisFilterConfigurationSP filterConfig = filter();
 
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(nodeProgressProxy(), rc);
@@ -78,12 +196,25 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
         return QRect();
     }
 
+    const int lod = dst->defaultBounds()->currentLevelOfDetail();
+    const bool useCache = m_d->enabled && !lod;
+
+    if (useCache && maskPos == N_BELOW_FILTHY &&
+        m_d->fetch(dst, rc, filterConfig.data(), parent().data())) {
+
+        return filter->changedRect(rc, filterConfig.data(), lod);
+    }
+
     KIS_ASSERT_RECOVER_NOOP(this->busyProgressIndicator());
     this->busyProgressIndicator()->update();
 
     filter->process(src, dst, 0, rc, filterConfig.data(), 0);
 
-    QRect r = filter->changedRect(rc, filterConfig.data(), dst->defaultBounds()->currentLevelOfDetail());
+    if (useCache) {
+        m_d->store(dst, rc, filterConfig.data(), parent().data());
+    }
+
+    QRect r = filter->changedRect(rc, filterConfig.data(), lod);
     return r;
 }
 
@@ -6,6 +6,8 @@
 #ifndef _KIS_FILTER_MASK_
 #define _KIS_FILTER_MASK_
 
+#include <QScopedPointer>
+
 #include "kis_types.h"
 #include "kis_effect_mask.h"
 
@@ -53,6 +55,13 @@ public:
 
     QRect changeRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
     QRect needRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
+
+    using KisEffectMask::setDirty;
+    void setDirty(const QVector<QRect> &rects) override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
 };
 
 #endif //_KIS_FILTER_MASK_
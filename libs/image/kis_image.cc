@@ -42,6 +42,7 @@
 #include "kis_transaction.h"
 #include "kis_meta_data_merge_strategy.h"
 #include "kis_memory_statistics_server.h"
+#include "tiles3/kis_tile_data_store.h"
 #include "kis_node.h"
 #include "kis_types.h"
 
@@ -101,6 +102,7 @@
 #include "KisRunnableStrokeJobsInterface.h"
 
 #include "KisBusyWaitBroker.h"
+#include "KisAsyncBarrierStrokeStrategy.h"
 
 
 // #define SANITY_CHECKS
@@ -130,6 +132,7 @@ public:
                     KisUndoStore *undo,
                     KisImageAnimationInterface *_animationInterface)
         : q(_q)
+        , memoryOwner(KisTileDataStore::instance()->registerMemoryOwner())
         , lockedForReadOnly(false)
         , width(w)
         , height(h)
@@ -186,9 +189,12 @@ public:
          * and undo are still alive
          */
         rootLayer.clear();
+
+        KisTileDataStore::instance()->unregisterMemoryOwner(memoryOwner);
     }
 
     KisImage *q;
+    int memoryOwner;
 
     quint32 lockCount = 0;
     bool lockedForReadOnly;
@@ -735,6 +741,13 @@ bool KisImage::tryBarrierLock(bool readOnly)
     return result;
 }
 
+void KisImage::runBarrierAsync(std::function<void()> exclusiveFunc,
+                               std::function<void()> guiFunc)
+{
+    KisStrokeId id = startStroke(new KisAsyncBarrierStrokeStrategy(exclusiveFunc, guiFunc, this));
+    endStroke(id);
+}
+
 bool KisImage::isIdle(bool allowLocked)
 {
     return (allowLocked || !locked()) && m_d->scheduler.isIdle();
@@ -2449,6 +2462,11 @@ KisLodPreferences KisImage::lodPreferences() const
     return m_d->scheduler.lodPreferences();
 }
 
+void KisImage::setVisibleRect(const QRect &rc)
+{
+    m_d->scheduler.setVisibleRect(rc);
+}
+
 void KisImage::nodeCollapsedChanged(KisNode * node)
 {
     Q_UNUSED(node);
@@ -2460,6 +2478,11 @@ KisImageAnimationInterface* KisImage::animationInterface() const
     return m_d->animationInterface;
 }
 
+int KisImage::memoryOwner() const
+{
+    return m_d->memoryOwner;
+}
+
 void KisImage::setProofingConfiguration(KisProofingConfigurationSP proofingConfig)
 {
     m_d->proofingConfig = proofingConfig;
@@ -13,6 +13,8 @@
 #include <QRect>
 #include <QBitArray>
 
+#include <functional>
+
 #include <KoColorConversionTransformation.h>
 
 #include "kis_types.h"
@@ -754,8 +756,22 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Set the area of the image (in image pixels) that is currently
+     * visible on the canvas. The projection updates intersecting
+     * this area are processed first, the offscreen ones are
+     * deferred until there is nothing visible to update.
+     */
+    void setVisibleRect(const QRect &rc);
+
     KisImageAnimationInterface *animationInterface() const;
 
+    /**
+     * The id the image uses for accounting its tiles in the tile
+     * data store, see KisTileDataStore::registerMemoryOwner()
+     */
+    int memoryOwner() const;
+
     /**
      * @brief setProofingConfiguration, this sets the image's proofing configuration, and signals
      * the proofingConfiguration has changed.
@@ -978,6 +994,25 @@ public Q_SLOTS:
      */
     bool tryBarrierLock(bool readOnly = false);
 
+    /**
+     * @brief An asynchronous alternative to barrierLock()
+     *
+     * Schedules \p exclusiveFunc to be executed in a worker thread when
+     * all the queued operations are finished, with no other job running
+     * at the same time. The calling thread is not blocked and no
+     * busy-wait dialog is shown. When the function is completed,
+     * \p guiFunc is called in the GUI thread, unless the image has been
+     * deleted meanwhile.
+     *
+     * Use it instead of barrierLock() when the result of the operation
+     * is not needed immediately by the caller. \p exclusiveFunc should
+     * not access any GUI objects.
+     *
+     * @see KisAsyncBarrierStrokeStrategy
+     */
+    void runBarrierAsync(std::function<void()> exclusiveFunc,
+                         std::function<void()> guiFunc = std::function<void()>());
+
     /**
      * Wait for all the internal image jobs to complete and return without locking
      * the image. This function is handly for tests or other synchronous actions,
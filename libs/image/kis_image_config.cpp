@@ -167,6 +167,94 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompressionCodec(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionCodec", "lzf") : "lzf";
+}
+
+void KisImageConfig::setSwapCompressionCodec(const QString &value)
+{
+    m_config.writeEntry("swapCompressionCodec", value);
+}
+
+int KisImageConfig::swapCompressionLevel(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionLevel", 1) : 1;
+}
+
+void KisImageConfig::setSwapCompressionLevel(int value)
+{
+    m_config.writeEntry("swapCompressionLevel", value);
+}
+
+bool KisImageConfig::useMappedSwapFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useMappedSwapFile", false) : false;
+}
+
+void KisImageConfig::setUseMappedSwapFile(bool value)
+{
+    m_config.writeEntry("useMappedSwapFile", value);
+}
+
+bool KisImageConfig::tileDataDeduplication(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tileDataDeduplication", false) : false;
+}
+
+void KisImageConfig::setTileDataDeduplication(bool value)
+{
+    m_config.writeEntry("tileDataDeduplication", value);
+}
+
+int KisImageConfig::undoCompactionDepth(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoCompactionDepth", 0) : 0;
+}
+
+void KisImageConfig::setUndoCompactionDepth(int value)
+{
+    m_config.writeEntry("undoCompactionDepth", value);
+}
+
+int KisImageConfig::undoMemoryLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoMemoryLimit", 0) : 0;
+}
+
+void KisImageConfig::setUndoMemoryLimit(int value)
+{
+    m_config.writeEntry("undoMemoryLimit", value);
+}
+
+int KisImageConfig::undoJournalDepth(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("undoJournalDepth", 0) : 0;
+}
+
+void KisImageConfig::setUndoJournalDepth(int value)
+{
+    m_config.writeEntry("undoJournalDepth", value);
+}
+
+int KisImageConfig::inactiveDocumentMemoryLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("inactiveDocumentMemoryLimit", 0) : 0;
+}
+
+void KisImageConfig::setInactiveDocumentMemoryLimit(int value)
+{
+    m_config.writeEntry("inactiveDocumentMemoryLimit", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -626,6 +714,26 @@ void KisImageConfig::setAnimationCacheRegionOfInterestMargin(qreal value)
     m_config.writeEntry("animationCacheRegionOfInterestMargin", value);
 }
 
+bool KisImageConfig::useFilterMaskResultCache(bool defaultValue) const
+{
+    return defaultValue ? false : m_config.readEntry("useFilterMaskResultCache", false);
+}
+
+void KisImageConfig::setUseFilterMaskResultCache(bool value)
+{
+    m_config.writeEntry("useFilterMaskResultCache", value);
+}
+
+bool KisImageConfig::useAdaptiveThreadCount(bool defaultValue) const
+{
+    return defaultValue ? false : m_config.readEntry("useAdaptiveThreadCount", false);
+}
+
+void KisImageConfig::setUseAdaptiveThreadCount(bool value)
+{
+    m_config.writeEntry("useAdaptiveThreadCount", value);
+}
+
 QColor KisImageConfig::selectionOverlayMaskColor(bool defaultValue) const
 {
     QColor def(255, 0, 0, 128);
@@ -46,6 +46,71 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * Name of the codec used for compressing tiles in the swap
+     * file: "lzf", "lz4" or "zstd". The codecs that are not
+     * available in the current build fall back to "lzf".
+     */
+    QString swapCompressionCodec(bool requestDefault = false) const;
+    void setSwapCompressionCodec(const QString &value);
+
+    /**
+     * Compression level for "zstd" and acceleration factor for
+     * "lz4" swap codecs. Ignored by "lzf".
+     */
+    int swapCompressionLevel(bool requestDefault = false) const;
+    void setSwapCompressionLevel(int value);
+
+    /**
+     * Map the whole swap file into memory instead of moving small
+     * read/write windows over it. Supported on Unix-like systems only.
+     */
+    bool useMappedSwapFile(bool requestDefault = false) const;
+    void setUseMappedSwapFile(bool value);
+
+    /**
+     * Merge byte-identical tile datas of different layers and undo
+     * history into one shared tile data
+     */
+    bool tileDataDeduplication(bool requestDefault = false) const;
+    void setTileDataDeduplication(bool value);
+
+    /**
+     * The number of the most recent revisions of a paint device that
+     * are kept intact. Older adjacent revisions are merged together,
+     * which drops the intermediate versions of the tiles. Zero
+     * disables the compaction.
+     */
+    int undoCompactionDepth(bool requestDefault = false) const;
+    void setUndoCompactionDepth(int value);
+
+    /**
+     * The amount of undo history that is allowed to stay in memory.
+     * Historical tiles above this limit are swapped out. Zero means
+     * the history is limited by tilesSoftLimit() only.
+     */
+    int undoMemoryLimit(bool requestDefault = false) const; // MiB
+    void setUndoMemoryLimit(int value);
+
+    /**
+     * The number of the most recent revisions of a paint device that
+     * are kept in the tile data store. The tiles of the older
+     * revisions are moved into the undo journal on disk and loaded
+     * back when the user undoes that far. Zero disables the journal.
+     */
+    int undoJournalDepth(bool requestDefault = false) const;
+    void setUndoJournalDepth(int value);
+
+    /**
+     * The amount of tile memory every document, except the one the
+     * user is currently working with, may keep in RAM. The tiles of
+     * the inactive documents exceeding the limit are swapped out.
+     * Zero means the inactive documents are limited by
+     * tilesSoftLimit() and tilesHardLimit() only.
+     */
+    int inactiveDocumentMemoryLimit(bool requestDefault = false) const; // MiB
+    void setInactiveDocumentMemoryLimit(int value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -129,6 +194,22 @@ public:
     qreal animationCacheRegionOfInterestMargin(bool defaultValue = false) const;
     void setAnimationCacheRegionOfInterestMargin(qreal value);
 
+    /**
+     * Keep the result of every filter mask, so that the filter is not
+     * rerun when only the masks above it are changed. Costs memory
+     * equal to the size of the filtered area of every mask.
+     */
+    bool useFilterMaskResultCache(bool defaultValue = false) const;
+    void setUseFilterMaskResultCache(bool value);
+
+    /**
+     * Let the scheduler use fewer threads than maxNumberOfThreads()
+     * when they are measured to finish the jobs faster. Experimental,
+     * disabled by default.
+     */
+    bool useAdaptiveThreadCount(bool defaultValue = false) const;
+    void setUseAdaptiveThreadCount(bool value);
+
     QColor selectionOverlayMaskColor(bool defaultValue = false) const;
     void setSelectionOverlayMaskColor(const QColor &color);
 
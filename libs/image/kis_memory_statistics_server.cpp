@@ -137,6 +137,10 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
                                        stats.layersSize,
                                        stats.projectionsSize,
                                        stats.lodSize);
+
+        stats.documentMemorySize =
+            KisTileDataStore::instance()->memoryOwnerMetric(image->memoryOwner()) *
+            KisTileData::WIDTH * KisTileData::HEIGHT;
     }
     stats.totalMemorySize = tileStats.totalMemorySize;
     stats.realMemorySize = tileStats.realMemorySize;
@@ -144,6 +148,8 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.swapOutThroughput = tileStats.swapOutThroughput;
+    stats.deduplicatedSize = tileStats.deduplicatedSize;
 
     KisImageConfig cfg(true);
 
@@ -151,6 +157,7 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.tilesSoftLimit = cfg.tilesSoftLimit() * MiB;
     stats.tilesPoolLimit = cfg.poolLimit() * MiB;
     stats.totalMemoryLimit = stats.tilesHardLimit + stats.tilesPoolLimit;
+    stats.documentMemoryLimit = cfg.inactiveDocumentMemoryLimit() * MiB;
 
     return stats;
 }
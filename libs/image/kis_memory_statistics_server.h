@@ -26,6 +26,7 @@ public:
               layersSize(0),
               projectionsSize(0),
               lodSize(0),
+              documentMemorySize(0),
 
               totalMemorySize(0),
               realMemorySize(0),
@@ -33,11 +34,14 @@ public:
               poolSize(0),
 
               swapSize(0),
+              swapOutThroughput(0),
+              deduplicatedSize(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
               tilesSoftLimit(0),
-              tilesPoolLimit(0)
+              tilesPoolLimit(0),
+              documentMemoryLimit(0)
         {
         }
 
@@ -45,6 +49,7 @@ public:
         qint64 layersSize;
         qint64 projectionsSize;
         qint64 lodSize;
+        qint64 documentMemorySize; // tiles of the image present in RAM
 
         qint64 totalMemorySize;
         qint64 realMemorySize;
@@ -52,11 +57,14 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapOutThroughput; // bytes per second
+        qint64 deduplicatedSize;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
         qint64 tilesSoftLimit;
         qint64 tilesPoolLimit;
+        qint64 documentMemoryLimit; // when the document is inactive
     };
 
 
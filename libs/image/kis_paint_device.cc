@@ -96,14 +96,16 @@ public:
 
     QScopedPointer<KisPaintDeviceFramesInterface> framesInterface;
     bool isProjectionDevice;
+    bool lowMemoryPriority;
 
     KisPaintDeviceStrategy* currentStrategy();
 
     void init(const KoColorSpace *cs, const quint8 *defaultPixel);
-    void convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand);
+    void convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoUpdater *progressUpdater);
     bool assignProfile(const KoColorProfile * profile, KUndo2Command *parentCommand);
 
     KUndo2Command* reincarnateWithDetachedHistory(bool copyContent);
+    void updateMemoryOwner();
 
 
     inline const KoColorSpace* colorSpace() const
@@ -408,7 +410,8 @@ public:
     LodDataStruct* createLodDataStruct(int lod);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
-    KisRegion regionForLodSyncing() const;
+    KisRegion regionForLodSyncing(int lod) const;
+    bool canSyncLodIncrementally(int lod) const;
 
     void updateLodDataManager(KisDataManager *srcDataManager,
                               KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
@@ -585,6 +588,18 @@ private:
     mutable QScopedPointer<Data> m_externalFrameData;
     mutable QMutex m_dataSwitchLock;
 
+    /**
+     * Copies of the source and lod data managers made at the moment
+     * of the last lod synchronization. They share the tile data with
+     * the devices, so the tiles written since then can be found by
+     * comparing the tile data pointers (see regionForLodSyncing()).
+     * The source one is taken when the lod data struct is created,
+     * the lod one when it is uploaded. Projection devices have none.
+     */
+    KisDataManagerSP m_lodSyncSourceSnapshot;
+    KisDataManagerSP m_lodSyncLodSnapshot;
+    QPoint m_lodSyncSourceOffset;
+
     FramesHash m_frames;
     int m_nextFreeFrameId;
 };
@@ -597,6 +612,7 @@ KisPaintDevice::Private::Private(KisPaintDevice *paintDevice)
     : q(paintDevice),
       basicStrategy(new KisPaintDeviceStrategy(paintDevice, this)),
       isProjectionDevice(false),
+      lowMemoryPriority(false),
       m_data(new Data(paintDevice)),
       m_nextFreeFrameId(0)
 {
@@ -664,12 +680,69 @@ struct KisPaintDevice::Private::StrategyPolicy {
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
     LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
     QScopedPointer<Data> lodData;
+
+    /**
+     * The state of the source device at the moment the struct has been
+     * created, it becomes the sync snapshot of the device on upload
+     */
+    KisDataManagerSP sourceSnapshot;
+    QPoint sourceOffset;
 };
 
-KisRegion KisPaintDevice::Private::regionForLodSyncing() const
+bool KisPaintDevice::Private::canSyncLodIncrementally(int lod) const
+{
+    if (!m_lodData || !m_lodSyncSourceSnapshot || !m_lodSyncLodSnapshot) return false;
+
+    Data *srcData = currentNonLodData();
+    KisDataManager *srcDataManager = srcData->dataManager().data();
+    KisDataManager *lodDataManager = m_lodData->dataManager().data();
+
+    /**
+     * The color spaces are compared as pure pointers, the same way
+     * as in createLodDataStruct()
+     */
+    return m_lodData->levelOfDetail() == lod &&
+        m_lodData->colorSpace() == srcData->colorSpace() &&
+        m_lodData->x() == KisLodTransform::coordToLodCoord(srcData->x(), lod) &&
+        m_lodData->y() == KisLodTransform::coordToLodCoord(srcData->y(), lod) &&
+        m_lodSyncSourceOffset == QPoint(srcData->x(), srcData->y()) &&
+        m_lodSyncSourceSnapshot->pixelSize() == srcDataManager->pixelSize() &&
+        m_lodSyncLodSnapshot->pixelSize() == lodDataManager->pixelSize() &&
+        !memcmp(m_lodSyncSourceSnapshot->defaultPixel(), srcDataManager->defaultPixel(), srcDataManager->pixelSize()) &&
+        !memcmp(m_lodSyncLodSnapshot->defaultPixel(), lodDataManager->defaultPixel(), lodDataManager->pixelSize());
+}
+
+KisRegion KisPaintDevice::Private::regionForLodSyncing(int lod) const
 {
     Data *srcData = currentNonLodData();
-    return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
+
+    if (!canSyncLodIncrementally(lod)) {
+        return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
+    }
+
+    /**
+     * The lod plane is still valid for all the tiles that have not
+     * been changed since the last synchronization, neither in the
+     * source device, nor in the lod plane itself (e.g. by a lodN
+     * stroke). The other tiles should be regenerated.
+     */
+    QVector<QRect> rects =
+        srcData->dataManager()->differingTileRects(m_lodSyncSourceSnapshot.data());
+
+    for (auto it = rects.begin(); it != rects.end(); ++it) {
+        it->translate(srcData->x(), srcData->y());
+    }
+
+    const QVector<QRect> lodRects =
+        m_lodData->dataManager()->differingTileRects(m_lodSyncLodSnapshot.data());
+
+    Q_FOREACH (const QRect &rc, lodRects) {
+        const QRect lodRect = rc.translated(m_lodData->x(), m_lodData->y());
+        rects << KisLodTransform::alignedRect(KisLodTransform::upscaledRect(lodRect, lod), lod);
+    }
+
+    // the source tiles may overlap with the upscaled lod tiles
+    return KisRegion::fromOverlappingRects(rects, KisTileData::WIDTH);
 }
 
 KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
@@ -679,7 +752,7 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
     Data *srcData = currentNonLodData();
 
     Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
+    LodDataStructImpl *lodStruct = new LodDataStructImpl(lodData);
 
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
     int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
@@ -703,6 +776,31 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
         // FIXME: different kind of synchronization
     }
 
+    /**
+     * When syncing incrementally, start from the current content of the
+     * lod plane, only the tiles returned by regionForLodSyncing() will be
+     * regenerated. Copying the tiles is cheap, they are shared until
+     * written to.
+     */
+    if (canSyncLodIncrementally(newLod)) {
+        KisDataManager *currentLodDataManager = m_lodData->dataManager().data();
+        lodData->dataManager()->bitBltRough(currentLodDataManager, currentLodDataManager->extent());
+    }
+
+    /**
+     * The snapshot is taken here, not on upload: the region for syncing
+     * is calculated against the current state of the device, and the
+     * tiles written after that must be found as changed on the next sync.
+     *
+     * Projections are skipped. They are rewritten completely by every
+     * update anyway, and holding a copy of them would make the first
+     * write into every projection tile clone it.
+     */
+    if (!isProjectionDevice) {
+        lodStruct->sourceSnapshot = new KisDataManager(*srcData->dataManager());
+        lodStruct->sourceOffset = QPoint(srcData->x(), srcData->y());
+    }
+
     lodData->cache()->invalidate();
 
     return lodStruct;
@@ -844,6 +942,15 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
 
     m_lodData->prepareClone(dst->lodData.data());
     m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+
+    if (dst->sourceSnapshot) {
+        m_lodSyncSourceSnapshot = dst->sourceSnapshot;
+        m_lodSyncLodSnapshot = new KisDataManager(*m_lodData->dataManager());
+        m_lodSyncSourceOffset = dst->sourceOffset;
+    } else {
+        m_lodSyncSourceSnapshot = 0;
+        m_lodSyncLodSnapshot = 0;
+    }
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -978,7 +1085,7 @@ public:
     }
 };
 
-void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand)
+void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoUpdater *progressUpdater)
 {
     QList<Data*> dataObjects = allDataObjects();
     if (dataObjects.isEmpty()) return;
@@ -989,7 +1096,7 @@ void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpa
     Q_FOREACH (Data *data, dataObjects) {
         if (!data) continue;
 
-        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand);
+        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand, progressUpdater);
     }
 
     q->emitColorSpaceChanged();
@@ -1025,6 +1132,17 @@ KUndo2Command *KisPaintDevice::Private::reincarnateWithDetachedHistory(bool copy
     return mainCommand;
 }
 
+void KisPaintDevice::Private::updateMemoryOwner()
+{
+    const int owner = defaultBounds ? defaultBounds->memoryOwner() : 0;
+
+    QList<Data*> dataObjects = allDataObjects();
+    Q_FOREACH (Data *data, dataObjects) {
+        if (!data) continue;
+        data->dataManager()->setMemoryOwner(owner, lowMemoryPriority);
+    }
+}
+
 void KisPaintDevice::Private::init(const KoColorSpace *cs, const quint8 *defaultPixel)
 {
     QList<Data*> dataObjects = allDataObjects();
@@ -1201,9 +1319,18 @@ KisNodeWSP KisPaintDevice::parentNode() const
 void KisPaintDevice::setDefaultBounds(KisDefaultBoundsBaseSP defaultBounds)
 {
     m_d->defaultBounds = defaultBounds;
+    m_d->updateMemoryOwner();
     m_d->cache()->invalidate();
 }
 
+void KisPaintDevice::setMemoryLowPriority(bool value)
+{
+    if (m_d->lowMemoryPriority == value) return;
+
+    m_d->lowMemoryPriority = value;
+    m_d->updateMemoryOwner();
+}
+
 KisDefaultBoundsBaseSP KisPaintDevice::defaultBounds() const
 {
     return m_d->defaultBounds;
@@ -1563,9 +1690,9 @@ void KisPaintDevice::emitProfileChanged()
     emit profileChanged(m_d->colorSpace()->profile());
 }
 
-void KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand)
+void KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoUpdater *progressUpdater)
 {
-    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand);
+    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand, progressUpdater);
 }
 
 bool KisPaintDevice::setProfile(const KoColorProfile * profile, KUndo2Command *parentCommand)
@@ -2123,9 +2250,9 @@ KisPaintDevice::LodDataStruct::~LodDataStruct()
 {
 }
 
-KisRegion KisPaintDevice::regionForLodSyncing() const
+KisRegion KisPaintDevice::regionForLodSyncing(int lod) const
 {
-    return m_d->regionForLodSyncing();
+    return m_d->regionForLodSyncing(lod);
 }
 
 KisPaintDevice::LodDataStruct* KisPaintDevice::createLodDataStruct(int lod)
@@ -141,6 +141,13 @@ public:
      */
     KisDefaultBoundsBaseSP defaultBounds() const;
 
+    /**
+     * Marks the tiles of the paint device as the first candidates
+     * for swapping out when the memory is low, e.g. when the layer
+     * is invisible
+     */
+    void setMemoryLowPriority(bool value);
+
     /**
      * Moves the device to these new coordinates (no incremental move)
      */
@@ -471,11 +478,17 @@ public:
 
     /**
      * Converts the paint device to a different colorspace
+     *
+     * The tiles are converted in parallel on the global thread pool.
+     * If \p progressUpdater is set, the progress of the conversion is
+     * reported to it. For animated devices the progress is reported
+     * for every frame separately.
      */
     void convertTo(const KoColorSpace * dstColorSpace,
                    KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent(),
                    KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags(),
-                   KUndo2Command *parentCommand = 0);
+                   KUndo2Command *parentCommand = 0,
+                   KoUpdater *progressUpdater = 0);
 
     /**
      * Changes the profile of the colorspace of this paint device to the given
@@ -872,7 +885,17 @@ public:
         virtual ~LodDataStruct();
     };
 
-    KisRegion regionForLodSyncing() const;
+    /**
+     * Returns the region of the device that should be regenerated to
+     * bring the lod plane of level \p lod in sync with the device. If
+     * the plane has already been synced to the same level, only the
+     * tiles changed since then are returned, otherwise the whole
+     * device. It should be called right after createLodDataStruct(),
+     * without any changes to the device in between: the struct saves
+     * the state of the device the next sync will be compared against.
+     * Projection devices are always synced completely.
+     */
+    KisRegion regionForLodSyncing(int lod) const;
     LodDataStruct* createLodDataStruct(int lod);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
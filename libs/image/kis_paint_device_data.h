@@ -7,9 +7,14 @@
 #ifndef __KIS_PAINT_DEVICE_DATA_H
 #define __KIS_PAINT_DEVICE_DATA_H
 
+#include <QMutex>
+#include <QtConcurrentMap>
+
 #include "KoAlwaysInline.h"
+#include "KoUpdater.h"
 #include "kundo2command.h"
 #include "kis_command_utils.h"
+#include "krita_utils.h"
 
 
 struct DirectDataAccessPolicy {
@@ -61,6 +66,7 @@ public:
           m_levelOfDetail(rhs->m_levelOfDetail),
           m_cacheInvalidator(this)
         {
+            inheritMemoryOwner(m_dataManager.data(), rhs->m_dataManager.data());
             m_cache.setupCache();
         }
 
@@ -153,7 +159,7 @@ public:
         }
     }
 
-    void convertDataColorSpace(const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand) {
+    void convertDataColorSpace(const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoUpdater *progressUpdater = 0) {
         typedef KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy> InternalSequentialConstIterator;
         typedef KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy> InternalSequentialIterator;
 
@@ -169,29 +175,62 @@ public:
         m_colorSpace->convertPixelsTo(m_dataManager->defaultPixel(), dstDefaultPixel.data(), dstColorSpace, 1, renderingIntent, conversionFlags);
 
         KisDataManagerSP dstDataManager = new KisDataManager(dstPixelSize, dstDefaultPixel.data());
+        inheritMemoryOwner(dstDataManager.data(), m_dataManager.data());
 
 
         if (!rc.isEmpty()) {
-            InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), rc);
-            InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager.data(), cacheInvalidator()), rc);
+            /**
+             * The data is converted in patches of 4x4 tiles. The patches
+             * are aligned to the tile grid of the data managers, so no
+             * tile is shared between the worker threads. Every thread
+             * gets its own transformation from KoColorConversionCache,
+             * which keeps a separate fast-path entry per thread, so the
+             * transformations are never used concurrently.
+             */
+            const int patchSize = 256;
+            QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc, QSize(patchSize, patchSize));
+
+            QMutex progressLock;
+            int numPatchesDone = 0;
+
+            if (progressUpdater) {
+                progressUpdater->setProgress(0);
+            }
+
+            auto convertPatch = [&] (const QRect &patchRect) {
+                InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), patchRect);
+                InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager.data(), cacheInvalidator()), patchRect);
+
+                int nConseqPixels = srcIt.nConseqPixels();
 
-            int nConseqPixels = srcIt.nConseqPixels();
+                // since we are accessing data managers directly, the columns are always aligned
+                KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
 
-            // since we are accessing data managers directly, the columns are always aligned
-            KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
+                while(srcIt.nextPixels(nConseqPixels) &&
+                      dstIt.nextPixels(nConseqPixels)) {
 
-            while(srcIt.nextPixels(nConseqPixels) &&
-                  dstIt.nextPixels(nConseqPixels)) {
+                    nConseqPixels = srcIt.nConseqPixels();
 
-                nConseqPixels = srcIt.nConseqPixels();
+                    const quint8 *srcData = srcIt.rawDataConst();
+                    quint8 *dstData = dstIt.rawData();
 
-                const quint8 *srcData = srcIt.rawDataConst();
-                quint8 *dstData = dstIt.rawData();
+                    m_colorSpace->convertPixelsTo(srcData, dstData,
+                                                  dstColorSpace,
+                                                  nConseqPixels,
+                                                  renderingIntent, conversionFlags);
+                }
 
-                m_colorSpace->convertPixelsTo(srcData, dstData,
-                                              dstColorSpace,
-                                              nConseqPixels,
-                                              renderingIntent, conversionFlags);
+                if (progressUpdater) {
+                    QMutexLocker l(&progressLock);
+                    numPatchesDone++;
+                    progressUpdater->setProgress(100 * numPatchesDone / patches.size());
+                }
+            };
+
+            if (patches.size() > 1) {
+                QtConcurrent::blockingMap(patches, convertPatch);
+            } else {
+                convertPatch(rc);
             }
         }
 
@@ -246,6 +285,7 @@ public:
                     copyContent ?
                     new KisDataManager(*this->dataManager()) :
                     new KisDataManager(this->dataManager()->pixelSize(), this->dataManager()->defaultPixel());
+                inheritMemoryOwner(newDm.data(), this->dataManager().data());
                 return new SwitchDataManager(this, this->dataManager(), newDm);
             });
     }
@@ -255,13 +295,17 @@ public:
         m_y = srcData->y();
 
         if (copyContent) {
+            KisDataManagerSP oldDm = m_dataManager;
             m_dataManager = new KisDataManager(*srcData->dataManager());
+            inheritMemoryOwner(m_dataManager.data(), oldDm.data());
         } else if (m_dataManager->pixelSize() !=
                    srcData->dataManager()->pixelSize()) {
             // NOTE: we don't check default pixel value! it is the task of
             //       the higher level!
 
+            KisDataManagerSP oldDm = m_dataManager;
             m_dataManager = new KisDataManager(srcData->dataManager()->pixelSize(), srcData->dataManager()->defaultPixel());
+            inheritMemoryOwner(m_dataManager.data(), oldDm.data());
             m_cache.setupCache();
         } else {
             m_dataManager->clear();
@@ -321,6 +365,15 @@ public:
 
 
 private:
+    /**
+     * The data managers created for the same data object should be
+     * accounted for the same document, see KisTileDataStore::registerMemoryOwner()
+     */
+    static void inheritMemoryOwner(KisDataManager *dm, const KisDataManager *srcDm) {
+        if (!srcDm) return;
+        dm->setMemoryOwner(srcDm->memoryOwner(), srcDm->lowMemoryPriority());
+    }
+
     struct CacheInvalidator : public KisIteratorCompleteListener {
         CacheInvalidator(KisPaintDeviceData *_q) : q(_q) {}
 
@@ -12,6 +12,8 @@
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_lod_transform.h"
+#include "tiles3/kis_tile_data_interface.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -70,6 +72,18 @@ void KisSimpleUpdateQueue::updateSettings()
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
 }
 
+void KisSimpleUpdateQueue::setVisibleRect(const QRect &rc)
+{
+    QMutexLocker locker(&m_lock);
+    m_visibleRect = rc;
+}
+
+QRect KisSimpleUpdateQueue::visibleRect() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_visibleRect;
+}
+
 int KisSimpleUpdateQueue::overrideLevelOfDetail() const
 {
     return m_overrideLevelOfDetail;
@@ -85,16 +99,124 @@ void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
     updaterContext.unlock();
 }
 
-bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
+namespace {
+
+/**
+ * The walkers are never split into parts smaller than
+ * this number of tiles
+ */
+const int MIN_SPLIT_TILES = 2;
+
+inline int tileFloor(int coord, int tileSize) {
+    return coord >= 0 ? coord / tileSize : -((-coord + tileSize - 1) / tileSize);
+}
+
+QVector<QRect> splitRectIntoStripes(const QRect &rc, int maxParts)
 {
-    QMutexLocker locker(&m_lock);
+    QVector<QRect> result;
+
+    const bool horizontal = rc.width() >= rc.height();
+    const int tileSize = horizontal ? KisTileData::WIDTH : KisTileData::HEIGHT;
+    const int start = horizontal ? rc.x() : rc.y();
+    const int end = horizontal ? rc.x() + rc.width() : rc.y() + rc.height();
+
+    const int firstTile = tileFloor(start, tileSize);
+    const int numTiles = tileFloor(end - 1, tileSize) - firstTile + 1;
+    const int numParts = qMin(maxParts, numTiles / MIN_SPLIT_TILES);
+
+    if (numParts < 2) return result;
+
+    for (int i = 0; i < numParts; i++) {
+        const int partStart = (firstTile + numTiles * i / numParts) * tileSize;
+        const int partEnd = (firstTile + numTiles * (i + 1) / numParts) * tileSize;
+
+        const QRect partRect = horizontal ?
+            QRect(partStart, rc.y(), partEnd - partStart, rc.height()) :
+            QRect(rc.x(), partStart, rc.width(), partEnd - partStart);
+
+        result.append(rc & partRect);
+    }
+
+    return result;
+}
+
+}
+
+KisBaseRectsWalkerSP KisSimpleUpdateQueue::createWalker(KisBaseRectsWalker::UpdateType type, const QRect &cropRect)
+{
+    KisBaseRectsWalkerSP walker;
+
+    if (type == KisBaseRectsWalker::UPDATE) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
+        walker = new KisFullRefreshWalker(cropRect);
+    }
+    else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
+    }
+    /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
+
+    return walker;
+}
+
+KisWalkersList KisSimpleUpdateQueue::splitWalker(KisBaseRectsWalkerSP walker, int numParts)
+{
+    KisWalkersList parts;
+    if (numParts < 2) return parts;
+
+    // splitting would throw away the part of the merge that is already done
+    if (walker->mergeInterrupted()) return parts;
+
+    const QVector<QRect> rects = splitRectIntoStripes(walker->requestedRect(), numParts);
+    if (rects.isEmpty()) return parts;
+
+    m_overrideLevelOfDetail = walker->levelOfDetail();
+
+    Q_FOREACH (const QRect &rc, rects) {
+        KisBaseRectsWalkerSP part = createWalker(walker->type(), walker->cropRect());
+        part->collectRects(walker->startNode(), rc);
+        parts.append(part);
+    }
+
+    m_overrideLevelOfDetail = -1;
+
+    return parts;
+}
+
+bool KisSimpleUpdateQueue::isVisibleWalker(KisBaseRectsWalkerSP walker) const
+{
+    const QRect changeRect =
+        KisLodTransform::upscaledRect(walker->changeRect(), walker->levelOfDetail());
 
+    return changeRect.intersects(m_visibleRect);
+}
+
+bool KisSimpleUpdateQueue::tryStartWalker(KisUpdaterContext &updaterContext, bool visibleOnly)
+{
     KisBaseRectsWalkerSP item;
     KisMutableWalkersListIterator iter(m_updatesList);
-    bool jobAdded = false;
 
     int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
 
+    /**
+     * The walkers that cannot be started because they intersect
+     * the running jobs (or are offscreen when \p visibleOnly is
+     * set). The walkers queued after them should not overtake
+     * them if they intersect, otherwise the parts of a split
+     * walker might be overwritten by an older update.
+     */
+    KisWalkersList blockedWalkers;
+
+    auto intersectsBlockedWalkers = [&blockedWalkers] (KisBaseRectsWalkerSP walker) {
+        Q_FOREACH (KisBaseRectsWalkerSP blocked, blockedWalkers) {
+            if (KisUpdaterContext::walkersIntersect(walker, blocked)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
     while(iter.hasNext()) {
         item = iter.next();
 
@@ -106,13 +228,71 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
             m_overrideLevelOfDetail = -1;
         }
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            updaterContext.isJobAllowed(item)) {
+        if (currentLevelOfDetail >= 0 && currentLevelOfDetail != item->levelOfDetail()) {
+            continue;
+        }
 
+        if ((visibleOnly && !isVisibleWalker(item)) ||
+            !updaterContext.isJobAllowed(item) ||
+            intersectsBlockedWalkers(item)) {
+
+            blockedWalkers.append(item);
+            continue;
+        }
+
+        iter.remove();
+
+        /**
+         * If there are more spare threads, split the walker into
+         * tile-aligned parts and start all the parts that don't
+         * intersect each other right now. The rest of the parts
+         * are put back at the same position in the queue.
+         */
+        const KisWalkersList parts = splitWalker(item, updaterContext.numSpareThreads());
+
+        if (!parts.isEmpty()) {
+            Q_FOREACH (KisBaseRectsWalkerSP part, parts) {
+                if (updaterContext.hasSpareThread() &&
+                    updaterContext.isJobAllowed(part) &&
+                    !intersectsBlockedWalkers(part)) {
+
+                    updaterContext.addMergeJob(part);
+                } else {
+                    iter.insert(part);
+                    blockedWalkers.append(part);
+                }
+            }
+        } else {
             updaterContext.addMergeJob(item);
-            iter.remove();
-            jobAdded = true;
-            break;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
+{
+    QMutexLocker locker(&m_lock);
+
+    /**
+     * The walkers touching the visible area of the image are started
+     * first. The offscreen ones are started only when there is
+     * no visible walker that could be started.
+     */
+    bool jobAdded = false;
+
+    /**
+     * Don't start new merges while the stroke jobs wait for
+     * the running ones to be preempted
+     */
+    if (!updaterContext.mergePreemptionRequested()) {
+        jobAdded = !m_visibleRect.isEmpty() &&
+            tryStartWalker(updaterContext, true);
+
+        if (!jobAdded) {
+            jobAdded = tryStartWalker(updaterContext, false);
         }
     }
 
@@ -183,22 +363,10 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
     Q_FOREACH (const QRect &rc, rects) {
         if (rc.isEmpty()) continue;
 
-        KisBaseRectsWalkerSP walker;
-
         if(trySplitJob(node, rc, cropRect, levelOfDetail, type)) continue;
         if(tryMergeJob(node, rc, cropRect, levelOfDetail, type)) continue;
 
-        if (type == KisBaseRectsWalker::UPDATE) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
-        }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
-            walker = new KisFullRefreshWalker(cropRect);
-        }
-        else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
-        }
-        /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
-
+        KisBaseRectsWalkerSP walker = createWalker(type, cropRect);
         walker->collectRects(node, rc);
         walkers.append(walker);
     }
@@ -231,6 +399,12 @@ void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
     m_spontaneousJobsList.append(spontaneousJob);
 }
 
+void KisSimpleUpdateQueue::addInterruptedWalker(KisBaseRectsWalkerSP walker)
+{
+    QMutexLocker locker(&m_lock);
+    m_updatesList.prepend(walker);
+}
+
 bool KisSimpleUpdateQueue::isEmpty() const
 {
     QMutexLocker locker(&m_lock);
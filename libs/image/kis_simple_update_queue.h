@@ -35,6 +35,13 @@ public:
     void addFullRefreshJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail);
     void addSpontaneousJob(KisSpontaneousJob *spontaneousJob);
 
+    /**
+     * Puts a walker, whose merge has been preempted by the stroke
+     * jobs, back to the head of the queue, so that it would be resumed
+     * before any other walker is started
+     */
+    void addInterruptedWalker(KisBaseRectsWalkerSP walker);
+
 
     void optimize();
 
@@ -45,10 +52,30 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * Sets the area of the image (in level of detail 0 coordinates)
+     * that is visible to the user. The walkers intersecting this
+     * area are processed before all the others. Pass an empty
+     * rect to process the walkers in FIFO order.
+     */
+    void setVisibleRect(const QRect &rc);
+    QRect visibleRect() const;
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
+    bool tryStartWalker(KisUpdaterContext &updaterContext, bool visibleOnly);
+    bool isVisibleWalker(KisBaseRectsWalkerSP walker) const;
+
+    /**
+     * Splits \p walker into at most \p numParts walkers with
+     * tile-aligned requested rects, so that a big update could
+     * be processed by several threads. Returns an empty list if
+     * the walker is too small for splitting.
+     */
+    KisWalkersList splitWalker(KisBaseRectsWalkerSP walker, int numParts);
+    static KisBaseRectsWalkerSP createWalker(KisBaseRectsWalker::UpdateType type, const QRect &cropRect);
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
@@ -93,6 +120,8 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    QRect m_visibleRect;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
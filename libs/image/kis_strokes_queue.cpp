@@ -16,6 +16,7 @@
 #include "kis_undo_stores.h"
 #include "kis_post_execution_undo_adapter.h"
 #include "KisCppQuirks.h"
+#include "KisSchedulerTracer.h"
 
 typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
@@ -154,6 +155,12 @@ void KisStrokesQueue::Private::startLod0ToNStroke(int levelOfDetail, bool forget
 
     if (!this->lod0ToNStrokeStrategyFactory) return;
 
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    if (tracer->isEnabled()) {
+        tracer->addInstantEvent(KisSchedulerTracer::LodSync,
+                                QString("lod%1 sync").arg(levelOfDetail));
+    }
+
     KisLodSyncPair syncPair = this->lod0ToNStrokeStrategyFactory(forgettable);
     executeStrokePair(syncPair, this->strokesQueue, this->strokesQueue.end(),  KisStroke::LODN, levelOfDetail, q);
 
@@ -559,6 +566,9 @@ void KisStrokesQueue::processQueue(KisUpdaterContext &updaterContext,
           processOneJob(updaterContext,
                         externalJobsPending));
 
+    updaterContext.setMergePreemptionRequested(
+        strokeStartBlockedByMergeJobs(updaterContext));
+
     m_d->mutex.unlock();
     updaterContext.unlock();
 }
@@ -835,6 +845,30 @@ bool KisStrokesQueue::checkSequentialProperty(KisUpdaterContextSnapshotEx snapsh
     return true;
 }
 
+bool KisStrokesQueue::strokeStartBlockedByMergeJobs(KisUpdaterContext &updaterContext)
+{
+    if(m_d->strokesQueue.isEmpty()) return false;
+
+    /**
+     * We preempt the merge jobs only to reduce the latency of
+     * starting a new stroke. The jobs of an initialized stroke
+     * should share the threads with the updates, otherwise the
+     * user will see no feedback while painting.
+     */
+    KisStrokeSP stroke = m_d->strokesQueue.head();
+    if(stroke->isInitialized() || !stroke->hasJobs()) return false;
+
+    const KisUpdaterContextSnapshotEx snapshot = updaterContext.getContextSnapshotEx();
+
+    if(!(snapshot & HasMergeJob)) return false;
+
+    // blocked by its own jobs, the merges are not guilty
+    if(snapshot & HasSequentialJob || snapshot & HasBarrierJob) return false;
+
+    // a barrier waits for the whole updates queue anyway
+    return stroke->nextJobSequentiality() != KisStrokeJobData::BARRIER;
+}
+
 bool KisStrokesQueue::checkLevelOfDetailProperty(int runningLevelOfDetail)
 {
     KisStrokeSP stroke = m_d->strokesQueue.head();
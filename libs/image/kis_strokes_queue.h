@@ -82,6 +82,7 @@ private:
     bool checkBarrierProperty(bool hasMergeJobs, bool hasStrokeJobs,
                               bool externalJobsPending);
     bool checkLevelOfDetailProperty(int runningLevelOfDetail);
+    bool strokeStartBlockedByMergeJobs(KisUpdaterContext &updaterContext);
 
     class LodNUndoStrokesFacade;
     KisStrokeId startLodNUndoStroke(KisStrokeStrategy *strokeStrategy);
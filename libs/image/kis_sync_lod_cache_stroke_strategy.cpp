@@ -74,16 +74,15 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
     KritaUtils::makeContainerUnique(deviceList);
 
 
-    KritaUtils::addJobBarrier(jobs, [sharedData, deviceList, levelOfDetail] () mutable {
-        Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-            sharedData->insert(device, toQShared(device->createLodDataStruct(levelOfDetail)));
-        }
-    });
-
-    KritaUtils::addJobSequential(jobs, [](){});
-
+    /**
+     * The lod data structs are created right here, in the same job that
+     * calculates the regions for syncing. The struct saves the state of
+     * the source device the region is calculated against, so they should
+     * not be separated by any other job that could modify the device.
+     */
     Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-        KisRegion region = device->regionForLodSyncing();
+        sharedData->insert(device, toQShared(device->createLodDataStruct(levelOfDetail)));
+        KisRegion region = device->regionForLodSyncing(levelOfDetail);
         QVector<QRect> rects = splitRegionIntoPatches(region, optimalPatchSize());
 
         Q_FOREACH (const QRect &rc, rects) {
@@ -11,12 +11,14 @@
 
 #include <QRunnable>
 #include <QReadWriteLock>
+#include <QElapsedTimer>
 
 #include "kis_stroke_job.h"
 #include "kis_spontaneous_job.h"
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisSchedulerTracer.h"
 
 //#define DEBUG_JOBS_SEQUENCE
 
@@ -49,8 +51,8 @@ public:
         if (!isRunning()) return;
 
         /**
-         * Here we break the idea of QThreadPool a bit. Ideally, we should split the
-         * jobs into distinct QRunnable objects and pass all of them to QThreadPool.
+         * Here we break the idea of a thread pool a bit. Ideally, we should split the
+         * jobs into distinct QRunnable objects and pass all of them to the executor.
          * That is a nice idea, but it doesn't work well when the jobs are small enough
          * and the number of available cores is high (>4 cores). It this case the
          * threads just tend to execute the job very quickly and go to sleep, which is
@@ -70,6 +72,21 @@ public:
                 m_updaterContext->m_exclusiveJobLock.lockForRead();
             }
 
+            KisAdaptiveThreadCountController::JobType controllerJobType =
+                KisAdaptiveThreadCountController::SpontaneousJob;
+            qint64 jobWorkAmount = 1;
+
+            if (m_atomicType == Type::MERGE && m_walker) {
+                const QRect changeRect = m_walker->changeRect();
+                controllerJobType = KisAdaptiveThreadCountController::MergeJob;
+                jobWorkAmount = qint64(changeRect.width()) * changeRect.height();
+            } else if (m_atomicType == Type::STROKE) {
+                controllerJobType = KisAdaptiveThreadCountController::StrokeJob;
+            }
+
+            QElapsedTimer jobTimer;
+            jobTimer.start();
+
             if(m_atomicType == Type::MERGE) {
                 runMergeJob();
             } else {
@@ -87,10 +104,23 @@ public:
                     }
 #endif
 
+                    KisSchedulerTracer::Scope tracerScope(
+                        m_atomicType == Type::STROKE ?
+                            KisSchedulerTracer::StrokeJob :
+                            KisSchedulerTracer::SpontaneousJob);
+
+                    if (tracerScope.isActive()) {
+                        tracerScope.setName(m_runnableJob->debugName());
+                    }
+
                     m_runnableJob->run();
                 }
             }
 
+            m_updaterContext->reportJobDuration(controllerJobType,
+                                                jobTimer.nsecsElapsed(),
+                                                jobWorkAmount);
+
             setDone();
 
             m_updaterContext->doSomeUsefulWork();
@@ -120,7 +150,22 @@ public:
 
 #endif
 
-        m_merger.startMerge(*m_walker);
+        KisSchedulerTracer::Scope tracerScope(KisSchedulerTracer::MergeJob,
+                                              "merge", m_walker->changeRect());
+
+        /**
+         * Without the scheduler there is no queue to put the
+         * interrupted walker into, so the merge cannot be preempted
+         */
+        const std::atomic<bool> *preemptionRequested =
+            m_updaterContext->m_scheduler ?
+            &m_updaterContext->m_mergePreemptionRequested : 0;
+
+        if (!m_merger.startMerge(*m_walker, true, preemptionRequested)) {
+            // the walker will be resumed when the stroke jobs are started
+            m_updaterContext->requeueInterruptedWalker(m_walker);
+            return;
+        }
 
         QRect changeRect = m_walker->changeRect();
         m_updaterContext->continueUpdate(changeRect);
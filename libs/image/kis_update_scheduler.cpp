@@ -17,6 +17,7 @@
 
 #include "kis_queues_progress_updater.h"
 #include "KisImageConfigNotifier.h"
+#include "KisSchedulerTracer.h"
 
 #include <QReadWriteLock>
 #include "kis_lazy_wait_condition.h"
@@ -262,6 +263,11 @@ KisLodPreferences KisUpdateScheduler::lodPreferences() const
     return m_d->strokesQueue.lodPreferences();
 }
 
+void KisUpdateScheduler::setVisibleRect(const QRect &rc)
+{
+    m_d->updatesQueue.setVisibleRect(rc);
+}
+
 void KisUpdateScheduler::explicitRegenerateLevelOfDetail()
 {
     m_d->strokesQueue.explicitRegenerateLevelOfDetail();
@@ -306,6 +312,7 @@ void KisUpdateScheduler::updateSettings()
     m_d->updatesQueue.updateSettings();
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
+    m_d->updaterContext.setAdaptiveThreadCountEnabled(config.useAdaptiveThreadCount());
     setThreadsLimit(config.maxNumberOfThreads());
 }
 
@@ -355,6 +362,8 @@ bool KisUpdateScheduler::tryBarrierLock()
         return false;
     }
 
+    KisSchedulerTracer::Scope tracerScope(KisSchedulerTracer::BarrierLock, "try barrier lock");
+
     m_d->processingBlocked = true;
     m_d->updaterContext.waitForDone();
     if(!m_d->updatesQueue.isEmpty() || !m_d->strokesQueue.isEmpty()) {
@@ -368,6 +377,8 @@ bool KisUpdateScheduler::tryBarrierLock()
 
 void KisUpdateScheduler::barrierLock()
 {
+    KisSchedulerTracer::Scope tracerScope(KisSchedulerTracer::BarrierLock, "barrier lock");
+
     do {
         m_d->processingBlocked = false;
         processQueues();
@@ -405,6 +416,11 @@ void KisUpdateScheduler::processQueues()
 
     }
 
+    if (m_d->updaterContext.adaptiveThreadCountEnabled()) {
+        m_d->updaterContext.setPendingJobs(m_d->updatesQueue.sizeMetric() +
+                                           m_d->strokesQueue.sizeMetric());
+    }
+
     progressUpdate();
 }
 
@@ -467,6 +483,11 @@ void KisUpdateScheduler::spareThreadAppeared()
     processQueues();
 }
 
+void KisUpdateScheduler::requeueInterruptedWalker(KisBaseRectsWalkerSP walker)
+{
+    m_d->updatesQueue.addInterruptedWalker(walker);
+}
+
 KisTestableUpdateScheduler::KisTestableUpdateScheduler(KisProjectionUpdateListener *projectionUpdateListener,
                                                        qint32 threadCount)
 {
@@ -21,6 +21,8 @@ class KoProgressProxy;
 class KisProjectionUpdateListener;
 class KisSpontaneousJob;
 class KisPostExecutionUndoAdapter;
+class KisBaseRectsWalker;
+typedef KisSharedPtr<KisBaseRectsWalker> KisBaseRectsWalkerSP;
 
 
 class KRITAIMAGE_EXPORT KisUpdateScheduler : public QObject, public KisStrokesFacade
@@ -152,6 +154,14 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the area of the image the user is looking at. The updates
+     * of this area are processed before the offscreen ones.
+     *
+     * \see KisSimpleUpdateQueue::setVisibleRect()
+     */
+    void setVisibleRect(const QRect &rc);
+
     /**
      * Explicitly start regeneration of LoD planes of all the devices
      * in the image. This call should be performed when the user is idle,
@@ -198,6 +208,7 @@ public:
     void continueUpdate(const QRect &rect);
     void doSomeUsefulWork();
     void spareThreadAppeared();
+    void requeueInterruptedWalker(KisBaseRectsWalkerSP walker);
 
 protected:
     // Trivial constructor for testing support
@@ -7,7 +7,6 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
@@ -22,12 +21,13 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *par
         threadCount = threadCount > 0 ? threadCount : 1;
     }
 
+    m_clock.start();
     setThreadsLimit(threadCount);
 }
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 
     if (m_testingMode) {
         clear();
@@ -89,15 +89,24 @@ int KisUpdaterContext::currentLevelOfDetail() const
 
 bool KisUpdaterContext::hasSpareThread()
 {
-    bool found = false;
+    return numSpareThreads() > 0;
+}
+
+int KisUpdaterContext::numSpareThreads() const
+{
+    return qMax(0, activeThreadsLimit() - numRunningJobs());
+}
+
+int KisUpdaterContext::numRunningJobs() const
+{
+    int numRunningJobs = 0;
 
     Q_FOREACH (const KisUpdateJobItem *item, m_jobs) {
-        if(!item->isRunning()) {
-            found = true;
-            break;
+        if(item->isRunning()) {
+            numRunningJobs++;
         }
     }
-    return found;
+    return numRunningJobs;
 }
 
 bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
@@ -136,7 +145,7 @@ void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
     // it might happen that we call this function from within
     // the thread itself, right when it finished its work
     if (shouldStartThread && !m_testingMode) {
-        m_threadPool.start(m_jobs[jobIndex]);
+        m_executor.start(m_jobs[jobIndex]);
     }
 }
 
@@ -151,7 +160,7 @@ void KisUpdaterContext::addStrokeJob(KisStrokeJob *strokeJob)
     // it might happen that we call this function from within
     // the thread itself, right when it finished its work
     if (shouldStartThread && !m_testingMode) {
-        m_threadPool.start(m_jobs[jobIndex]);
+        m_executor.start(m_jobs[jobIndex]);
     }
 }
 
@@ -166,13 +175,13 @@ void KisUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
     // it might happen that we call this function from within
     // the thread itself, right when it finished its work
     if (shouldStartThread && !m_testingMode) {
-        m_threadPool.start(m_jobs[jobIndex]);
+        m_executor.start(m_jobs[jobIndex]);
     }
 }
 
 void KisUpdaterContext::waitForDone()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 }
 
 bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
@@ -182,8 +191,19 @@ bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
         (job->accessRect().intersects(walker->changeRect()));
 }
 
+bool KisUpdaterContext::walkersIntersect(KisBaseRectsWalkerSP lhs,
+                                         KisBaseRectsWalkerSP rhs)
+{
+    return (lhs->accessRect().intersects(rhs->changeRect())) ||
+        (rhs->accessRect().intersects(lhs->changeRect()));
+}
+
 qint32 KisUpdaterContext::findSpareThread()
 {
+    /**
+     * The active threads limit is checked by hasSpareThread() only,
+     * the controller may change it between the two calls
+     */
     for(qint32 i=0; i < m_jobs.size(); i++)
         if(!m_jobs[i]->isRunning())
             return i;
@@ -203,7 +223,7 @@ void KisUpdaterContext::unlock()
 
 void KisUpdaterContext::setThreadsLimit(int value)
 {
-    m_threadPool.setMaxThreadCount(value);
+    m_executor.setMaxThreadCount(value);
 
     for (int i = 0; i < m_jobs.size(); i++) {
         KIS_SAFE_ASSERT_RECOVER_RETURN(!m_jobs[i]->isRunning());
@@ -219,14 +239,68 @@ void KisUpdaterContext::setThreadsLimit(int value)
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(this);
     }
+
+    m_threadsController.setMaxThreads(value);
 }
 
 int KisUpdaterContext::threadsLimit() const
 {
-    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_threadPool.maxThreadCount());
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_executor.maxThreadCount());
     return m_jobs.size();
 }
 
+void KisUpdaterContext::setAdaptiveThreadCountEnabled(bool value)
+{
+    m_adaptiveThreadCountRequested = value;
+    updateAdaptiveThreadCountState();
+}
+
+bool KisUpdaterContext::adaptiveThreadCountEnabled() const
+{
+    return m_adaptiveThreadCount;
+}
+
+void KisUpdaterContext::updateAdaptiveThreadCountState()
+{
+    const bool enabled = m_adaptiveThreadCountRequested && !m_testingMode;
+
+    m_threadsController.setEnabled(enabled);
+    m_adaptiveThreadCount = enabled;
+}
+
+int KisUpdaterContext::activeThreadsLimit() const
+{
+    return qMin(m_jobs.size(), m_threadsController.activeThreads());
+}
+
+void KisUpdaterContext::setPendingJobs(int value)
+{
+    m_threadsController.setPendingJobs(value);
+}
+
+void KisUpdaterContext::reportJobDuration(KisAdaptiveThreadCountController::JobType type,
+                                          qint64 duration, qint64 workAmount)
+{
+    if (!m_adaptiveThreadCount) return;
+    m_threadsController.reportJobFinished(type, duration, workAmount, m_clock.nsecsElapsed());
+}
+
+void KisUpdaterContext::setMergePreemptionRequested(bool value)
+{
+    m_mergePreemptionRequested = value;
+}
+
+bool KisUpdaterContext::mergePreemptionRequested() const
+{
+    return m_mergePreemptionRequested;
+}
+
+void KisUpdaterContext::requeueInterruptedWalker(KisBaseRectsWalkerSP walker)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_scheduler);
+    m_scheduler->requeueInterruptedWalker(walker);
+}
+
 void KisUpdaterContext::continueUpdate(const QRect& rc)
 {
     if (m_scheduler) m_scheduler->continueUpdate(rc);
@@ -240,12 +314,32 @@ void KisUpdaterContext::doSomeUsefulWork()
 void KisUpdaterContext::jobFinished()
 {
     m_lodCounter.removeLod();
-    if (m_scheduler) m_scheduler->spareThreadAppeared();
+    if (!m_scheduler) return;
+
+    /**
+     * Only one of the finishing workers at a time becomes a dispatcher
+     * and runs the scheduler, which locks the context and hands out the
+     * new jobs. The others just leave a request and return, so they don't
+     * wait for the context lock. Their job items become free and the new
+     * jobs put into them are pulled from the executor by the idle workers.
+     *
+     * The dispatcher repeats the pass until it has served all the requests,
+     * including the ones that came while the previous pass was running.
+     */
+    if (m_dispatchRequests.fetchAndAddOrdered(1) > 0) return;
+
+    int numServedRequests = 0;
+
+    do {
+        numServedRequests = m_dispatchRequests.loadAcquire();
+        m_scheduler->spareThreadAppeared();
+    } while (m_dispatchRequests.fetchAndAddOrdered(-numServedRequests) != numServedRequests);
 }
 
 void KisUpdaterContext::setTestingMode(bool value)
 {
     m_testingMode = value;
+    updateAdaptiveThreadCountState();
 }
 
 const QVector<KisUpdateJobItem*> KisUpdaterContext::getJobs()
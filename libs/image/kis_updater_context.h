@@ -7,15 +7,20 @@
 #ifndef __KIS_UPDATER_CONTEXT_H
 #define __KIS_UPDATER_CONTEXT_H
 
+#include <atomic>
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_lock_free_lod_counter.h"
 
 #include "KisUpdaterContextSnapshotEx.h"
+#include "KisWorkStealingExecutor.h"
+#include "KisAdaptiveThreadCountController.h"
 #include "kis_update_scheduler.h"
 
 class KisUpdateJobItem;
@@ -51,10 +56,22 @@ public:
 
     /**
      * Check whether there is a spare thread for running
-     * one more job
+     * one more job. The threads above the active threads
+     * limit are not considered spare.
+     *
+     * \see activeThreadsLimit()
      */
     bool hasSpareThread();
 
+    /**
+     * Returns the number of threads that are not running any job
+     * now. To use this information you should lock the context
+     * beforehand.
+     *
+     * \see lock()
+     */
+    int numSpareThreads() const;
+
     /**
      * Checks whether the walker intersects with any
      * of currently executing walkers. If it does,
@@ -65,6 +82,14 @@ public:
      */
     bool isJobAllowed(KisBaseRectsWalkerSP walker);
 
+    /**
+     * Checks whether two walkers may not be executed concurrently,
+     * that is one of them writes into the area the other one reads.
+     * The update queue uses it to keep the order of the overlapping
+     * walkers, including the parts of a split walker.
+     */
+    static bool walkersIntersect(KisBaseRectsWalkerSP lhs, KisBaseRectsWalkerSP rhs);
+
     /**
      * Registers the job and starts executing it.
      * The caller must ensure that the context is locked
@@ -126,9 +151,54 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Lets the context reduce the number of threads running the jobs
+     * at the same time, down to half of threadsLimit(), when fewer
+     * threads are measured to finish the jobs faster. Has no effect
+     * in testing mode.
+     *
+     * \see KisAdaptiveThreadCountController
+     */
+    void setAdaptiveThreadCountEnabled(bool value);
+    bool adaptiveThreadCountEnabled() const;
+
+    /**
+     * The number of threads allowed to run jobs at the moment. Without
+     * adaptive thread count it is equal to threadsLimit().
+     */
+    int activeThreadsLimit() const;
+
+    /**
+     * Reports the current size of the queues of the scheduler
+     * to the adaptive thread count controller
+     */
+    void setPendingJobs(int value);
+
+    /**
+     * Asks the running merge jobs to stop at the nearest checkpoint
+     * and return their walkers into the updates queue. The queue will
+     * not start any new merge jobs while the request is active. The
+     * strokes queue raises it when the next stroke job is blocked by
+     * the merge jobs only.
+     *
+     * \see KisAsyncMerger::startMerge()
+     */
+    void setMergePreemptionRequested(bool value);
+    bool mergePreemptionRequested() const;
+
     void continueUpdate(const QRect& rc);
     void doSomeUsefulWork();
+
+    /**
+     * Called by a job item when its job is done. Notifies the scheduler
+     * about the spare thread. When several workers finish at the same
+     * time, only one of them runs the scheduler, the others return
+     * without touching the context lock.
+     */
     void jobFinished();
+    void reportJobDuration(KisAdaptiveThreadCountController::JobType type,
+                           qint64 duration, qint64 workAmount);
+    void requeueInterruptedWalker(KisBaseRectsWalkerSP walker);
 
     void setTestingMode(bool value);
 
@@ -136,6 +206,8 @@ protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
+    int numRunningJobs() const;
+    void updateAdaptiveThreadCountState();
 
 protected:
     /**
@@ -148,10 +220,22 @@ protected:
 
     QMutex m_lock;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    KisWorkStealingExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
     KisUpdateScheduler *m_scheduler;
     bool m_testingMode = false;
+    std::atomic<bool> m_mergePreemptionRequested {false};
+
+    /**
+     * The number of finished jobs the scheduler has not been notified
+     * about yet, see jobFinished()
+     */
+    QAtomicInt m_dispatchRequests;
+
+    KisAdaptiveThreadCountController m_threadsController;
+    QElapsedTimer m_clock;
+    bool m_adaptiveThreadCountRequested = false;
+    std::atomic<bool> m_adaptiveThreadCount {false};
 
 private:
 
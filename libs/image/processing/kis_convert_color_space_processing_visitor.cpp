@@ -64,16 +64,25 @@ void KisConvertColorSpaceProcessingVisitor::visitNodeWithPaintDevice(KisNode *no
     }
 
 
-    if (layer->original()) {
-        layer->original()->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand);
-    }
+    /**
+     * For many layers some of these devices are the same object, which
+     * should be converted (and get its progress subtask) only once
+     */
+    QVector<KisPaintDeviceSP> devices;
+    auto addDevice = [&devices] (KisPaintDeviceSP device) {
+        if (device && !devices.contains(device)) {
+            devices << device;
+        }
+    };
 
-    if (layer->paintDevice()) {
-        layer->paintDevice()->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand);
-    }
+    addDevice(layer->original());
+    addDevice(layer->paintDevice());
+    addDevice(layer->projection());
+
+    ProgressHelper helper(node);
 
-    if (layer->projection()) {
-        layer->projection()->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand);
+    Q_FOREACH (KisPaintDeviceSP device, devices) {
+        device->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand, helper.updater());
     }
 
     if (layer && alphaDisabled) {
@@ -121,6 +121,69 @@ void KisAsyncMergerTest::testMerger()
     QVERIFY(TestUtil::compareQImages(pt, resultProjection, referenceProjection, 5, 0, 0));
 }
 
+void KisAsyncMergerTest::testPreemptedMerger()
+{
+    const KoColorSpace * colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 640, 441, colorSpace, "merger test");
+
+    QImage sourceImage1(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    QImage sourceImage2(QString(FILES_DATA_DIR) + '/' + "inverted_hakonepa.png");
+    QImage referenceProjection(QString(FILES_DATA_DIR) + '/' + "merged_hakonepa.png");
+
+    KisPaintDeviceSP device1 = new KisPaintDevice(colorSpace);
+    KisPaintDeviceSP device2 = new KisPaintDevice(colorSpace);
+    device1->convertFromQImage(sourceImage1, 0, 0, 0);
+    device2->convertFromQImage(sourceImage2, 0, 0, 0);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+    Q_ASSERT(filter);
+    KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(configuration);
+
+    KisLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8, device1);
+    KisLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8, device2);
+    KisLayerSP groupLayer = new KisGroupLayer(image, "group", 200/*OPACITY_OPAQUE*/);
+    KisLayerSP blur1 = new KisAdjustmentLayer(image, "blur1", configuration->cloneWithResourcesSnapshot(), 0);
+
+    image->addNode(paintLayer1, image->rootLayer());
+    image->addNode(groupLayer, image->rootLayer());
+
+    image->addNode(paintLayer2, groupLayer);
+    image->addNode(blur1, groupLayer);
+
+    QVector<QRect> testRects;
+    testRects << QRect(0,0,100,441);
+    testRects << QRect(100,0,400,441);
+    testRects << QRect(500,0,140,441);
+    testRects << QRect(580,381,40,40);
+
+    QRect cropRect(image->bounds());
+
+    KisMergeWalker walker(cropRect);
+    KisAsyncMerger merger;
+
+    std::atomic<bool> preemptionRequested(true);
+
+    Q_FOREACH (const QRect &rc, testRects) {
+        walker.collectRects(paintLayer2, rc);
+
+        int numInterruptions = 0;
+
+        while (!merger.startMerge(walker, true, &preemptionRequested)) {
+            QVERIFY(walker.mergeInterrupted());
+            QVERIFY(!walker.leafStack().isEmpty());
+            numInterruptions++;
+        }
+
+        // the group's projection is a checkpoint
+        QVERIFY(numInterruptions > 0);
+        QVERIFY(!walker.mergeInterrupted());
+    }
+
+    QImage resultProjection = image->rootLayer()->projection()->convertToQImage(0);
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt, resultProjection, referenceProjection, 5, 0, 0));
+}
 
 /**
  * This in not fully automated test for child obliging in KisAsyncMerger.
@@ -19,6 +19,7 @@
 #include "kis_paint_layer.h"
 #include "kis_types.h"
 #include "kis_image.h"
+#include "kis_image_config.h"
 #include <KisGlobalResourcesInterface.h>
 
 
@@ -98,4 +99,79 @@ void KisFilterMaskTest::testProjectionSelected()
 
 }
 
+namespace {
+/**
+ * Enables the result cache while the guard is alive, so that a failed
+ * check doesn't leave it enabled for the other tests
+ */
+struct FilterMaskResultCacheGuard
+{
+    FilterMaskResultCacheGuard()
+        : m_oldValue(KisImageConfig(true).useFilterMaskResultCache())
+    {
+        KisImageConfig(false).setUseFilterMaskResultCache(true);
+    }
+
+    ~FilterMaskResultCacheGuard()
+    {
+        KisImageConfig(false).setUseFilterMaskResultCache(m_oldValue);
+    }
+
+private:
+    bool m_oldValue;
+};
+}
+
+void KisFilterMaskTest::testResultCache()
+{
+    FilterMaskResultCacheGuard cacheGuard;
+
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+    KisPaintDeviceSP projection = layer->paintDevice();
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    QImage inverted(QString(FILES_DATA_DIR) + '/' + "inverted_hakonepa.png");
+    projection->convertFromQImage(qimage, 0, 0, 0);
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+    Q_ASSERT(f);
+    KisFilterConfigurationSP  kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    image->addNode(mask, layer);
+
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    mask->createNodeProgressProxy();
+
+    mask->initSelection(layer);
+    mask->select(qimage.rect(), MAX_SELECTED);
+    mask->apply(projection, qimage.rect(), qimage.rect(), KisNode::N_FILTHY);
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint, inverted, projection->convertToQImage(0, 0, 0, qimage.width(), qimage.height())));
+
+    /**
+     * When only the masks above have changed, the input is considered
+     * to be the same, so the cached result is used. We feed a different
+     * input to check that the filter is really not rerun.
+     */
+    projection->convertFromQImage(inverted, 0, 0, 0);
+    mask->apply(projection, qimage.rect(), qimage.rect(), KisNode::N_BELOW_FILTHY);
+    QVERIFY(TestUtil::compareQImages(errpoint, inverted, projection->convertToQImage(0, 0, 0, qimage.width(), qimage.height())));
+
+    // the input has changed, the filter is rerun
+    projection->convertFromQImage(inverted, 0, 0, 0);
+    mask->apply(projection, qimage.rect(), qimage.rect(), KisNode::N_ABOVE_FILTHY);
+    QVERIFY(TestUtil::compareQImages(errpoint, qimage, projection->convertToQImage(0, 0, 0, qimage.width(), qimage.height())));
+
+    // the cache is dropped when the filter changes
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    projection->convertFromQImage(qimage, 0, 0, 0);
+    mask->apply(projection, qimage.rect(), qimage.rect(), KisNode::N_BELOW_FILTHY);
+    QVERIFY(TestUtil::compareQImages(errpoint, inverted, projection->convertToQImage(0, 0, 0, qimage.width(), qimage.height())));
+}
+
 SIMPLE_TEST_MAIN(KisFilterMaskTest)
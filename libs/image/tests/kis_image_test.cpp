@@ -11,6 +11,7 @@
 
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColor.h>
 
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
@@ -72,6 +73,7 @@ void KisImageTest::benchmarkCreation()
 
 #include <testutil.h>
 #include "kis_stroke_strategy.h"
+#include "KisAsyncBarrierStrokeStrategy.h"
 #include <functional>
 
 
@@ -164,6 +166,54 @@ void KisImageTest::testBlockLevelOfDetail()
     }
 }
 
+void KisImageTest::testRunBarrierAsync()
+{
+    TestUtil::MaskParent p;
+    p.image->initialRefreshGraph();
+
+    const QRect rc(10, 10, 100, 100);
+    const KoColor red(Qt::red, p.image->colorSpace());
+
+    p.layer->paintDevice()->fill(rc, red);
+    p.layer->setDirty(rc);
+
+    QAtomicInt exclusiveCalls;
+    bool projectionUpdated = false;
+    bool exclusiveCalledInGuiThread = true;
+    int guiCalls = 0;
+    bool guiCalledInGuiThread = false;
+
+    p.image->runBarrierAsync(
+        [&] () {
+            // the pending update must be processed before the barrier
+            KoColor color;
+            p.image->projection()->pixel(rc.center().x(), rc.center().y(), &color);
+            projectionUpdated = color == red;
+            exclusiveCalledInGuiThread = QThread::currentThread() == qApp->thread();
+            exclusiveCalls.ref();
+        },
+        [&] () {
+            guiCalledInGuiThread = QThread::currentThread() == qApp->thread();
+            guiCalls++;
+        });
+
+    p.image->waitForDone();
+
+    QCOMPARE(int(exclusiveCalls), 1);
+    QVERIFY(projectionUpdated);
+    QVERIFY(!exclusiveCalledInGuiThread);
+
+    // the GUI callback is delivered via the event loop
+    QCoreApplication::processEvents();
+
+    QCOMPARE(guiCalls, 1);
+    QVERIFY(guiCalledInGuiThread);
+
+    // the barrier should not end the user's stroke, like barrierLock() doesn't
+    KisAsyncBarrierStrokeStrategy strategy([] () {});
+    QVERIFY(!strategy.requestsOtherStrokesToEnd());
+}
+
 void KisImageTest::testConvertImageColorSpace()
 {
     const KoColorSpace *cs8 = KoColorSpaceRegistry::instance()->rgb8();
@@ -19,6 +19,7 @@ private Q_SLOTS:
     void layerTests();
     void benchmarkCreation();
     void testBlockLevelOfDetail();
+    void testRunBarrierAsync();
     void testConvertImageColorSpace();
     void testAssignImageProfile();
     void testGlobalSelection();
@@ -283,6 +283,40 @@ void KisPaintDeviceTest::testColorSpaceConversion()
     delete cmd;
 }
 
+void KisPaintDeviceTest::testColorSpaceConversionMultiplePatches()
+{
+    QImage image(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    const KoColorSpace* srcCs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace* dstCs = KoColorSpaceRegistry::instance()->lab16();
+    KisPaintDeviceSP dev = new KisPaintDevice(srcCs);
+    dev->convertFromQImage(image, 0);
+    dev->moveTo(10, 10);   // Unalign with tile boundaries
+
+    const QRect rc = dev->exactBounds();
+
+    // the device is converted in several patches in parallel
+    QVERIFY(rc.width() > 256 && rc.height() > 256);
+
+    QVector<quint8> expectedData(rc.width() * rc.height() * dstCs->pixelSize());
+    {
+        QVector<quint8> srcData(rc.width() * rc.height() * srcCs->pixelSize());
+        dev->readBytes(srcData.data(), rc);
+        srcCs->convertPixelsTo(srcData.data(), expectedData.data(), dstCs, rc.width() * rc.height(),
+                               KoColorConversionTransformation::internalRenderingIntent(),
+                               KoColorConversionTransformation::internalConversionFlags());
+    }
+
+    dev->convertTo(dstCs);
+
+    QCOMPARE(dev->exactBounds(), rc);
+    QVERIFY(*dev->colorSpace() == *dstCs);
+
+    QVector<quint8> resultData(rc.width() * rc.height() * dstCs->pixelSize());
+    dev->readBytes(resultData.data(), rc);
+
+    QVERIFY(resultData == expectedData);
+}
+
 
 void KisPaintDeviceTest::testRoundtripConversion()
 {
@@ -1456,7 +1490,7 @@ void syncLodCache(KisPaintDeviceSP dev, int levelOfDetail)
 {
     KisPaintDevice::LodDataStruct* s = dev->createLodDataStruct(levelOfDetail);
 
-    KisRegion region = dev->regionForLodSyncing();
+    KisRegion region = dev->regionForLodSyncing(levelOfDetail);
     Q_FOREACH(QRect rect2, KritaUtils::splitRegionIntoPatches(region, KritaUtils::optimalPatchSize())) {
         dev->updateLodDataStruct(s, rect2);
     }
@@ -1528,6 +1562,109 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+void KisPaintDeviceTest::testLodDeviceIncrementalSync()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(QRect(0,0,512,512));
+    dev->setDefaultBounds(bounds);
+
+    fillGradientDevice(dev, QRect(0,0,512,512));
+
+    bounds->testingSetLevelOfDetail(1);
+    QCOMPARE(dev->regionForLodSyncing(1).boundingRect(), QRect(0,0,512,512));
+    syncLodCache(dev, 1);
+
+    // nothing has changed since the last sync
+    QVERIFY(dev->regionForLodSyncing(1).isEmpty());
+
+    // change the source device
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(100,100,10,10), KoColor(Qt::blue, cs));
+
+    // change the lod plane, e.g. as a lodN stroke does
+    bounds->testingSetLevelOfDetail(1);
+    dev->fill(QRect(130,130,4,4), KoColor(Qt::green, cs));
+
+    QRegion expectedRegion;
+    expectedRegion += QRect(64,64,64,64);
+    expectedRegion += QRect(256,256,128,128);
+    QCOMPARE(dev->regionForLodSyncing(1).toQRegion(), expectedRegion);
+
+    // switching to another level of detail needs a full sync
+    QCOMPARE(dev->regionForLodSyncing(2).boundingRect(), QRect(0,0,512,512));
+
+    syncLodCache(dev, 1);
+    QVERIFY(dev->regionForLodSyncing(1).isEmpty());
+
+    // the result should be the same as the one of a full sync
+    bounds->testingSetLevelOfDetail(0);
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    refDev->makeCloneFrom(dev, dev->extent());
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(refDev, 1);
+
+    QImage result = dev->convertToQImage(0,0,0,256,256);
+    QImage reference = refDev->convertToQImage(0,0,0,256,256);
+    QCOMPARE(result, reference);
+}
+
+void KisPaintDeviceTest::testLodDeviceIncrementalSyncChangeWhileSyncing()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(QRect(0,0,512,512));
+    dev->setDefaultBounds(bounds);
+
+    fillGradientDevice(dev, QRect(0,0,512,512));
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(100,100,10,10), KoColor(Qt::blue, cs));
+
+    bounds->testingSetLevelOfDetail(1);
+    KisPaintDevice::LodDataStruct* s = dev->createLodDataStruct(1);
+    KisRegion region = dev->regionForLodSyncing(1);
+    QCOMPARE(region.boundingRect(), QRect(64,64,64,64));
+
+    // the source device is changed after the region has been calculated
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(300,300,10,10), KoColor(Qt::red, cs));
+
+    bounds->testingSetLevelOfDetail(1);
+    Q_FOREACH(QRect rect, KritaUtils::splitRegionIntoPatches(region, KritaUtils::optimalPatchSize())) {
+        dev->updateLodDataStruct(s, rect);
+    }
+    dev->uploadLodDataStruct(s);
+    delete s;
+
+    // the late change should not be lost
+    QCOMPARE(dev->regionForLodSyncing(1).boundingRect(), QRect(256,256,64,64));
+}
+
+void KisPaintDeviceTest::testLodDeviceIncrementalSyncProjection()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setProjectionDevice(true);
+
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(QRect(0,0,512,512));
+    dev->setDefaultBounds(bounds);
+
+    fillGradientDevice(dev, QRect(0,0,512,512));
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    // projections keep no snapshots, so they are always synced completely
+    QCOMPARE(dev->regionForLodSyncing(1).boundingRect(), QRect(0,0,512,512));
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -32,6 +32,7 @@ private Q_SLOTS:
     void testMakeClone();
     void testBltPerformance();
     void testColorSpaceConversion();
+    void testColorSpaceConversionMultiplePatches();
     void testDeviceDuplication();
     void testTranslate();
     void testOpacity();
@@ -53,6 +54,9 @@ private Q_SLOTS:
 
     void testLodTransform();
     void testLodDevice();
+    void testLodDeviceIncrementalSync();
+    void testLodDeviceIncrementalSyncChangeWhileSyncing();
+    void testLodDeviceIncrementalSyncProjection();
     void benchmarkLod1Generation();
     void benchmarkLod2Generation();
     void benchmarkLod3Generation();
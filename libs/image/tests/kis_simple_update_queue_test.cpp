@@ -140,6 +140,80 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testSplitForSpareThreads()
+{
+    KisTestableUpdaterContext context(4);
+
+    QRect imageRect(0,0,1024,300);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, imageRect, imageRect, 0);
+
+    // the rect is not higher than the patch, so it is not split on adding
+    QCOMPARE(walkersList.size(), 1);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+
+    QCOMPARE(jobs.size(), 4);
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,256,300)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(256,0,256,300)));
+    QVERIFY(checkWalker(jobs[2]->walker(), QRect(512,0,256,300)));
+    QVERIFY(checkWalker(jobs[3]->walker(), QRect(768,0,256,300)));
+
+    QVERIFY(walkersList.isEmpty());
+}
+
+void KisSimpleUpdateQueueTest::testVisibleRectPriority()
+{
+    KisTestableUpdaterContext context(1);
+
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect offscreenRect(0,0,64,64);
+    QRect visibleRect(512,512,64,64);
+
+    KisTestableSimpleUpdateQueue queue;
+    queue.setVisibleRect(QRect(448,448,256,256));
+
+    queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+    queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), visibleRect));
+
+    context.clear();
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), offscreenRect));
+
+    QVERIFY(queue.getWalkersList().isEmpty());
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
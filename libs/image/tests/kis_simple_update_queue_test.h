@@ -21,6 +21,8 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testSplitForSpareThreads();
+    void testVisibleRectPriority();
     void testChecksum();
     void testMixingTypes();
     void testSpontaneousJobsCompression();
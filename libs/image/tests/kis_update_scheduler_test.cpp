@@ -171,8 +171,18 @@ void KisUpdateSchedulerTest::testLocking()
 
     jobs = context->getJobs();
     QCOMPARE(jobs[0]->isRunning(), true);
-    QCOMPARE(jobs[1]->isRunning(), false);
-    QVERIFY(checkWalker(jobs[0]->walker(), imageRect));
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,320,441)));
+
+    /**
+     * The update is split into tile-aligned parts, because
+     * there is a spare thread. The parts overlapping with the
+     * running ones (due to the blur) are left in the queue,
+     * so let them finish before checking the locking.
+     */
+    do {
+        context->clear();
+        scheduler.processQueues();
+    } while (scheduler.hasUpdatesRunning());
 
     context->clear();
 
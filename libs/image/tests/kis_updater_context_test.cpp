@@ -10,6 +10,10 @@
 #include "kistest.h"
 
 #include <QAtomicInt>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
@@ -18,10 +22,14 @@
 #include "kis_merge_walker.h"
 #include "kis_updater_context.h"
 #include "kis_image.h"
+#include "KisWorkStealingExecutor.h"
+#include "KisSchedulerTracer.h"
+#include "KisAdaptiveThreadCountController.h"
 
 #include "scheduler_utils.h"
 
 #include "lod_override.h"
+#include "job_burst_testing_utils.h"
 #include "config-limit-long-tests.h"
 
 void KisUpdaterContextTest::testJobInterference()
@@ -235,5 +243,198 @@ void KisUpdaterContextTest::stressTestExclusiveJobs()
              << "/" << NUM_CHECKS * NUM_JOBS;
 }
 
+void KisUpdaterContextTest::testWorkStealingExecutor()
+{
+    const int NUM_BURSTS = 100;
+    const int NUM_CHILDREN = 16;
+
+    KisWorkStealingExecutor executor;
+    QAtomicInt counter;
+
+    for (int threads = 1; threads <= 4; threads++) {
+        counter = 0;
+        executor.setMaxThreadCount(threads);
+        QCOMPARE(executor.maxThreadCount(), threads);
+
+        for (int i = 0; i < NUM_BURSTS; i++) {
+            executor.start(new TestUtil::BurstRunnable<KisWorkStealingExecutor>(&executor, counter, NUM_CHILDREN));
+        }
+
+        executor.waitForDone();
+        QCOMPARE(counter.loadAcquire(), NUM_BURSTS * (NUM_CHILDREN + 1));
+    }
+}
+
+
+void KisUpdaterContextTest::testSchedulerTracer()
+{
+    QRect imageRect(0,0,100,100);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "tracer test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    tracer->clear();
+    tracer->setEnabled(true);
+
+    paintLayer->setDirty(QRect(10,10,50,50));
+    image->waitForDone();
+
+    image->barrierLock();
+    image->unlock();
+
+    tracer->addInstantEvent(KisSchedulerTracer::LodSync, "instant");
+
+    tracer->setEnabled(false);
+
+    // the disabled tracer records nothing
+    tracer->addInstantEvent(KisSchedulerTracer::LodSync, "skipped");
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "scheduler_trace.json";
+    QVERIFY(tracer->exportChromeTrace(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    const QJsonArray events =
+        QJsonDocument::fromJson(file.readAll()).object()["traceEvents"].toArray();
+
+    int numMergeEvents = 0;
+    int numBarrierEvents = 0;
+    int numInstantEvents = 0;
+
+    Q_FOREACH (const QJsonValue &value, events) {
+        const QJsonObject event = value.toObject();
+        const QString category = event["cat"].toString();
+
+        QVERIFY(event["name"].toString() != "skipped");
+
+        if (category == "merge") {
+            QCOMPARE(event["ph"].toString(), QString("X"));
+            QVERIFY(event["dur"].toDouble() >= 0);
+            QVERIFY(event["args"].toObject().contains("width"));
+            numMergeEvents++;
+        } else if (category == "barrier") {
+            numBarrierEvents++;
+        } else if (category == "lod" && event["name"].toString() == "instant") {
+            QCOMPARE(event["ph"].toString(), QString("i"));
+            numInstantEvents++;
+        }
+    }
+
+    QVERIFY(numMergeEvents > 0);
+    QVERIFY(numBarrierEvents > 0);
+    QCOMPARE(numInstantEvents, 1);
+}
+
+namespace {
+/**
+ * Emulates \p numJobs jobs of \p type of \p duration ns each executed
+ * by \p numThreads fully busy threads
+ */
+void feedJobs(KisAdaptiveThreadCountController &controller,
+              KisAdaptiveThreadCountController::JobType type,
+              int numJobs, qint64 duration, int numThreads, qint64 &timestamp,
+              qint64 workAmount = 1)
+{
+    for (int i = 0; i < numJobs; i++) {
+        timestamp += duration / numThreads;
+        controller.reportJobFinished(type, duration, workAmount, timestamp);
+    }
+}
+}
+
+void KisUpdaterContextTest::testAdaptiveThreadCount()
+{
+    const qint64 ms = 1000000;
+    const int windowJobs = 32;
+    const auto stroke = KisAdaptiveThreadCountController::StrokeJob;
+    const auto merge = KisAdaptiveThreadCountController::MergeJob;
+
+    qint64 timestamp = 0;
+
+    KisAdaptiveThreadCountController controller(8);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    // the controller starts with all the threads
+    controller.setEnabled(true);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    // no backlog, no reason to probe
+    controller.setPendingJobs(0);
+    feedJobs(controller, stroke, 2 * windowJobs, 40 * ms, 8, timestamp);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    // the threads are busy and the queue is full, try fewer threads
+    controller.setPendingJobs(20);
+    feedJobs(controller, stroke, windowJobs, 40 * ms, 8, timestamp);
+    QCOMPARE(controller.activeThreads(), 6);
+
+    // the jobs are not faster with fewer threads, return them
+    feedJobs(controller, stroke, windowJobs, 40 * ms, 6, timestamp);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    // don't try again right after the failed probe
+    feedJobs(controller, stroke, 20 * windowJobs, 40 * ms, 8, timestamp);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    feedJobs(controller, stroke, windowJobs, 40 * ms, 8, timestamp);
+    QCOMPARE(controller.activeThreads(), 6);
+
+    // the jobs became twice as fast, the threads were competing
+    feedJobs(controller, stroke, windowJobs, 20 * ms, 6, timestamp);
+    QCOMPARE(controller.activeThreads(), 6);
+
+    // removing one more thread doesn't help
+    feedJobs(controller, stroke, windowJobs, 20 * ms, 6, timestamp);
+    QCOMPARE(controller.activeThreads(), 5);
+
+    feedJobs(controller, stroke, windowJobs, 20 * ms, 5, timestamp);
+    QCOMPARE(controller.activeThreads(), 6);
+
+    // after idle period all the threads are returned
+    timestamp += 2000 * ms;
+    feedJobs(controller, stroke, 1, 20 * ms, 8, timestamp);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    controller.setEnabled(false);
+    QCOMPARE(controller.activeThreads(), 8);
+
+    // only the jobs of the same type are compared
+    KisAdaptiveThreadCountController mixedController(8);
+    mixedController.setEnabled(true);
+    mixedController.setPendingJobs(20);
+    timestamp = 0;
+
+    feedJobs(mixedController, merge, windowJobs, 40 * ms, 8, timestamp, 1000);
+    QCOMPARE(mixedController.activeThreads(), 6);
+
+    // the long stroke jobs inflate the average duration of a job, but
+    // the merge jobs became faster, so the probe is kept
+    feedJobs(mixedController, merge, windowJobs / 2, 10 * ms, 6, timestamp, 1000);
+    feedJobs(mixedController, stroke, windowJobs / 2, 100 * ms, 6, timestamp);
+    QCOMPARE(mixedController.activeThreads(), 6);
+
+    feedJobs(mixedController, merge, windowJobs, 10 * ms, 6, timestamp, 1000);
+    QCOMPARE(mixedController.activeThreads(), 5);
+
+    // the merge jobs processing bigger areas take longer, but their
+    // cost per pixel is the same, so the thread is returned
+    feedJobs(mixedController, merge, windowJobs, 50 * ms, 5, timestamp, 5000);
+    QCOMPARE(mixedController.activeThreads(), 6);
+
+    // the testing context doesn't adapt the number of threads
+    KisTestableUpdaterContext context(4);
+    context.setAdaptiveThreadCountEnabled(true);
+    QVERIFY(!context.adaptiveThreadCountEnabled());
+    QCOMPARE(context.activeThreadsLimit(), 4);
+}
+
 KISTEST_MAIN(KisUpdaterContextTest)
 
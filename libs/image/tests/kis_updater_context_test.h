@@ -17,6 +17,9 @@ private Q_SLOTS:
     void testJobInterference();
     void testSnapshot();
     void stressTestExclusiveJobs();
+    void testWorkStealingExecutor();
+    void testSchedulerTracer();
+    void testAdaptiveThreadCount();
 };
 
 #endif /* KIS_UPDATER_CONTEXT_TEST_H */
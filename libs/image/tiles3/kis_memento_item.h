@@ -7,6 +7,7 @@
 #ifndef KIS_MEMENTO_ITEM_H_
 #define KIS_MEMENTO_ITEM_H_
 
+#include <QMutex>
 #include <kis_shared.h>
 #include <kis_shared_ptr.h>
 #include "kis_tile.h"
@@ -30,18 +31,30 @@ public:
 
     KisMementoItem(const KisMementoItem& rhs)
             : KisShared(),
-            m_tileData(rhs.m_tileData),
+            m_tileData(0),
             m_committedFlag(rhs.m_committedFlag),
             m_type(rhs.m_type),
             m_col(rhs.m_col),
             m_row(rhs.m_row),
             m_next(0),
             m_parent(0) {
+        QMutexLocker locker(&rhs.m_journalLock);
+
+        m_tileData = !rhs.m_journaled ?
+            rhs.m_tileData : readFromJournal(rhs.m_journalRecord);
+
         if (m_tileData) {
-            if (m_committedFlag)
+            if (m_committedFlag) {
+                /**
+                 * The same as in commit(), releaseTileData()
+                 * will drop the memento flag
+                 */
                 m_tileData->acquire();
-            else
+                m_tileData->setMementoed(true);
+            }
+            else {
                 m_tileData->ref();
+            }
         }
     }
 
@@ -72,7 +85,9 @@ public:
      */
     KisMementoItem(const KisMementoItem &rhs, KisMementoManager *mm) {
         Q_UNUSED(mm);
-        m_tileData = rhs.m_tileData;
+        QMutexLocker locker(&rhs.m_journalLock);
+        m_tileData = !rhs.m_journaled ?
+            rhs.m_tileData : readFromJournal(rhs.m_journalRecord);
         /* Setting counter: m_refCount++ */
         m_tileData->ref();
         m_col = rhs.m_col;
@@ -101,6 +116,7 @@ public:
 
 
     void reset() {
+        QMutexLocker locker(&m_journalLock);
         releaseTileData();
         m_tileData = 0;
         m_committedFlag = false;
@@ -141,7 +157,45 @@ public:
         m_committedFlag = true;
     }
 
+    /**
+     * Moves the tile data of a committed item into the undo journal
+     * and releases it. Only the tile datas that are not used by
+     * anyone else are moved, otherwise no memory would be freed.
+     * The data is loaded back by tile() when the item is needed
+     * for undo or redo.
+     *
+     * Called by the journal in a background thread.
+     */
+    void moveToJournal() {
+        QMutexLocker locker(&m_journalLock);
+
+        if (!m_committedFlag || m_journaled ||
+            !m_tileData || m_type != CHANGED ||
+            !m_tileData->historical()) {
+
+            return;
+        }
+
+        KisMementoJournal *journal = KisTileDataStore::instance()->mementoJournal();
+
+        if (journal->writeTileData(m_tileData, m_journalRecord)) {
+            releaseTileData();
+            m_tileData = 0;
+            m_journaled = true;
+        }
+    }
+
+    inline bool isJournaled() const {
+        QMutexLocker locker(&m_journalLock);
+        return m_journaled;
+    }
+
     inline KisTileSP tile(KisMementoManager *mm) {
+        QMutexLocker locker(&m_journalLock);
+
+        if (m_journaled) {
+            loadFromJournal();
+        }
         Q_ASSERT(m_tileData);
         return KisTileSP(new KisTile(m_col, m_row, m_tileData, mm));
     }
@@ -194,7 +248,43 @@ public:
     }
 
 protected:
+    /**
+     * Reads the tile data back from the journal. If the journal
+     * cannot be read (e.g. the disk has failed), we cannot do anything
+     * but continue with a tile filled with zeroes, the rest of the
+     * undo step will still be applied correctly.
+     */
+    static KisTileData* readFromJournal(const KisMementoJournal::Record &record) {
+        KisTileDataStore *store = KisTileDataStore::instance();
+        KisTileData *td = store->mementoJournal()->readTileData(record);
+
+        if (!td) {
+            warnKrita << "WARNING: failed to read a tile from the undo journal, the tile will be restored empty";
+
+            const QByteArray defaultPixel(record.pixelSize, 0);
+            td = store->createDefaultTileData(record.pixelSize, (const quint8*) defaultPixel.constData());
+        }
+
+        return td;
+    }
+
+    void loadFromJournal() {
+        KisTileData *td = readFromJournal(m_journalRecord);
+
+        KisTileDataStore::instance()->mementoJournal()->forgetRecord(m_journalRecord);
+        m_journaled = false;
+
+        m_tileData = td;
+        m_tileData->acquire();
+        m_tileData->setMementoed(true);
+    }
+
     void releaseTileData() {
+        if (m_journaled) {
+            KisTileDataStore::instance()->mementoJournal()->forgetRecord(m_journalRecord);
+            m_journaled = false;
+        }
+
         if (m_tileData) {
             if (m_committedFlag) {
                 m_tileData->setMementoed(false);
@@ -216,6 +306,14 @@ protected:
 
     KisMementoItemSP m_next;
     KisMementoItemSP m_parent;
+
+    /**
+     * Guards m_tileData, m_journaled and m_journalRecord against
+     * the journal moving the item in the background
+     */
+    mutable QMutex m_journalLock;
+    bool m_journaled {false};
+    KisMementoJournal::Record m_journalRecord;
 private:
 };
 
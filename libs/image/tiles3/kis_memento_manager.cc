@@ -5,6 +5,7 @@
  */
 
 #include <QtGlobal>
+#include <QSet>
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
 
@@ -55,6 +56,12 @@
  *       is purged.
  */
 
+/**
+ * The maximum number of revisions merged into a single one
+ * by compactHistory()
+ */
+const int MAX_MERGED_REVISIONS = 8;
+
 #define blockRegistration() (m_registrationBlocked = true)
 #define unblockRegistration() (m_registrationBlocked = false)
 #define registrationBlocked() (m_registrationBlocked)
@@ -64,7 +71,11 @@
 KisMementoManager::KisMementoManager()
     : m_index(0),
       m_headsHashTable(0),
-      m_registrationBlocked(false)
+      m_registrationBlocked(false),
+      m_currentTransactionTick(0),
+      m_currentCommandTick(0),
+      m_memoryOwner(0),
+      m_lowMemoryPriority(false)
 {
     /**
      * Tile change/delete registration is enabled for all
@@ -78,7 +89,11 @@ KisMementoManager::KisMementoManager(const KisMementoManager& rhs)
         m_cancelledRevisions(rhs.m_cancelledRevisions),
         m_headsHashTable(rhs.m_headsHashTable, 0),
         m_currentMemento(rhs.m_currentMemento),
-        m_registrationBlocked(rhs.m_registrationBlocked)
+        m_registrationBlocked(rhs.m_registrationBlocked),
+        m_currentTransactionTick(rhs.m_currentTransactionTick),
+        m_currentCommandTick(rhs.m_currentCommandTick),
+        m_memoryOwner(rhs.m_memoryOwner),
+        m_lowMemoryPriority(rhs.m_lowMemoryPriority)
 {
     Q_ASSERT_X(!m_registrationBlocked,
                "KisMementoManager", "(impossible happened) "
@@ -161,6 +176,23 @@ void KisMementoManager::registerTileDeleted(KisTile *tile)
     }
 }
 
+QVector<QPoint> KisMementoManager::changedTiles()
+{
+    QVector<QPoint> tiles;
+
+    KisMementoItemHashTableIteratorConst iter(&m_index);
+    KisMementoItemSP mi;
+
+    while ((mi = iter.tile())) {
+        if (mi->type() == KisMementoItem::CHANGED) {
+            tiles.append(QPoint(mi->col(), mi->row()));
+        }
+        iter.next();
+    }
+
+    return tiles;
+}
+
 void KisMementoManager::commit()
 {
     if (m_index.isEmpty()) {
@@ -199,11 +231,20 @@ void KisMementoManager::commit()
     KisHistoryItem hItem;
     hItem.itemList = revisionList;
     hItem.memento = m_currentMemento.data();
+
+    if (namedTransactionInProgress()) {
+        hItem.transactionTick = m_currentTransactionTick;
+        hItem.commandTick = m_currentCommandTick;
+    }
+
     m_revisions.append(hItem);
 
     m_currentMemento = 0;
     KIS_ASSERT(m_index.isEmpty());
 
+    compactHistory();
+    moveHistoryToJournal();
+
     DEBUG_DUMP_MESSAGE("COMMIT_DONE");
 
     // Waking up pooler to prepare copies for us
@@ -247,6 +288,10 @@ KisMementoSP KisMementoManager::getMemento()
     commit();
     m_currentMemento = new KisMemento(this);
 
+    KisTileDataStore *store = KisTileDataStore::instance();
+    m_currentTransactionTick = store->tickHistoryTransactionClock();
+    m_currentCommandTick = store->historyCommandClock();
+
     DEBUG_LOG_SIMPLE_ACTION("GET_MEMENTO_DONE");
 
     return m_currentMemento;
@@ -264,6 +309,16 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
 {
     commit();
 
+    /**
+     * The memento has been merged into a newer revision, which
+     * has already been rolled back
+     */
+    if (!m_cancelledRevisions.isEmpty() &&
+        m_cancelledRevisions.first().mergedMementos.contains(memento.data())) {
+
+        return;
+    }
+
     if (! m_revisions.size()) return;
 
     KisHistoryItem changeList = m_revisions.takeLast();
@@ -310,6 +365,9 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
     m_currentMemento = 0;
     KIS_ASSERT(!namedTransactionInProgress());
 
+    // the rolled back tiles have been loaded from the journal
+    changeList.journaled = false;
+
     m_cancelledRevisions.prepend(changeList);
     DEBUG_DUMP_MESSAGE("UNDONE");
 
@@ -323,6 +381,12 @@ void KisMementoManager::rollforward(KisTileHashTable *ht, KisMementoSP memento)
 
     if (!m_cancelledRevisions.size()) return;
 
+    /**
+     * The memento has been merged into a newer revision, so its
+     * changes will be redone together with that revision
+     */
+    if (m_cancelledRevisions.first().mergedMementos.contains(memento.data())) return;
+
     KisHistoryItem changeList = m_cancelledRevisions.takeFirst();
 
     // SANITY CHECK: the transaction's memento must be in sync with
@@ -343,6 +407,8 @@ void KisMementoManager::rollforward(KisTileHashTable *ht, KisMementoSP memento)
     // see comment in rollback()
 
     m_currentMemento = changeList.memento;
+    m_currentTransactionTick = changeList.transactionTick;
+    m_currentCommandTick = changeList.commandTick;
     commit();
     unblockRegistration();
     DEBUG_DUMP_MESSAGE("REDONE");
@@ -362,7 +428,7 @@ void KisMementoManager::purgeHistory(KisMementoSP oldestMemento)
         m_revisions.removeFirst();
     }
 
-    KIS_ASSERT(m_revisions.first().memento == oldestMemento);
+    KIS_ASSERT(findRevisionByMemento(oldestMemento) == 0);
     resetRevisionHistory(m_revisions.first().itemList);
 
     DEBUG_DUMP_MESSAGE("PURGE_HISTORY");
@@ -372,7 +438,9 @@ qint32 KisMementoManager::findRevisionByMemento(KisMementoSP memento) const
 {
     qint32 index = -1;
     for(qint32 i = 0; i < m_revisions.size(); i++) {
-        if (m_revisions[i].memento == memento) {
+        if (m_revisions[i].memento == memento ||
+            m_revisions[i].mergedMementos.contains(memento.data())) {
+
             index = i;
             break;
         }
@@ -396,12 +464,134 @@ void KisMementoManager::resetRevisionHistory(KisMementoItemList list)
     }
 }
 
+void KisMementoManager::compactHistory()
+{
+    const int depth = KisTileDataStore::instance()->historyCompactionDepth();
+    if (depth <= 0) return;
+
+    /**
+     * Every commit moves exactly one revision out of the recent
+     * part of the history, so we need to check this one only
+     */
+    const int index = m_revisions.size() - depth - 1;
+    if (index < 1) return;
+
+    KisHistoryItem &older = m_revisions[index - 1];
+    const KisHistoryItem &newer = m_revisions[index];
+
+    /**
+     * The undo history is global for the image. If any other device
+     * started a transaction between the two revisions, or more than
+     * one command has been added to the undo stack (the older one's
+     * own), then undoing the merged revision would revert this device
+     * past the other commands, which would still stay applied.
+     */
+    if (!older.transactionTick || !newer.transactionTick) return;
+    if (newer.transactionTick != older.transactionTick + 1) return;
+    if (newer.commandTick - older.commandTick > 1) return;
+
+    if (older.mergedMementos.size() + newer.mergedMementos.size() + 2 > MAX_MERGED_REVISIONS) return;
+
+    mergeRevisions(older, newer);
+    m_revisions.removeAt(index);
+
+    DEBUG_DUMP_MESSAGE("COMPACT_HISTORY");
+}
+
+void KisMementoManager::mergeRevisions(KisHistoryItem &older, const KisHistoryItem &newer)
+{
+    QSet<KisMementoItem*> olderItems;
+    QSet<KisMementoItem*> overwrittenItems;
+    KisMementoItemSP mi;
+
+    Q_FOREACH (mi, older.itemList) {
+        olderItems.insert(mi.data());
+
+        /**
+         * Undoing the merged revision touches the tiles
+         * of both revisions
+         */
+        if (newer.memento) {
+            newer.memento->updateExtent(mi->col(), mi->row());
+        }
+    }
+
+    /**
+     * If a tile has been changed in both revisions, the newer item
+     * inherits the parent of the older one, and the intermediate
+     * version of the tile is dropped
+     */
+    Q_FOREACH (mi, newer.itemList) {
+        KisMementoItemSP parentMI = mi->parent();
+
+        if (parentMI && parentMI->parent() &&
+            olderItems.contains(parentMI.data())) {
+
+            mi->setParent(parentMI->parent());
+            overwrittenItems.insert(parentMI.data());
+        }
+    }
+
+    KisMementoItemList mergedList;
+    Q_FOREACH (mi, older.itemList) {
+        if (!overwrittenItems.contains(mi.data())) {
+            mergedList.append(mi);
+        }
+    }
+    mergedList.append(newer.itemList);
+
+    if (older.memento) {
+        older.mergedMementos.append(older.memento);
+    }
+    older.mergedMementos.append(newer.mergedMementos);
+
+    older.itemList = mergedList;
+    older.memento = newer.memento;
+    older.transactionTick = newer.transactionTick;
+    older.commandTick = newer.commandTick;
+    older.journaled = older.journaled && newer.journaled;
+}
+
+void KisMementoManager::moveHistoryToJournal()
+{
+    const int depth = KisTileDataStore::instance()->historyJournalDepth();
+    if (depth <= 0) return;
+
+    /**
+     * Usually only one revision leaves the recent part of the
+     * history per commit, but the compaction and undo/redo
+     * might leave a few more revisions for us.
+     *
+     * The writing itself happens in the background, we are called
+     * from commit() with the data manager locked.
+     */
+    QVector<KisMementoItemSP> items;
+
+    for (int i = m_revisions.size() - depth - 1; i >= 0; i--) {
+        KisHistoryItem &item = m_revisions[i];
+        if (item.journaled) break;
+
+        Q_FOREACH (KisMementoItemSP mi, item.itemList) {
+            items.append(mi);
+        }
+        item.journaled = true;
+    }
+
+    KisTileDataStore::instance()->mementoJournal()->scheduleItems(items);
+}
+
 void KisMementoManager::setDefaultTileData(KisTileData *defaultTileData)
 {
     m_headsHashTable.setDefaultTileData(defaultTileData);
     m_index.setDefaultTileData(defaultTileData);
 }
 
+void KisMementoManager::setMemoryOwner(int owner, bool lowPriority)
+{
+    m_memoryOwner = owner;
+    m_lowMemoryPriority = lowPriority;
+}
+
 void KisMementoManager::debugPrintInfo()
 {
     printf("KisMementoManager stats:\n");
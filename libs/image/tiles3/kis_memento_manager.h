@@ -8,6 +8,8 @@
 #define KIS_MEMENTO_MANAGER_
 
 #include <QList>
+#include <QVector>
+#include <QPoint>
 
 #include "kis_memento_item.h"
 #include "config-hash-table-implementation.h"
@@ -19,6 +21,30 @@ class KisMemento;
 struct KisHistoryItem {
     KisMemento* memento;
     KisMementoItemList itemList;
+
+    /**
+     * Mementos of the older revisions that have been merged
+     * into this one by KisMementoManager::compactHistory()
+     */
+    QVector<KisMemento*> mergedMementos;
+
+    /**
+     * Set when the revision has been passed to the undo journal,
+     * see KisMementoManager::moveHistoryToJournal(). The items
+     * are moved into the journal in the background, so some of
+     * them might be still in memory.
+     */
+    bool journaled {false};
+
+    /**
+     * The values of the global history clocks when the transaction
+     * of the newest merged revision was started. Zero for anonymous
+     * transactions.
+     *
+     * \see KisTileDataStore::tickHistoryTransactionClock()
+     */
+    int transactionTick {0};
+    int commandTick {0};
 };
 
 typedef QList<KisHistoryItem> KisHistoryList;
@@ -69,6 +95,12 @@ public:
     void registerTileDeleted(KisTile *tile);
 
 
+    /**
+     * Returns coordinates of the tiles that have been changed (not
+     * deleted) since the last commit, that is present in the INDEX
+     */
+    QVector<QPoint> changedTiles();
+
     /**
      * Commits changes, made in  INDEX: appends m_index into m_revisions list
      * and owes all modified tileDatas.
@@ -102,6 +134,22 @@ public:
 
     void setDefaultTileData(KisTileData *defaultTileData);
 
+    /**
+     * The memory owner and priority that the tiles of the manager
+     * assign to the tile datas they create on copy-on-write.
+     *
+     * \see KisTiledDataManager::setMemoryOwner()
+     */
+    void setMemoryOwner(int owner, bool lowPriority);
+
+    inline int memoryOwner() const {
+        return m_memoryOwner;
+    }
+
+    inline bool lowMemoryPriority() const {
+        return m_lowMemoryPriority;
+    }
+
     void debugPrintInfo();
 
 
@@ -117,6 +165,30 @@ protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
 
+    /**
+     * Merges the revision that has just left the recent part of
+     * the history into its older neighbour. The tile versions
+     * that were overwritten by the newer revision are released.
+     * Undoing any of the merged mementos, except the newest one,
+     * becomes a no-op.
+     *
+     * The undo history is global for the image, so the revisions
+     * are merged only when no other command (on this or any other
+     * device) has been done between them.
+     *
+     * \see KisTileDataStore::historyCompactionDepth()
+     */
+    void compactHistory();
+    static void mergeRevisions(KisHistoryItem &older, const KisHistoryItem &newer);
+
+    /**
+     * Schedules moving the tiles of the revisions that are older
+     * than KisTileDataStore::historyJournalDepth() into the undo
+     * journal. The tiles are loaded back lazily, when the
+     * revision is rolled back or forward.
+     */
+    void moveHistoryToJournal();
+
 protected:
     /**
      * INDEX of tiles to be committed with next commit()
@@ -157,6 +229,15 @@ protected:
      * \see rollforward()
      */
     bool m_registrationBlocked;
+
+    /**
+     * The history clocks at the start of the current named transaction
+     */
+    int m_currentTransactionTick;
+    int m_currentCommandTick;
+
+    int m_memoryOwner;
+    bool m_lowMemoryPriority;
 };
 
 #endif /* KIS_MEMENTO_MANAGER_ */
@@ -12,13 +12,56 @@
 #include "kis_memento_manager.h"
 #include "kis_debug.h"
 
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace {
+/**
+ * \see KisTile::m_lockCounter
+ */
+const int BARRIER_FLAG = 1 << 30;
+
+/**
+ * Set by the threads that went to sleep waiting for the barrier to be
+ * lifted. Can be set only together with BARRIER_FLAG.
+ */
+const int WAITERS_FLAG = 1 << 29;
+
+/**
+ * The number of iterations a thread spins waiting for the barrier
+ * before going to sleep. The barrier is usually lifted very quickly,
+ * unless the tile data is being loaded from swap.
+ */
+const int BARRIER_SPIN_COUNT = 64;
+
+/**
+ * The threads waiting for the barrier sleep on a wait condition picked
+ * by the address of the tile. The tiles are too numerous to have a
+ * wait condition each, and the collisions only cause spurious wakeups.
+ */
+struct BarrierWaitStripe
+{
+    QMutex mutex;
+    QWaitCondition condition;
+};
+
+const int NUM_BARRIER_WAIT_STRIPES = 64;
+BarrierWaitStripe s_barrierWaitStripes[NUM_BARRIER_WAIT_STRIPES];
+
+inline BarrierWaitStripe& barrierWaitStripe(const void *tile)
+{
+    const quintptr key = reinterpret_cast<quintptr>(tile);
+    return s_barrierWaitStripes[(key >> 6) % NUM_BARRIER_WAIT_STRIPES];
+}
+}
 
 void KisTile::init(qint32 col, qint32 row,
                    KisTileData *defaultTileData, KisMementoManager* mm)
 {
     m_col = col;
     m_row = row;
-    m_lockCounter = 0;
+    m_lockCounter.storeRelease(0);
 
     m_extent = QRect(m_col * KisTileData::WIDTH, m_row * KisTileData::HEIGHT,
                      KisTileData::WIDTH, KisTileData::HEIGHT);
@@ -59,7 +102,7 @@ KisTile::KisTile(const KisTile& rhs)
 KisTile::~KisTile()
 {
 #ifdef DEAD_TILES_SANITY_CHECK
-    KIS_ASSERT(!m_lockCounter);
+    KIS_ASSERT(!m_lockCounter.loadAcquire());
 
     /**
      * We should have been disconnected from the memento manager in
@@ -154,54 +197,120 @@ void KisTile::notifyAttachedToDataManager(KisMementoManager *mm)
 #define DEBUG_COWING(newTD)
 #endif
 
+void KisTile::waitForBarrier(int spinCount) const
+{
+    if (spinCount < BARRIER_SPIN_COUNT) {
+        QThread::yieldCurrentThread();
+        return;
+    }
+
+    BarrierWaitStripe &stripe = barrierWaitStripe(this);
+    QMutexLocker locker(&stripe.mutex);
+
+    while (true) {
+        const int value = m_lockCounter.loadAcquire();
+        if (!(value & BARRIER_FLAG)) break;
+
+        if ((value & WAITERS_FLAG) ||
+            m_lockCounter.testAndSetOrdered(value, value | WAITERS_FLAG)) {
+
+            stripe.condition.wait(&stripe.mutex);
+        }
+    }
+}
+
+inline void KisTile::liftBarrier(int newValue) const
+{
+    const int oldValue = m_lockCounter.fetchAndStoreOrdered(newValue);
+    Q_ASSERT(oldValue & BARRIER_FLAG);
+
+    if (oldValue & WAITERS_FLAG) {
+        BarrierWaitStripe &stripe = barrierWaitStripe(this);
+        QMutexLocker locker(&stripe.mutex);
+        stripe.condition.wakeAll();
+    }
+}
+
 inline void KisTile::blockSwapping() const
 {
     /**
-     * We need to hold a specal barrier lock here to ensure
-     * m_tileData->blockSwapping() has finished executing
-     * before anyone started reading the tile data. That is
-     * why we can not use atomic operations here.
+     * We need to ensure m_tileData->blockSwapping() has finished
+     * executing before anyone started reading the tile data. So the
+     * first locker sets the barrier flag, which makes the others wait
+     * until the data is loaded. When the tile is already locked by
+     * someone, its data is resident and we just join them without
+     * taking any locks.
      */
 
-    QMutexLocker locker(&m_swapBarrierLock);
-    Q_ASSERT(m_lockCounter >= 0);
+    int spinCount = 0;
+
+    while (true) {
+        const int value = m_lockCounter.loadAcquire();
+        Q_ASSERT(value >= 0);
 
-    if(!m_lockCounter++)
-        m_tileData->blockSwapping();
+        if (value & BARRIER_FLAG) {
+            waitForBarrier(spinCount++);
+            continue;
+        }
+
+        if (value > 0) {
+            if (m_lockCounter.testAndSetOrdered(value, value + 1)) break;
+        } else if (m_lockCounter.testAndSetOrdered(0, BARRIER_FLAG)) {
+            m_tileData->blockSwapping();
+            liftBarrier(1);
+            break;
+        }
+    }
 
     Q_ASSERT(data());
 }
 
 inline void KisTile::unblockSwapping() const
 {
-    QMutexLocker locker(&m_swapBarrierLock);
-    Q_ASSERT(m_lockCounter > 0);
+    int spinCount = 0;
 
-    if(--m_lockCounter == 0) {
-        m_tileData->unblockSwapping();
+    while (true) {
+        const int value = m_lockCounter.loadAcquire();
+        Q_ASSERT(value > 0);
+
+        if (value & BARRIER_FLAG) {
+            waitForBarrier(spinCount++);
+            continue;
+        }
 
-        if(!m_oldTileData.isEmpty()) {
-            Q_FOREACH (KisTileData *td, m_oldTileData) {
-                td->unblockSwapping();
-                td->release();
+        if (value > 1) {
+            if (m_lockCounter.testAndSetOrdered(value, value - 1)) break;
+        } else if (m_lockCounter.testAndSetOrdered(1, BARRIER_FLAG)) {
+            m_tileData->unblockSwapping();
+
+            /**
+             * We are the last user of the tile, so no one can do
+             * COW and push to the stack concurrently
+             */
+            if(!m_oldTileData.isEmpty()) {
+                Q_FOREACH (KisTileData *td, m_oldTileData) {
+                    td->unblockSwapping();
+                    td->release();
+                }
+                m_oldTileData.clear();
             }
-            m_oldTileData.clear();
+
+            liftBarrier(0);
+            break;
         }
     }
 }
 
 inline void KisTile::safeReleaseOldTileData(KisTileData *td)
 {
-    QMutexLocker locker(&m_swapBarrierLock);
-    Q_ASSERT(m_lockCounter >= 0);
-
-    if(m_lockCounter > 0) {
-        m_oldTileData.push(td);
-    }
-    else {
-        td->unblockSwapping();
-        td->release();
-    }
+    /**
+     * The caller holds the tile locked, so the counter cannot drop to
+     * zero until it unlocks it. The old tile data will be released by
+     * the last unlocker in unblockSwapping(). Concurrent pushes are
+     * serialized by m_COWMutex.
+     */
+    Q_ASSERT(m_lockCounter.loadAcquire() > 0);
+    m_oldTileData.push(td);
 }
 
 void KisTile::lockForRead() const
@@ -247,6 +356,7 @@ void KisTile::lockForWrite()
 
             KisMementoManager *mm = m_mementoManager.load();
             if (mm) {
+                tileData->setMemoryOwner(mm->memoryOwner(), mm->lowMemoryPriority());
                 mm->registerTileChange(this);
             }
         }
@@ -282,6 +392,44 @@ void KisTile::unlockForRead() const
 #endif
 }
 
+bool KisTile::tryShareTileData(KisTileData *td)
+{
+    QMutexLocker cowLocker(&m_COWMutex);
+
+    if (td == m_tileData) return true;
+
+    td->acquire();
+    td->blockSwapping();
+
+    /**
+     * We can replace the data only when the caller is the only user
+     * of the tile, otherwise someone might be writing into the old
+     * tile data right now. The barrier flag makes newcomers wait
+     * until the replacement is finished.
+     */
+    if (!m_lockCounter.testAndSetOrdered(1, 1 | BARRIER_FLAG)) {
+        td->unblockSwapping();
+        td->release();
+        return false;
+    }
+
+    /**
+     * The caller still holds the lock, so the old tile data
+     * will be released on the last unlock
+     */
+    m_oldTileData.push(m_tileData);
+    m_tileData = td;
+
+    liftBarrier(1);
+
+    KisMementoManager *mm = m_mementoManager.load();
+    if (mm) {
+        mm->registerTileChange(this);
+    }
+
+    DEBUG_LOG_ACTION("share");
+    return true;
+}
 
 #include <stdio.h>
 void KisTile::debugPrintInfo()
@@ -310,12 +458,12 @@ void KisTile::debugDumpTile()
 
 void KisTile::sanityCheckIsNotDestroyedYet()
 {
-    if (m_lockCounter) {
+    if (m_lockCounter.loadAcquire()) {
         qDebug() << this << ppVar(m_sanityLockedForRead);
         qDebug() << this << ppVar(m_sanityLockedForWrite);
-        qDebug() << this << ppVar(m_lockCounter);
+        qDebug() << this << ppVar(m_lockCounter.loadAcquire());
 
-        KIS_ASSERT(!m_lockCounter || !m_sanityLockedForWrite && "sanityCheckIsNotDestroyedYet() failed");
+        KIS_ASSERT(!m_lockCounter.loadAcquire() || !m_sanityLockedForWrite && "sanityCheckIsNotDestroyedYet() failed");
     }
 }
 
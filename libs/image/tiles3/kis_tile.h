@@ -11,6 +11,7 @@
 
 #include <QMutex>
 #include <QAtomicPointer>
+#include <QAtomicInt>
 
 #include <QRect>
 #include <QStack>
@@ -80,6 +81,19 @@ public:
     void unlockForWrite();
     void unlockForRead() const;
 
+    /**
+     * Replaces the tile data of the tile with \p td, which must have
+     * exactly the same content as the current one. It is used for
+     * sharing identical tile datas between the tiles.
+     *
+     * PRECONDITIONS: the caller holds the tile locked for read
+     *
+     * The replacement happens only if no one else has the tile locked
+     * at the moment, otherwise the function returns false and the
+     * tile is left untouched.
+     */
+    bool tryShareTileData(KisTileData *td);
+
 
     /* this allows us work directly on tile's data */
     inline quint8 *data() const {
@@ -126,12 +140,33 @@ private:
     inline void blockSwapping() const;
     inline void unblockSwapping() const;
 
+    /**
+     * Waits until the barrier is lifted. Spins for a short while
+     * first, then goes to sleep until the barrier owner wakes it up
+     * in liftBarrier().
+     */
+    void waitForBarrier(int spinCount) const;
+    inline void liftBarrier(int newValue) const;
+
     inline void safeReleaseOldTileData(KisTileData *td);
 
 private:
     KisTileData *m_tileData;
     mutable QStack<KisTileData*> m_oldTileData;
-    mutable volatile int m_lockCounter;
+
+    /**
+     * The number of users holding the tile locked. While it is
+     * non-zero, m_tileData is guaranteed to be blocked from swapping,
+     * so joining the existing users is a single atomic operation.
+     *
+     * The BARRIER_FLAG bit is set while the first locker is blocking
+     * the tile data (which may need loading it from swap), while the
+     * last unlocker is unblocking it, or while the tile data is being
+     * replaced by tryShareTileData(). Everyone else waits until the
+     * bit is cleared. The waiters that went to sleep set WAITERS_FLAG,
+     * so that the barrier owner knew it should wake them up.
+     */
+    mutable QAtomicInt m_lockCounter;
 
     qint32 m_col;
     qint32 m_row;
@@ -156,11 +191,6 @@ private:
      */
     QMutex m_COWMutex;
 
-    /**
-     * This lock is used to ensure no one will read the tile data
-     * before it has been loaded from to the memory.
-     */
-    mutable QMutex m_swapBarrierLock;
 
 
 #ifdef DEAD_TILES_SANITY_CHECK
@@ -54,6 +54,11 @@ inline bool KisTileData::acquire() {
 
 inline bool KisTileData::release() {
     m_usersCount.deref();
+
+    if (m_deduplicatedUsersCount.loadAcquire() > 0) {
+        m_store->notifyDeduplicatedUserReleased(this);
+    }
+
     bool _ref = deref();
     return _ref;
 }
@@ -107,6 +112,17 @@ inline bool KisTileData::historical() const {
     return mementoed() && numUsers() <= 1;
 }
 
+inline int KisTileData::memoryOwner() const {
+    return m_memoryOwner;
+}
+inline bool KisTileData::lowMemoryPriority() const {
+    return m_lowMemoryPriority;
+}
+inline void KisTileData::setMemoryOwner(int owner, bool lowPriority) {
+    m_memoryOwner = owner;
+    m_lowMemoryPriority = lowPriority;
+}
+
 inline int KisTileData::age() const {
     return m_age;
 }
@@ -0,0 +1,394 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_allocator.h"
+
+#include <stdlib.h>
+
+#include <QGlobalStatic>
+#include <QThreadStorage>
+#include <QMutex>
+#include <QVector>
+#include <QSet>
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+#include "kis_lockless_stack.h"
+#include "kis_tile_data_interface.h"
+
+Q_GLOBAL_STATIC(KisTileDataAllocator, s_instance)
+
+const qint32 KisTileDataAllocator::MAX_POOLED_PIXEL_SIZE = 64;
+const qint32 KisTileDataAllocator::SLAB_SIZE = 2 * 1024 * 1024;
+
+namespace {
+
+/**
+ * The amount of memory a thread may keep in its cache for a single
+ * pixel size. The cache of at least two chunks is always allowed, so
+ * that a COW of a single tile would never go to the global stack.
+ */
+const qint32 THREAD_CACHE_BYTES = 1024 * 1024;
+const qint32 MAX_THREAD_CACHE_CHUNKS = 32;
+
+inline qint32 chunkSize(qint32 pixelSize)
+{
+    return pixelSize * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT;
+}
+
+inline qint32 threadCacheCapacity(qint32 pixelSize)
+{
+    return qBound(2, THREAD_CACHE_BYTES / chunkSize(pixelSize), MAX_THREAD_CACHE_CHUNKS);
+}
+
+quint8* allocateSlab()
+{
+    const size_t size = KisTileDataAllocator::SLAB_SIZE;
+
+#ifdef Q_OS_LINUX
+    /**
+     * Align the slab to the huge page boundary, otherwise the kernel
+     * will not be able to back it with a huge page
+     */
+    void *ptr = 0;
+    if (posix_memalign(&ptr, size, size)) {
+        return 0;
+    }
+
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+
+    return static_cast<quint8*>(ptr);
+#else
+    return static_cast<quint8*>(malloc(size));
+#endif
+}
+
+}
+
+/**
+ * The thread caches are destroyed on thread exit, which may happen
+ * after the allocator has been destroyed on application shutdown. The
+ * caches share this guard with the allocator and return their chunks
+ * only while it is still alive.
+ */
+struct KisTileDataAllocator::LifetimeGuard
+{
+    QMutex lock;
+    bool isAlive {true};
+};
+
+struct KisTileDataAllocator::ThreadCache
+{
+    ThreadCache(KisTileDataAllocator *_allocator, int _generation,
+                QSharedPointer<LifetimeGuard> _lifetimeGuard)
+        : allocator(_allocator),
+          generation(_generation),
+          lifetimeGuard(_lifetimeGuard),
+          chunks(MAX_POOLED_PIXEL_SIZE + 1)
+    {
+    }
+
+    ~ThreadCache();
+
+    KisTileDataAllocator *allocator;
+    int generation;
+    QSharedPointer<LifetimeGuard> lifetimeGuard;
+    QVector<QVector<quint8*>> chunks;
+};
+
+struct KisTileDataAllocator::Private
+{
+    struct Pool {
+        KisLocklessStack<quint8*> freeChunks;
+        QMutex slabsLock;
+        QVector<quint8*> slabs;
+    };
+
+    Private()
+        : pools(MAX_POOLED_PIXEL_SIZE + 1),
+          lifetimeGuard(new LifetimeGuard),
+          generation(0),
+          totalSlabsSize(0),
+          numFallbackChunks(0)
+    {
+        for (int i = 1; i < pools.size(); i++) {
+            pools[i] = new Pool();
+        }
+    }
+
+    ~Private()
+    {
+        Q_FOREACH (Pool *pool, pools) {
+            if (!pool) continue;
+
+            Q_FOREACH (quint8 *slab, pool->slabs) {
+                ::free(slab);
+            }
+            delete pool;
+        }
+
+        Q_FOREACH (quint8 *chunk, fallbackChunks) {
+            ::free(chunk);
+        }
+    }
+
+    QVector<Pool*> pools;
+    QThreadStorage<ThreadCache*> threadCaches;
+    QSharedPointer<LifetimeGuard> lifetimeGuard;
+
+    /**
+     * Incremented on every purgeMemory(). The thread caches with an
+     * older generation point to the slabs that do not exist anymore
+     * and are dropped on the next access.
+     */
+    QAtomicInt generation;
+    QAtomicInteger<qint64> totalSlabsSize;
+
+    /**
+     * The chunks allocated with malloc() when the system failed to
+     * give us a new slab. They never get into the pools and the
+     * thread caches and are returned to the system directly.
+     */
+    QSet<quint8*> fallbackChunks;
+    QMutex fallbackChunksLock;
+    QAtomicInt numFallbackChunks;
+
+    ThreadCache* threadCache(KisTileDataAllocator *q);
+    quint8* allocateFromNewSlab(qint32 pixelSize, QVector<quint8*> &cache);
+    quint8* allocateFallbackChunk(qint32 pixelSize);
+    bool tryFreeFallbackChunk(quint8 *ptr);
+};
+
+KisTileDataAllocator::ThreadCache::~ThreadCache()
+{
+    QMutexLocker locker(&lifetimeGuard->lock);
+
+    if (!lifetimeGuard->isAlive) return;
+    if (generation != allocator->m_d->generation.loadAcquire()) return;
+
+    for (int pixelSize = 1; pixelSize < chunks.size(); pixelSize++) {
+        Private::Pool *pool = allocator->m_d->pools[pixelSize];
+
+        Q_FOREACH (quint8 *ptr, chunks[pixelSize]) {
+            pool->freeChunks.push(ptr);
+        }
+    }
+}
+
+KisTileDataAllocator::ThreadCache* KisTileDataAllocator::Private::threadCache(KisTileDataAllocator *q)
+{
+    const int currentGeneration = generation.loadAcquire();
+
+    ThreadCache *cache = threadCaches.localData();
+
+    if (!cache) {
+        cache = new ThreadCache(q, currentGeneration, lifetimeGuard);
+        threadCaches.setLocalData(cache);
+    } else if (cache->generation != currentGeneration) {
+        for (int i = 0; i < cache->chunks.size(); i++) {
+            cache->chunks[i].clear();
+        }
+        cache->generation = currentGeneration;
+    }
+
+    return cache;
+}
+
+quint8* KisTileDataAllocator::Private::allocateFromNewSlab(qint32 pixelSize, QVector<quint8*> &cache)
+{
+    Pool *pool = pools[pixelSize];
+    QMutexLocker locker(&pool->slabsLock);
+
+    /**
+     * Someone could have refilled the pool while we were waiting
+     * for the lock
+     */
+    quint8 *ptr = 0;
+    if (pool->freeChunks.pop(ptr)) {
+        return ptr;
+    }
+
+    quint8 *slab = allocateSlab();
+    if (!slab) {
+        return allocateFallbackChunk(pixelSize);
+    }
+
+    pool->slabs.append(slab);
+    totalSlabsSize.fetchAndAddOrdered(SLAB_SIZE);
+
+    const qint32 size = chunkSize(pixelSize);
+    const qint32 numChunks = SLAB_SIZE / size;
+    const qint32 cacheCapacity = threadCacheCapacity(pixelSize);
+
+    ptr = slab;
+
+    for (qint32 i = 1; i < numChunks; i++) {
+        quint8 *chunk = slab + i * size;
+
+        if (cache.size() < cacheCapacity / 2) {
+            cache.append(chunk);
+        } else {
+            pool->freeChunks.push(chunk);
+        }
+    }
+
+    return ptr;
+}
+
+quint8* KisTileDataAllocator::Private::allocateFallbackChunk(qint32 pixelSize)
+{
+    quint8 *ptr = static_cast<quint8*>(malloc(chunkSize(pixelSize)));
+    if (!ptr) return 0;
+
+    QMutexLocker locker(&fallbackChunksLock);
+    fallbackChunks.insert(ptr);
+    numFallbackChunks.ref();
+
+    return ptr;
+}
+
+bool KisTileDataAllocator::Private::tryFreeFallbackChunk(quint8 *ptr)
+{
+    if (!numFallbackChunks.loadAcquire()) return false;
+
+    QMutexLocker locker(&fallbackChunksLock);
+    if (!fallbackChunks.remove(ptr)) return false;
+
+    numFallbackChunks.deref();
+    ::free(ptr);
+
+    return true;
+}
+
+KisTileDataAllocator::KisTileDataAllocator()
+    : m_d(new Private)
+{
+}
+
+KisTileDataAllocator::~KisTileDataAllocator()
+{
+    QMutexLocker locker(&m_d->lifetimeGuard->lock);
+    m_d->lifetimeGuard->isAlive = false;
+}
+
+KisTileDataAllocator* KisTileDataAllocator::instance()
+{
+    return s_instance;
+}
+
+bool KisTileDataAllocator::isPooled(qint32 pixelSize)
+{
+    return pixelSize > 0 && pixelSize <= MAX_POOLED_PIXEL_SIZE;
+}
+
+quint8* KisTileDataAllocator::allocate(qint32 pixelSize)
+{
+    if (!isPooled(pixelSize)) {
+        return static_cast<quint8*>(malloc(chunkSize(pixelSize)));
+    }
+
+    ThreadCache *threadCache = m_d->threadCache(this);
+    QVector<quint8*> &cache = threadCache->chunks[pixelSize];
+
+    if (!cache.isEmpty()) {
+        return cache.takeLast();
+    }
+
+    /**
+     * The thread cache is empty, so take a few chunks from the global
+     * stack at once to avoid hammering it on every allocation
+     */
+    Private::Pool *pool = m_d->pools[pixelSize];
+    const qint32 refillSize = threadCacheCapacity(pixelSize) / 2;
+
+    quint8 *ptr = 0;
+    if (pool->freeChunks.pop(ptr)) {
+        quint8 *extraChunk = 0;
+        while (cache.size() < refillSize - 1 && pool->freeChunks.pop(extraChunk)) {
+            cache.append(extraChunk);
+        }
+        return ptr;
+    }
+
+    return m_d->allocateFromNewSlab(pixelSize, cache);
+}
+
+void KisTileDataAllocator::free(quint8 *ptr, qint32 pixelSize)
+{
+    if (!isPooled(pixelSize)) {
+        ::free(ptr);
+        return;
+    }
+
+    if (m_d->tryFreeFallbackChunk(ptr)) {
+        return;
+    }
+
+    ThreadCache *threadCache = m_d->threadCache(this);
+    QVector<quint8*> &cache = threadCache->chunks[pixelSize];
+
+    const qint32 capacity = threadCacheCapacity(pixelSize);
+
+    if (cache.size() < capacity) {
+        cache.append(ptr);
+        return;
+    }
+
+    /**
+     * The thread cache is full, which means this thread mostly frees
+     * memory, so pass half of the cache to the threads that allocate
+     */
+    Private::Pool *pool = m_d->pools[pixelSize];
+    pool->freeChunks.push(ptr);
+
+    while (cache.size() > capacity / 2) {
+        pool->freeChunks.push(cache.takeLast());
+    }
+}
+
+void KisTileDataAllocator::purgeMemory()
+{
+    m_d->generation.ref();
+
+    for (int pixelSize = 1; pixelSize < m_d->pools.size(); pixelSize++) {
+        Private::Pool *pool = m_d->pools[pixelSize];
+        QMutexLocker locker(&pool->slabsLock);
+
+        pool->freeChunks.clear();
+
+        Q_FOREACH (quint8 *slab, pool->slabs) {
+            ::free(slab);
+        }
+        pool->slabs.clear();
+    }
+
+    /**
+     * The callers move the data of the alive tiles away before the
+     * purge, so the fallback chunks become invalid as well
+     */
+    {
+        QMutexLocker locker(&m_d->fallbackChunksLock);
+
+        Q_FOREACH (quint8 *chunk, m_d->fallbackChunks) {
+            ::free(chunk);
+        }
+        m_d->fallbackChunks.clear();
+        m_d->numFallbackChunks.storeRelease(0);
+    }
+
+    m_d->totalSlabsSize.storeRelease(0);
+}
+
+qint64 KisTileDataAllocator::totalSlabsSize() const
+{
+    return m_d->totalSlabsSize.loadAcquire();
+}
@@ -0,0 +1,77 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_DATA_ALLOCATOR_H
+#define __KIS_TILE_DATA_ALLOCATOR_H
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+
+/**
+ * The allocator for the pixel buffers of KisTileData.
+ *
+ * The memory is requested from the system in big slabs, which are cut
+ * into the chunks of a tile size. Every pixel size up to
+ * MAX_POOLED_PIXEL_SIZE has its own pool, larger tiles are allocated
+ * with malloc() directly.
+ *
+ * Every thread keeps a small cache of free chunks for each pixel size,
+ * so the threads of the updater context don't contend on a shared
+ * lock when doing copy-on-write. When the thread cache is empty or
+ * full, the chunks are moved from/to a global lockless stack. The
+ * slabs are allocated by the thread that needs them, which (thanks to
+ * the first-touch policy) keeps them on its NUMA node.
+ *
+ * On Linux the slabs are aligned to the size of a huge page and
+ * advised to be backed by transparent huge pages, which reduces TLB
+ * pressure when iterating over big images.
+ */
+class KRITAIMAGE_EXPORT KisTileDataAllocator
+{
+public:
+    static const qint32 MAX_POOLED_PIXEL_SIZE;
+    static const qint32 SLAB_SIZE;
+
+public:
+    KisTileDataAllocator();
+    ~KisTileDataAllocator();
+
+    static KisTileDataAllocator* instance();
+
+    quint8* allocate(qint32 pixelSize);
+    void free(quint8 *ptr, qint32 pixelSize);
+
+    /**
+     * Returns true if the tiles of \p pixelSize are allocated from
+     * the pools, that is their memory will be lost on purgeMemory()
+     */
+    static bool isPooled(qint32 pixelSize);
+
+    /**
+     * Returns all the slabs to the system. All the chunks allocated
+     * from the pools become invalid, so the caller should move the
+     * data of the alive tiles away beforehand.
+     *
+     * \see KisTileData::releaseInternalPools()
+     */
+    void purgeMemory();
+
+    /**
+     * The amount of memory requested from the system for the pools
+     */
+    qint64 totalSlabsSize() const;
+
+private:
+    struct LifetimeGuard;
+    struct ThreadCache;
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_TILE_DATA_ALLOCATOR_H */
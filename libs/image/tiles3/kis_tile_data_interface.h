@@ -31,57 +31,6 @@ typedef KisTileDataList::iterator KisTileDataListIterator;
 typedef KisTileDataList::const_iterator KisTileDataListConstIterator;
 
 
-class SimpleCache
-{
-public:
-    SimpleCache() = default;
-    ~SimpleCache();
-
-    bool push(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            m_4Pool.push(ptr);
-            break;
-        case 8:
-            m_8Pool.push(ptr);
-            break;
-        case 16:
-            m_16Pool.push(ptr);
-            break;
-        default:
-            return false;
-        }
-
-        return true;
-    }
-
-    bool pop(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            return m_4Pool.pop(ptr);
-        case 8:
-            return m_8Pool.pop(ptr);
-        case 16:
-            return m_16Pool.pop(ptr);
-        default:
-            return false;
-        }
-    }
-
-    void clear();
-
-private:
-    QReadWriteLock m_cacheLock;
-    KisLocklessStack<quint8*> m_4Pool;
-    KisLocklessStack<quint8*> m_8Pool;
-    KisLocklessStack<quint8*> m_16Pool;
-};
-
-
 /**
  * Stores actual tile's data
  */
@@ -159,6 +108,15 @@ public:
     inline bool mementoed() const;
     inline void setMementoed(bool value);
 
+    /**
+     * The document the tile data belongs to and whether it belongs
+     * to an invisible layer. Used by the swapper to choose the
+     * victims, see KisTileDataStore::registerMemoryOwner()
+     */
+    inline int memoryOwner() const;
+    inline bool lowMemoryPriority() const;
+    inline void setMemoryOwner(int owner, bool lowPriority);
+
     /**
      * Controlling methods for setting 'age' marks
      */
@@ -201,7 +159,7 @@ public:
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
-     * glibc directly, but use pools (implemented via boost) to
+     * glibc directly, but use pools (see KisTileDataAllocator) to
      * allocate bigger chunks. This method should be called when one
      * knows that we have just free'd quite a lot of memory and we
      * won't need it anymore. E.g. when a document has been closed.
@@ -262,6 +220,33 @@ private:
      */
     qint32 m_mementoFlag;
 
+    /**
+     * The hash of the tile data content, calculated by the pooler
+     * for the immutable (mementoed) tile datas when content-addressed
+     * deduplication is enabled. Guarded by
+     * KisTileDataStore::m_contentHashLock.
+     *
+     * \see KisTileDataStore::refAndFetchTileDataByHash()
+     */
+    uint m_contentHash;
+    bool m_contentHashed;
+    bool m_contentHashRegistered;
+
+    /**
+     * The number of users that were switched to this tile data by
+     * deduplication and still use it. Each of them saves a copy of the
+     * tile data, which is reported in the memory statistics.
+     *
+     * \see KisTileDataStore::notifyTileDataDeduplicated()
+     */
+    QAtomicInt m_deduplicatedUsersCount;
+
+    /**
+     * Zero means the tile data doesn't belong to any document
+     */
+    int m_memoryOwner;
+    bool m_lowMemoryPriority;
+
     /**
      * Counts up time after last access to the tile data.
      * 0 - recently accessed
@@ -305,7 +290,6 @@ private:
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
-    static SimpleCache m_cache;
 
 public:
     static const qint32 WIDTH;
@@ -6,6 +6,7 @@
 
 
 #include <stdio.h>
+#include <limits>
 #include "kis_tile_data.h"
 #include "kis_tile_data_store.h"
 #include "kis_tile_data_store_iterators.h"
@@ -18,6 +19,7 @@ const qint32 KisTileDataPooler::MAX_NUM_CLONES = 16;
 const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
+const qint32 KisTileDataPooler::MAX_HASHES_PER_CYCLE = 256;
 
 //#define DEBUG_POOLER
 
@@ -187,12 +189,14 @@ void KisTileDataPooler::run()
 
         qint32 statRealMemory;
         qint32 statHistoricalMemory;
+        QHash<int, qint64> statOwnersMemory;
 
 
         getLists(iter, beggers, donors,
                  memoryOccupied,
                  statRealMemory,
-                 statHistoricalMemory);
+                 statHistoricalMemory,
+                 statOwnersMemory);
 
         m_lastCycleHadWork =
             processLists(beggers, donors, memoryOccupied);
@@ -201,8 +205,19 @@ void KisTileDataPooler::run()
         m_lastRealMemoryMetric = statRealMemory;
         m_lastHistoricalMemoryMetric = statHistoricalMemory;
 
+        {
+            QMutexLocker l(&m_ownersMemoryLock);
+            m_lastOwnersMemoryMetric.swap(statOwnersMemory);
+        }
+
         m_store->endIteration(iter);
 
+        if (m_store->deduplicationEnabled()) {
+            KisTileDataStoreIterator *hashIter = m_store->beginIteration();
+            m_lastCycleHadWork |= hashTileDatas(hashIter, MAX_HASHES_PER_CYCLE);
+            m_store->endIteration(hashIter);
+        }
+
         DEBUG_TILE_STATISTICS();
         DEBUG_SIMPLE_ACTION("cycle finished");
     }
@@ -219,20 +234,65 @@ void KisTileDataPooler::forceUpdateMemoryStats()
 
     qint32 statRealMemory;
     qint32 statHistoricalMemory;
+    QHash<int, qint64> statOwnersMemory;
 
 
     getLists(iter, beggers, donors,
              memoryOccupied,
              statRealMemory,
-             statHistoricalMemory);
+             statHistoricalMemory,
+             statOwnersMemory);
 
     m_lastPoolMemoryMetric = memoryOccupied;
     m_lastRealMemoryMetric = statRealMemory;
     m_lastHistoricalMemoryMetric = statHistoricalMemory;
 
+    {
+        QMutexLocker l(&m_ownersMemoryLock);
+        m_lastOwnersMemoryMetric.swap(statOwnersMemory);
+    }
+
     m_store->endIteration(iter);
 }
 
+void KisTileDataPooler::forceHashTileDatas()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!isRunning());
+
+    KisTileDataStoreIterator *iter = m_store->beginIteration();
+    hashTileDatas(iter, std::numeric_limits<qint32>::max());
+    m_store->endIteration(iter);
+}
+
+template<class Iter>
+bool KisTileDataPooler::hashTileDatas(Iter *iter, qint32 maxHashes)
+{
+    KisTileData *item;
+
+    while(iter->hasNext()) {
+        item = iter->next();
+
+        /**
+         * Only mementoed tile datas are guaranteed to stay unchanged
+         * after hashing. We hold the iterator lock, so the swapped-out
+         * tile datas cannot be loaded meanwhile. They are skipped,
+         * there is no point in loading them just for hashing.
+         */
+        if (item->m_contentHashed || !item->mementoed() || !item->data()) {
+            continue;
+        }
+
+        if (!maxHashes--) {
+            return true;
+        }
+
+        m_store->registerContentHash(item,
+            KisTileDataStore::calculateContentHash(item->data(), item->pixelSize()));
+    }
+
+    return false;
+}
+
 qint64 KisTileDataPooler::lastPoolMemoryMetric() const
 {
     return m_lastPoolMemoryMetric;
@@ -248,6 +308,12 @@ qint64 KisTileDataPooler::lastHistoricalMemoryMetric() const
     return m_lastHistoricalMemoryMetric;
 }
 
+QHash<int, qint64> KisTileDataPooler::lastOwnersMemoryMetric() const
+{
+    QMutexLocker l(&m_ownersMemoryLock);
+    return m_lastOwnersMemoryMetric;
+}
+
 inline int KisTileDataPooler::clonesMetric(KisTileData *td, int numClones) {
     return numClones * td->pixelSize();
 }
@@ -282,11 +348,16 @@ void KisTileDataPooler::getLists(Iter *iter,
                                  QList<KisTileData*> &donors,
                                  qint32 &memoryOccupied,
                                  qint32 &statRealMemory,
-                                 qint32 &statHistoricalMemory)
+                                 qint32 &statHistoricalMemory,
+                                 QHash<int, qint64> &statOwnersMemory)
 {
     memoryOccupied = 0;
     statRealMemory = 0;
     statHistoricalMemory = 0;
+    statOwnersMemory.clear();
+
+    int lastOwner = 0;
+    qint64 *lastOwnerMemory = 0;
 
     qint32 needMemoryTotal = 0;
     qint32 canDonorMemoryTotal = 0;
@@ -318,6 +389,19 @@ void KisTileDataPooler::getLists(Iter *iter,
         } else {
             statRealMemory += item->pixelSize();
         }
+
+        const int owner = item->memoryOwner();
+        if (owner) {
+            /**
+             * The neighbouring tile datas usually belong to the
+             * same document, so cache the last hash lookup
+             */
+            if (owner != lastOwner) {
+                lastOwner = owner;
+                lastOwnerMemory = &statOwnersMemory[owner];
+            }
+            *lastOwnerMemory += item->pixelSize();
+        }
     }
 
     DEBUG_LISTS(memoryOccupied,
@@ -9,6 +9,8 @@
 #include <QObject>
 #include <QThread>
 #include <QSemaphore>
+#include <QMutex>
+#include <QHash>
 
 #include "kritaimage_export.h"
 
@@ -34,6 +36,13 @@ public:
     qint64 lastRealMemoryMetric() const;
     qint64 lastHistoricalMemoryMetric() const;
 
+    /**
+     * The metric of the tile datas present in memory grouped
+     * by their memory owners (documents), as it was measured
+     * by the last cycle. The tile datas without an owner are
+     * not included.
+     */
+    QHash<int, qint64> lastOwnersMemoryMetric() const;
 
     /**
      * Is case the pooler thread is not running, the user might force
@@ -41,11 +50,19 @@ public:
      */
     void forceUpdateMemoryStats();
 
+    /**
+     * Is case the pooler thread is not running, the user might force
+     * calculation of the content hashes of all the tile datas used for
+     * deduplication.
+     */
+    void forceHashTileDatas();
+
 protected:
     static const qint32 MAX_NUM_CLONES;
     static const qint32 MAX_TIMEOUT;
     static const qint32 MIN_TIMEOUT;
     static const qint32 TIMEOUT_FACTOR;
+    static const qint32 MAX_HASHES_PER_CYCLE;
 
     void waitForWork();
     qint32 numClonesNeeded(KisTileData *td) const;
@@ -65,12 +82,21 @@ protected:
                       QList<KisTileData*> &donors,
                       qint32 &memoryOccupied,
                       qint32 &statRealMemory,
-                      qint32 &statHistoricalMemory);
+                      qint32 &statHistoricalMemory,
+                      QHash<int, qint64> &statOwnersMemory);
 
     bool processLists(QList<KisTileData*> &beggers,
                       QList<KisTileData*> &donors,
                       qint32 &memoryOccupied);
 
+    /**
+     * Calculates content hashes for at most \p maxHashes immutable
+     * tile datas and registers them in the store for deduplication.
+     * Returns true if there are still some tile datas left unhashed.
+     */
+    template<class Iter>
+        bool hashTileDatas(Iter *iter, qint32 maxHashes);
+
 private:
     void debugTileStatistics();
 protected:
@@ -83,6 +109,8 @@ protected:
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+    QHash<int, qint64> m_lastOwnersMemoryMetric;
+    mutable QMutex m_ownersMemoryLock;
 };
 
 
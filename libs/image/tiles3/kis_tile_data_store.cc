@@ -9,10 +9,12 @@
 #include "config-memory-leak-tracker.h"
 
 #include <QGlobalStatic>
+#include <QHash>
 
 #include "kis_tile_data_store.h"
 #include "kis_tile_data.h"
 #include "kis_debug.h"
+#include "kis_image_config.h"
 
 #include "kis_tile_data_store_iterators.h"
 
@@ -58,10 +60,19 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_mementoJournal(this),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
-      m_clockIndex(1)
+      m_clockIndex(1),
+      m_deduplicationEnabled(KisImageConfig(true).tileDataDeduplication()),
+      m_historyCompactionDepth(KisImageConfig(true).undoCompactionDepth()),
+      m_historyJournalDepth(KisImageConfig(true).undoJournalDepth()),
+      m_historyTransactionClock(0),
+      m_historyCommandClock(0),
+      m_deduplicatedMetric(0),
+      m_lastMemoryOwner(0),
+      m_activeMemoryOwner(0)
 {
     m_pooler.start();
     m_swapper.start();
@@ -105,10 +116,40 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
+    stats.swapOutThroughput = m_swappedStore.swapOutThroughput();
+    stats.deduplicatedSize = m_deduplicatedMetric.loadAcquire() * metricCoeff;
 
     return stats;
 }
 
+int KisTileDataStore::registerMemoryOwner()
+{
+    return m_lastMemoryOwner.fetchAndAddOrdered(1) + 1;
+}
+
+void KisTileDataStore::unregisterMemoryOwner(int owner)
+{
+    m_activeMemoryOwner.testAndSetOrdered(owner, 0);
+}
+
+void KisTileDataStore::setActiveMemoryOwner(int owner)
+{
+    const int oldOwner = m_activeMemoryOwner.fetchAndStoreOrdered(owner);
+
+    /**
+     * The document that has just become inactive may now
+     * exceed its memory limit, let the swapper check that
+     */
+    if (oldOwner != owner) {
+        m_swapper.kick();
+    }
+}
+
+qint64 KisTileDataStore::memoryOwnerMetric(int owner) const
+{
+    return m_pooler.lastOwnersMemoryMetric().value(owner, 0);
+}
+
 inline void KisTileDataStore::registerTileDataImp(KisTileData *td)
 {
     int index = m_counter.fetchAndAddOrdered(1);
@@ -191,6 +232,13 @@ void KisTileDataStore::freeTileData(KisTileData *td)
 
     DEBUG_FREE_ACTION(td);
 
+    unregisterContentHash(td);
+
+    const int deduplicatedUsers = td->m_deduplicatedUsersCount.fetchAndStoreOrdered(0);
+    if (deduplicatedUsers > 0) {
+        m_deduplicatedMetric.fetchAndAddOrdered(-deduplicatedUsers * int(td->pixelSize()));
+    }
+
     m_iteratorLock.lockForRead();
     td->m_swapLock.lockForWrite();
 
@@ -206,6 +254,87 @@ void KisTileDataStore::freeTileData(KisTileData *td)
     delete td;
 }
 
+uint KisTileDataStore::calculateContentHash(const quint8 *data, qint32 pixelSize)
+{
+    return qHashBits(data, KisTileData::WIDTH * KisTileData::HEIGHT * pixelSize);
+}
+
+void KisTileDataStore::registerContentHash(KisTileData *td, uint hash)
+{
+    QMutexLocker locker(&m_contentHashLock);
+
+    if (td->m_contentHashed) return;
+
+    td->m_contentHash = hash;
+    td->m_contentHashed = true;
+
+    /**
+     * If there is a tile data with the same content already, keep the
+     * old one. The duplicates will be merged into it by the data
+     * managers when the corresponding tiles are changed.
+     */
+    if (!m_contentHashes.contains(hash)) {
+        m_contentHashes.insert(hash, td);
+        td->m_contentHashRegistered = true;
+    }
+}
+
+void KisTileDataStore::unregisterContentHash(KisTileData *td)
+{
+    QMutexLocker locker(&m_contentHashLock);
+
+    if (td->m_contentHashRegistered) {
+        m_contentHashes.remove(td->m_contentHash);
+        td->m_contentHashRegistered = false;
+    }
+}
+
+KisTileData* KisTileDataStore::refAndFetchTileDataByHash(uint hash)
+{
+    QMutexLocker locker(&m_contentHashLock);
+
+    KisTileData *td = m_contentHashes.value(hash, 0);
+    if (!td) return 0;
+
+    /**
+     * The tile data might have already been dereferenced to zero
+     * and be waiting for the lock in freeTileData(). We shouldn't
+     * resurrect it.
+     */
+    while (true) {
+        const int refs = td->m_refCount.loadAcquire();
+        if (refs <= 0) return 0;
+
+        if (td->m_refCount.testAndSetOrdered(refs, refs + 1)) break;
+    }
+
+    return td;
+}
+
+void KisTileDataStore::notifyTileDataDeduplicated(KisTileData *td)
+{
+    td->m_deduplicatedUsersCount.ref();
+    m_deduplicatedMetric.fetchAndAddOrdered(td->pixelSize());
+}
+
+void KisTileDataStore::notifyDeduplicatedUserReleased(KisTileData *td)
+{
+    /**
+     * We don't know which of the users has been switched by
+     * deduplication, so we just assume that every copy saved stays
+     * saved only while the tile data has enough users to account
+     * for it.
+     */
+    while (true) {
+        const int count = td->m_deduplicatedUsersCount.loadAcquire();
+        if (count <= 0 || count < td->numUsers()) return;
+
+        if (td->m_deduplicatedUsersCount.testAndSetOrdered(count, count - 1)) break;
+    }
+
+    m_deduplicatedMetric.fetchAndAddOrdered(-int(td->pixelSize()));
+}
+
 void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
 {
 //    dbgKrita << "#### SWAP MISS! ####" << td << ppVar(td->mementoed()) << ppVar(td->age()) << ppVar(td->numUsers());
@@ -274,6 +403,40 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+qint64 KisTileDataStore::trySwapTileDataBatch(const QVector<KisTileData*> &batch)
+{
+    /**
+     * This function is called with m_listLock acquired
+     */
+
+    QVector<KisTileData*> lockedItems;
+    lockedItems.reserve(batch.size());
+
+    Q_FOREACH (KisTileData *td, batch) {
+        if (!td->m_swapLock.tryLockForWrite()) continue;
+
+        if (td->data()) {
+            lockedItems.append(td);
+        } else {
+            td->m_swapLock.unlock();
+        }
+    }
+
+    m_swappedStore.swapOutTileDataBatch(lockedItems);
+
+    qint64 freedMetric = 0;
+
+    Q_FOREACH (KisTileData *td, lockedItems) {
+        if (!td->data()) {
+            unregisterTileDataImp(td);
+            freedMetric += td->pixelSize();
+        }
+        td->m_swapLock.unlock();
+    }
+
+    return freedMetric;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -356,10 +519,16 @@ void KisTileDataStore::debugClear()
     m_clockIndex = 1;
     m_numTiles = 0;
     m_memoryMetric = 0;
+
+    QMutexLocker locker(&m_contentHashLock);
+    m_contentHashes.clear();
 }
 
 void KisTileDataStore::testingRereadConfig()
 {
+    m_deduplicationEnabled.storeRelease(KisImageConfig(true).tileDataDeduplication());
+    m_historyCompactionDepth = KisImageConfig(true).undoCompactionDepth();
+    m_historyJournalDepth = KisImageConfig(true).undoJournalDepth();
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
     kickPooler();
@@ -11,11 +11,14 @@
 #include "kritaimage_export.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
 #include "swap/kis_swapped_data_store.h"
+#include "swap/kis_memento_journal.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
 class KisTileDataStoreIterator;
@@ -42,6 +45,17 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+
+        /**
+         * Average speed of swapping out in bytes per second
+         */
+        qint64 swapOutThroughput;
+
+        /**
+         * The amount of memory currently saved by merging
+         * identical tile datas
+         */
+        qint64 deduplicatedSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -76,6 +90,51 @@ public:
         return m_memoryMetric.loadAcquire();
     }
 
+    /**
+     * The metric of the memento tiles present in memory, as it
+     * was measured by the last cycle of the pooler
+     */
+    inline qint64 historicalMemoryMetric() const
+    {
+        return m_pooler.lastHistoricalMemoryMetric();
+    }
+
+    /**
+     * Memory owners are used for per-document accounting of the tile
+     * datas. Every image registers its own owner id, which is
+     * propagated to its tile datas through the data managers. The
+     * swapper prefers the tile datas of the owners that are not
+     * active, that is, the documents the user doesn't work with now.
+     *
+     * The ids are never reused, zero means "no owner".
+     */
+    int registerMemoryOwner();
+    void unregisterMemoryOwner(int owner);
+
+    /**
+     * Sets the owner of the document currently used by the user
+     */
+    void setActiveMemoryOwner(int owner);
+
+    inline int activeMemoryOwner() const
+    {
+        return m_activeMemoryOwner.loadAcquire();
+    }
+
+    /**
+     * The metric of the tile datas of \p owner present in memory,
+     * as it was measured by the last cycle of the pooler
+     */
+    qint64 memoryOwnerMetric(int owner) const;
+
+    /**
+     * The metrics of all the owners that have tile datas in memory
+     */
+    inline QHash<int, qint64> memoryOwnersMetric() const
+    {
+        return m_pooler.lastOwnersMemoryMetric();
+    }
+
     KisTileDataStoreIterator* beginIteration();
     void endIteration(KisTileDataStoreIterator* iterator);
 
@@ -106,6 +165,120 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Try to swap out a batch of tile datas at once. The tiles
+     * whose swap lock cannot be acquired are skipped. The compression
+     * of the batch is done in parallel.
+     *
+     * \return the metric of the memory freed by the swap out
+     */
+    qint64 trySwapTileDataBatch(const QVector<KisTileData*> &batch);
+
+
+    /**
+     * Content-addressed deduplication of the tile datas. The pooler
+     * calculates hashes of the immutable (mementoed) tile datas in its
+     * idle time and registers them in the store. When a transaction
+     * is committed, the data manager looks up the changed tiles by
+     * their content hash and makes them share the tile data found.
+     */
+    inline bool deduplicationEnabled() const
+    {
+        return m_deduplicationEnabled.loadAcquire();
+    }
+
+    /**
+     * The number of the most recent revisions the memento managers
+     * keep intact, see KisMementoManager::compactHistory(). Zero
+     * means the compaction is disabled.
+     */
+    inline int historyCompactionDepth() const
+    {
+        return m_historyCompactionDepth;
+    }
+
+    /**
+     * The number of the most recent revisions the memento managers
+     * keep in the store. The older ones are moved into the
+     * mementoJournal(). Zero means the journal is disabled.
+     */
+    inline int historyJournalDepth() const
+    {
+        return m_historyJournalDepth;
+    }
+
+    inline KisMementoJournal* mementoJournal()
+    {
+        return &m_mementoJournal;
+    }
+
+    /**
+     * The undo history is global for the image, but every paint device
+     * keeps its own list of revisions. To check that two revisions of a
+     * device are adjacent in the undo history, every revision remembers
+     * the values of two global clocks when it was started:
+     *
+     *  - the transaction clock ticks when a transaction is started
+     *    on any paint device
+     *
+     *  - the undo history clock ticks whenever any command is added,
+     *    undone or redone, see notifyUndoHistoryChanged()
+     *
+     * \see KisMementoManager::compactHistory()
+     */
+    inline int tickHistoryTransactionClock()
+    {
+        return m_historyTransactionClock.fetchAndAddOrdered(1) + 1;
+    }
+
+    inline int historyCommandClock() const
+    {
+        return m_historyCommandClock.loadAcquire();
+    }
+
+    /**
+     * Must be called by the undo stores whenever their undo stack
+     * changes. Otherwise the revisions of the commands that don't
+     * touch the paint devices might be compacted together with their
+     * neighbours.
+     */
+    inline void notifyUndoHistoryChanged()
+    {
+        m_historyCommandClock.ref();
+    }
+
+    static uint calculateContentHash(const quint8 *data, qint32 pixelSize);
+
+    /**
+     * Registers \p td with a content hash \p hash. If another tile data
+     * with the same hash is already registered, \p td is only marked
+     * as hashed. Should be called by the pooler only.
+     */
+    void registerContentHash(KisTileData *td, uint hash);
+
+    /**
+     * Returns a tile data registered with the content hash \p hash
+     * or null if there is no such tile data. The returned tile data
+     * is ref'ed, the caller should deref() it after use. The caller
+     * must compare the content of the tile data itself, since
+     * different contents may have the same hash.
+     */
+    KisTileData* refAndFetchTileDataByHash(uint hash);
+
+    /**
+     * Called by the data manager when a tile has been switched to the
+     * deduplicated tile data \p td. Used for statistics only.
+     */
+    void notifyTileDataDeduplicated(KisTileData *td);
+
+    /**
+     * Called by \p td when one of its users releases it, e.g. when a
+     * tile is destroyed or its data diverges on copy-on-write. The
+     * copy saved by deduplication is no longer saved after that.
+     * Used for statistics only.
+     */
+    void notifyDeduplicatedUserReleased(KisTileData *td);
+
 
     /**
      * WARN: The following three method are only for usage
@@ -136,6 +309,7 @@ private:
 
     inline void registerTileDataImp(KisTileData *td);
     inline void unregisterTileDataImp(KisTileData *td);
+    void unregisterContentHash(KisTileData *td);
     void freeRegisteredTiles();
 
     friend class DeadlockyThread;
@@ -156,6 +330,7 @@ private:
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
     KisSwappedDataStore m_swappedStore;
+    KisMementoJournal m_mementoJournal;
 
     /**
      * This metric is used for computing the volume
@@ -168,6 +343,17 @@ private:
     QAtomicInt m_clockIndex;
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
+
+    QAtomicInt m_deduplicationEnabled;
+    int m_historyCompactionDepth;
+    int m_historyJournalDepth;
+    QAtomicInt m_historyTransactionClock;
+    QAtomicInt m_historyCommandClock;
+    QAtomicInt m_deduplicatedMetric;
+    QAtomicInt m_lastMemoryOwner;
+    QAtomicInt m_activeMemoryOwner;
+    QHash<uint, KisTileData*> m_contentHashes;
+    QMutex m_contentHashLock;
 };
 
 template<typename T>
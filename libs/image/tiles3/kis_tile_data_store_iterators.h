@@ -8,6 +8,8 @@
 #ifndef KIS_TILE_DATA_STORE_ITERATORS_H_
 #define KIS_TILE_DATA_STORE_ITERATORS_H_
 
+#include <QVector>
+
 #include "kis_tile_data.h"
 #include "kis_debug.h"
 
@@ -61,6 +63,15 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    /**
+     * All the items of the batch should have already been
+     * passed by the iterator
+     */
+    inline qint64 trySwapOutBatch(const QVector<KisTileData*> &batch)
+    {
+        return m_store->trySwapTileDataBatch(batch);
+    }
+
 private:
     ConcurrentMap<int, KisTileData*> &m_map;
     ConcurrentMap<int, KisTileData*>::Iterator m_iterator;
@@ -136,6 +147,15 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    /**
+     * All the items of the batch should have already been
+     * passed by the iterator
+     */
+    inline qint64 trySwapOutBatch(const QVector<KisTileData*> &batch)
+    {
+        return m_store->trySwapTileDataBatch(batch);
+    }
+
 private:
     friend class KisTileDataStore;
     inline int getFinalPosition()
@@ -32,6 +32,7 @@
 
 KisTiledDataManager::KisTiledDataManager(quint32 pixelSize,
                                          const quint8 *defaultPixel)
+    : m_uniformTileDataCache(pixelSize)
 {
     /* See comment in destructor for details */
     m_mementoManager = new KisMementoManager();
@@ -43,12 +44,14 @@ KisTiledDataManager::KisTiledDataManager(quint32 pixelSize,
 }
 
 KisTiledDataManager::KisTiledDataManager(const KisTiledDataManager &dm)
-    : KisShared()
+    : KisShared(),
+      m_uniformTileDataCache(dm.m_pixelSize)
 {
     /* See comment in destructor for details */
 
     /* We do not clone the history of the device, there is no usecase for it */
     m_mementoManager = new KisMementoManager();
+    m_mementoManager->setMemoryOwner(dm.memoryOwner(), dm.lowMemoryPriority());
 
     KisTileData *defaultTileData = dm.m_hashTable->refAndFetchDefaultTileData();
     m_mementoManager->setDefaultTileData(defaultTileData);
@@ -174,6 +177,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
         }
     }
 
+    deduplicateTiles();
     m_mementoManager->commit();
     return readSuccess;
 }
@@ -293,6 +297,80 @@ void KisTiledDataManager::purge(const QRect& area)
     }
 }
 
+void KisTiledDataManager::deduplicateTiles()
+{
+    const QVector<QPoint> changedTiles = m_mementoManager->changedTiles();
+    if (changedTiles.isEmpty()) return;
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    const bool useContentHashes = store->deduplicationEnabled();
+    const qint32 tileDataSize = KisTileData::WIDTH * KisTileData::HEIGHT * m_pixelSize;
+
+    KisTileData *defaultTileData = m_hashTable->refAndFetchDefaultTileData();
+
+    Q_FOREACH (const QPoint &pt, changedTiles) {
+        KisTileSP tile = m_hashTable->getExistingTile(pt.x(), pt.y());
+        if (!tile) continue;
+
+        tile->lockForRead();
+
+        /**
+         * If the tile data is already shared with someone (e.g. it has
+         * been bitBlt'ed from another device or filled by clear()), we
+         * should keep the sharing as it is
+         */
+        if (tile->tileData()->numUsers() > 1) {
+            tile->unlockForRead();
+            continue;
+        }
+
+        const quint8 *data = tile->data();
+
+        if (KisUniformTileDataCache::isUniform(data, m_pixelSize)) {
+            KisTileData *uniformTileData =
+                !memcmp(data, m_defaultPixel, m_pixelSize) ?
+                defaultTileData : m_uniformTileDataCache.fetchTileData(data);
+
+            if (uniformTileData) {
+                tile->tryShareTileData(uniformTileData);
+            }
+        } else if (useContentHashes) {
+            const uint hash = KisTileDataStore::calculateContentHash(data, m_pixelSize);
+            KisTileData *twinTileData = store->refAndFetchTileDataByHash(hash);
+
+            /**
+             * Only mementoed tile datas are registered by the pooler,
+             * but the history might have been purged since then, so
+             * check it again. Non-mementoed data might be being
+             * written into right now.
+             */
+            if (twinTileData &&
+                twinTileData != tile->tileData() &&
+                twinTileData->pixelSize() == (quint32)m_pixelSize &&
+                twinTileData->mementoed()) {
+
+                twinTileData->blockSwapping();
+
+                if (!memcmp(twinTileData->data(), data, tileDataSize) &&
+                    tile->tryShareTileData(twinTileData)) {
+
+                    store->notifyTileDataDeduplicated(twinTileData);
+                }
+
+                twinTileData->unblockSwapping();
+            }
+
+            if (twinTileData) {
+                twinTileData->deref();
+            }
+        }
+
+        tile->unlockForRead();
+    }
+
+    defaultTileData->deref();
+}
+
 quint8* KisTiledDataManager::duplicatePixel(qint32 num, const quint8 *pixel)
 {
     const qint32 pixelSize = this->pixelSize();
@@ -660,6 +738,27 @@ QRect KisTiledDataManager::extent() const
     return m_extentManager.extent();
 }
 
+void KisTiledDataManager::setMemoryOwner(int owner, bool lowPriority)
+{
+    QWriteLocker locker(&m_lock);
+
+    if (m_mementoManager->memoryOwner() == owner &&
+        m_mementoManager->lowMemoryPriority() == lowPriority) {
+
+        return;
+    }
+
+    m_mementoManager->setMemoryOwner(owner, lowPriority);
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        tile->tileData()->setMemoryOwner(owner, lowPriority);
+        iter.next();
+    }
+}
+
 KisRegion KisTiledDataManager::region() const
 {
     QVector<QRect> rects;
@@ -675,6 +774,41 @@ KisRegion KisTiledDataManager::region() const
     return KisRegion(std::move(rects));
 }
 
+QVector<QRect> KisTiledDataManager::differingTileRects(KisTiledDataManager *other) const
+{
+    QVector<QRect> rects;
+
+    {
+        KisTileHashTableConstIterator iter(m_hashTable);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            bool existingTile = false;
+            KisTileSP otherTile =
+                other->m_hashTable->getReadOnlyTileLazy(tile->col(), tile->row(), existingTile);
+
+            if (!existingTile || otherTile->tileData() != tile->tileData()) {
+                rects << tile->extent();
+            }
+            iter.next();
+        }
+    }
+
+    {
+        KisTileHashTableConstIterator iter(other->m_hashTable);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            if (!m_hashTable->tileExists(tile->col(), tile->row())) {
+                rects << tile->extent();
+            }
+            iter.next();
+        }
+    }
+
+    return rects;
+}
+
 void KisTiledDataManager::setPixel(qint32 x, qint32 y, const quint8 * data)
 {
     KisTileDataWrapper tw(this, x, y, KisTileDataWrapper::WRITE);
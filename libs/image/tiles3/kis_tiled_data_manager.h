@@ -27,6 +27,7 @@
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
 #include "KisTiledExtentManager.h"
+#include "kis_uniform_tile_data_cache.h"
 
 class KisTiledDataManager;
 typedef KisSharedPtr<KisTiledDataManager> KisTiledDataManagerSP;
@@ -149,6 +150,7 @@ public:
             memento->saveNewDefaultPixel(m_defaultPixel, m_pixelSize);
         }
 
+        deduplicateTiles();
         m_mementoManager->commit();
     }
 
@@ -190,6 +192,23 @@ public:
         m_mementoManager->purgeHistory(oldestMemento);
     }
 
+    /**
+     * Assigns the tile datas of the data manager to a memory owner
+     * (document) in KisTileDataStore. The tile datas created later
+     * on copy-on-write inherit the owner from the memento manager.
+     * \p lowPriority marks the data of invisible layers, which are
+     * the first candidates for swapping out.
+     */
+    void setMemoryOwner(int owner, bool lowPriority);
+
+    inline int memoryOwner() const {
+        return m_mementoManager->memoryOwner();
+    }
+
+    inline bool lowMemoryPriority() const {
+        return m_mementoManager->lowMemoryPriority();
+    }
+
     static void releaseInternalPools();
 
 protected:
@@ -216,6 +235,16 @@ public:
 
     KisRegion region() const;
 
+    /**
+     * Returns the extents of the tiles that differ in the two data
+     * managers, that is, the tiles that exist in only one of them or
+     * point to different tile data. A copy of a data manager shares
+     * the tile data with the original until the tiles are written to
+     * (copy-on-write), so comparing a data manager with its older copy
+     * returns the tiles changed since the copy has been made.
+     */
+    QVector<QRect> differingTileRects(KisTiledDataManager *other) const;
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
@@ -337,6 +366,7 @@ private:
     quint8* m_defaultPixel;
     qint32 m_pixelSize;
     KisTiledExtentManager m_extentManager;
+    KisUniformTileDataCache m_uniformTileDataCache;
 
     mutable QReadWriteLock m_lock;
 
@@ -358,6 +388,18 @@ private:
 
     void recalculateExtent();
 
+    /**
+     * Makes all the tiles changed in the current transaction, which
+     * are filled with a single color, share one tile data per color.
+     * If content-addressed deduplication is enabled in the store, the
+     * other changed tiles are merged with the identical tile datas
+     * registered there.
+     *
+     * Should be called under m_lock right before committing the
+     * transaction.
+     */
+    void deduplicateTiles();
+
     quint8* duplicatePixel(qint32 num, const quint8 *pixel);
 
     template<bool useOldSrcData>
@@ -0,0 +1,89 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_uniform_tile_data_cache.h"
+
+#include <string.h>
+
+#include "kis_tile_data.h"
+#include "kis_tile_data_store.h"
+
+/**
+ * The number of distinct colors a single data manager can share. In
+ * real-life images it is usually one or two (the background and,
+ * probably, some solid color fill), so there is no point in keeping
+ * a lot of them.
+ */
+const int MAX_CACHED_COLORS = 16;
+
+
+KisUniformTileDataCache::KisUniformTileDataCache(qint32 pixelSize)
+    : m_pixelSize(pixelSize)
+{
+}
+
+KisUniformTileDataCache::~KisUniformTileDataCache()
+{
+    Q_FOREACH (KisTileData *td, m_tileDatas) {
+        td->release();
+    }
+}
+
+bool KisUniformTileDataCache::isUniform(const quint8 *data, qint32 pixelSize)
+{
+    const qint32 tileDataSize = KisTileData::WIDTH * KisTileData::HEIGHT * pixelSize;
+
+    /**
+     * Comparing the buffer with itself shifted by one pixel checks
+     * that every pixel is equal to its neighbour, that is all the
+     * pixels are equal to the first one. memcmp() is vectorized
+     * and exits on the first difference, so non-uniform tiles are
+     * rejected almost immediately.
+     */
+    return !memcmp(data, data + pixelSize, tileDataSize - pixelSize);
+}
+
+KisTileData* KisUniformTileDataCache::fetchTileData(const quint8 *pixel)
+{
+    const QByteArray key(reinterpret_cast<const char*>(pixel), m_pixelSize);
+
+    KisTileData *td = m_tileDatas.value(key, 0);
+    if (td) return td;
+
+    if (m_tileDatas.size() >= MAX_CACHED_COLORS) {
+        purgeUnused();
+
+        if (m_tileDatas.size() >= MAX_CACHED_COLORS) {
+            return 0;
+        }
+    }
+
+    td = KisTileDataStore::instance()->createDefaultTileData(m_pixelSize, pixel);
+    td->acquire();
+    m_tileDatas.insert(key, td);
+
+    return td;
+}
+
+void KisUniformTileDataCache::purgeUnused()
+{
+    auto it = m_tileDatas.begin();
+    while (it != m_tileDatas.end()) {
+        KisTileData *td = it.value();
+
+        if (td->numUsers() == 1) {
+            td->release();
+            it = m_tileDatas.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int KisUniformTileDataCache::size() const
+{
+    return m_tileDatas.size();
+}
@@ -0,0 +1,62 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_UNIFORM_TILE_DATA_CACHE_H
+#define __KIS_UNIFORM_TILE_DATA_CACHE_H
+
+#include <QHash>
+#include <QByteArray>
+
+#include "kritaimage_export.h"
+
+class KisTileData;
+
+/**
+ * Keeps a small set of tile datas filled with a single color. The
+ * data manager uses them to collapse tiles that became uniform
+ * during a transaction into one shared tile data, so that e.g. a
+ * filled background layer occupies only one tile data instead of
+ * hundreds of identical ones.
+ *
+ * Every cached tile data is acquired by the cache, which means that
+ * any tile sharing it will do copy-on-write on the next write access.
+ *
+ * The cache is not thread-safe, the owner should guard it.
+ */
+class KRITAIMAGE_EXPORT KisUniformTileDataCache
+{
+public:
+    KisUniformTileDataCache(qint32 pixelSize);
+    ~KisUniformTileDataCache();
+
+    /**
+     * Returns true if all the pixels in \p data are equal
+     */
+    static bool isUniform(const quint8 *data, qint32 pixelSize);
+
+    /**
+     * Returns a shared tile data filled with \p pixel. The tile data
+     * is owned by the cache and stays valid until the cache is
+     * destroyed or purgeUnused() is called. If the cache is full and
+     * there is nothing to evict, returns null.
+     */
+    KisTileData* fetchTileData(const quint8 *pixel);
+
+    /**
+     * Releases all the tile datas that are not used by any tile
+     */
+    void purgeUnused();
+
+    int size() const;
+
+private:
+    Q_DISABLE_COPY(KisUniformTileDataCache)
+
+    qint32 m_pixelSize;
+    QHash<QByteArray, KisTileData*> m_tileDatas;
+};
+
+#endif /* __KIS_UNIFORM_TILE_DATA_CACHE_H */
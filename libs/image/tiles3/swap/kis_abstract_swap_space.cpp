@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_abstract_swap_space.h"
+
+KisAbstractSwapSpace::KisAbstractSwapSpace()
+{
+}
+
+KisAbstractSwapSpace::~KisAbstractSwapSpace()
+{
+}
+
+void KisAbstractSwapSpace::releaseChunk(const KisChunkData &chunk)
+{
+    Q_UNUSED(chunk);
+}
@@ -0,0 +1,52 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ABSTRACT_SWAP_SPACE_H
+#define __KIS_ABSTRACT_SWAP_SPACE_H
+
+#include "kis_chunk_allocator.h"
+
+/**
+ * Base class for the backends that give KisSwappedDataStore access
+ * to the swap file. The store allocates chunks with KisChunkAllocator
+ * and asks the backend for a pointer to the memory where the chunk
+ * can be read or written.
+ *
+ * The pointer is valid only until the next call to the swap space.
+ */
+
+class KRITAIMAGE_EXPORT KisAbstractSwapSpace
+{
+public:
+    KisAbstractSwapSpace();
+    virtual ~KisAbstractSwapSpace();
+
+    inline quint8* getReadChunkPtr(KisChunk readChunk) {
+        return getReadChunkPtr(readChunk.data());
+    }
+
+    inline quint8* getWriteChunkPtr(KisChunk writeChunk) {
+        return getWriteChunkPtr(writeChunk.data());
+    }
+
+    inline void releaseChunk(KisChunk chunk) {
+        releaseChunk(chunk.data());
+    }
+
+    virtual quint8* getReadChunkPtr(const KisChunkData &readChunk) = 0;
+    virtual quint8* getWriteChunkPtr(const KisChunkData &writeChunk) = 0;
+
+    /**
+     * Notifies the backend that the data of the chunk is not
+     * needed anymore and will not be read. It is called right
+     * before the chunk is returned into the allocator.
+     *
+     * Default implementation does nothing.
+     */
+    virtual void releaseChunk(const KisChunkData &chunk);
+};
+
+#endif /* __KIS_ABSTRACT_SWAP_SPACE_H */
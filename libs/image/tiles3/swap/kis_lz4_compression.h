@@ -0,0 +1,36 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_LZ4_COMPRESSION_H
+#define __KIS_LZ4_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+/**
+ * A wrapper around LZ4 library. It compresses a bit worse than LZF,
+ * but decompression is several times faster, which is what matters
+ * most when the tiles are swapped in while painting.
+ *
+ * \p acceleration is passed to LZ4_compress_fast(): the higher the
+ * value, the faster and the worse the compression is. Value 1 is
+ * the LZ4 default.
+ */
+class KRITAIMAGE_EXPORT KisLz4Compression : public KisAbstractCompression
+{
+public:
+    KisLz4Compression(int acceleration = 1);
+    ~KisLz4Compression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    int m_acceleration;
+};
+
+#endif /* __KIS_LZ4_COMPRESSION_H */
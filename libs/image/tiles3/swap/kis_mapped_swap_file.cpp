@@ -0,0 +1,195 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_debug.h"
+#include "kis_mapped_swap_file.h"
+
+#include <QDir>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
+
+
+#ifdef Q_OS_UNIX
+
+namespace {
+
+inline quint64 pageSize()
+{
+    static const quint64 size = quint64(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+inline quint64 alignDown(quint64 value)
+{
+    return value & ~(pageSize() - 1);
+}
+
+inline quint64 alignUp(quint64 value)
+{
+    return alignDown(value + pageSize() - 1);
+}
+
+}
+
+#endif /* Q_OS_UNIX */
+
+
+KisMappedSwapFile::KisMappedSwapFile(const QString &swapDir, quint64 maxSwapSize, quint64 growStep)
+    : m_mapping(0),
+      m_mappingSize(0),
+      m_fileSize(0),
+      m_growStep(growStep)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!swapDir.isEmpty());
+
+    bool valid = true;
+
+    QDir d(swapDir);
+    if (!d.exists()) {
+        valid = d.mkpath(swapDir);
+    }
+
+    const QString swapFileTemplate = swapDir + '/' + SWP_PREFIX;
+
+    if (valid) {
+        m_file.setFileTemplate(swapFileTemplate);
+        valid = m_file.open() && !m_file.fileName().isEmpty();
+    }
+
+#ifdef Q_OS_UNIX
+    if (valid) {
+        const quint64 mappingSize = alignUp(maxSwapSize);
+
+        void *ptr = mmap(0, mappingSize,
+                         PROT_READ | PROT_WRITE, MAP_SHARED,
+                         m_file.handle(), 0);
+
+        if (ptr != MAP_FAILED) {
+            m_mapping = reinterpret_cast<quint8*>(ptr);
+            m_mappingSize = mappingSize;
+
+            /**
+             * Tiles are swapped in and out in a random order, so
+             * the readahead of the kernel only pollutes the page
+             * cache. We prefetch the chunks explicitly instead.
+             */
+            madvise(m_mapping, m_mappingSize, MADV_RANDOM);
+        } else {
+            valid = false;
+        }
+    }
+#else
+    Q_UNUSED(maxSwapSize);
+    valid = false;
+#endif
+
+    if (!valid) {
+        qWarning() << "Could not create or map swapfile; disabling swapfile" << swapFileTemplate;
+    }
+}
+
+KisMappedSwapFile::~KisMappedSwapFile()
+{
+#ifdef Q_OS_UNIX
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingSize);
+    }
+#endif
+}
+
+bool KisMappedSwapFile::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool KisMappedSwapFile::isValid() const
+{
+    return m_mapping;
+}
+
+bool KisMappedSwapFile::chunkFitsMapping(const KisChunkData &chunk) const
+{
+    return m_mapping && chunk.m_end < m_mappingSize;
+}
+
+bool KisMappedSwapFile::ensureFileSize(quint64 minimalSize)
+{
+    if (minimalSize <= m_fileSize) return true;
+
+    quint64 newSize = (minimalSize + m_growStep - 1) / m_growStep * m_growStep;
+    newSize = qMin(newSize, m_mappingSize);
+
+#ifdef Q_OS_LINUX
+    /**
+     * Writing into a page of a sparse file when the disk is full
+     * raises SIGBUS, so we reserve the disk space for the new part
+     * of the file explicitly and report a normal failure instead.
+     */
+    if (posix_fallocate(m_file.handle(), m_fileSize, newSize - m_fileSize) != 0) {
+        return false;
+    }
+#else
+    if (!m_file.resize(newSize)) {
+        return false;
+    }
+#endif
+
+    m_fileSize = newSize;
+    return true;
+}
+
+quint8* KisMappedSwapFile::getReadChunkPtr(const KisChunkData &readChunk)
+{
+    if (!chunkFitsMapping(readChunk) || readChunk.m_end >= m_fileSize) {
+        return nullptr;
+    }
+
+#ifdef Q_OS_UNIX
+    const quint64 begin = alignDown(readChunk.m_begin);
+    madvise(m_mapping + begin, readChunk.m_end + 1 - begin, MADV_WILLNEED);
+#endif
+
+    return m_mapping + readChunk.m_begin;
+}
+
+quint8* KisMappedSwapFile::getWriteChunkPtr(const KisChunkData &writeChunk)
+{
+    if (!chunkFitsMapping(writeChunk) || !ensureFileSize(writeChunk.m_end + 1)) {
+        return nullptr;
+    }
+
+    return m_mapping + writeChunk.m_begin;
+}
+
+void KisMappedSwapFile::releaseChunk(const KisChunkData &chunk)
+{
+    if (!chunkFitsMapping(chunk)) return;
+
+#ifdef Q_OS_UNIX
+    /**
+     * Drop only the pages that are fully covered by the chunk,
+     * the boundary pages are shared with the neighbouring chunks.
+     * The data stays in the file, so it is safe even if the page
+     * is still dirty.
+     */
+    const quint64 begin = alignUp(chunk.m_begin);
+    const quint64 end = alignDown(chunk.m_end + 1);
+
+    if (begin < end) {
+        madvise(m_mapping + begin, end - begin, MADV_DONTNEED);
+    }
+#endif
+}
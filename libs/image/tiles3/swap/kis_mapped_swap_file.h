@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_MAPPED_SWAP_FILE_H
+#define __KIS_MAPPED_SWAP_FILE_H
+
+#include <QTemporaryFile>
+
+#include "kis_abstract_swap_space.h"
+
+/**
+ * A swap space backend that maps the whole swap file into the
+ * address space of the process at once. The file itself grows by
+ * \p growStep bytes when the allocator needs more space, but the
+ * mapping is created only once and covers \p maxSwapSize bytes,
+ * so reading a chunk is just a page fault and there is no need to
+ * move any windows around.
+ *
+ * The backend gives the kernel hints about the access pattern:
+ * the mapping is marked as random-access, the chunk is prefetched
+ * before reading and the pages of the released chunks are dropped
+ * from the resident set.
+ *
+ * The backend is available on Unix-like systems only, see
+ * isSupported().
+ */
+class KRITAIMAGE_EXPORT KisMappedSwapFile : public KisAbstractSwapSpace
+{
+public:
+    /**
+     * @param swapDir If the dir doesn't exist, it'll be created
+     * @param maxSwapSize the size of the mapping, the swap file
+     *        will never be bigger than that
+     * @param growStep the file is resized with this granularity
+     */
+    KisMappedSwapFile(const QString &swapDir, quint64 maxSwapSize, quint64 growStep = DEFAULT_SLAB_SIZE);
+    ~KisMappedSwapFile() override;
+
+    /**
+     * Returns true if the backend can be used on the current platform
+     */
+    static bool isSupported();
+
+    /**
+     * Returns true if the swap file has been created and mapped
+     * successfully
+     */
+    bool isValid() const;
+
+    using KisAbstractSwapSpace::getReadChunkPtr;
+    using KisAbstractSwapSpace::getWriteChunkPtr;
+    using KisAbstractSwapSpace::releaseChunk;
+
+    quint8* getReadChunkPtr(const KisChunkData &readChunk) override;
+    quint8* getWriteChunkPtr(const KisChunkData &writeChunk) override;
+    void releaseChunk(const KisChunkData &chunk) override;
+
+private:
+    bool ensureFileSize(quint64 minimalSize);
+    bool chunkFitsMapping(const KisChunkData &chunk) const;
+
+private:
+    QTemporaryFile m_file;
+
+    quint8 *m_mapping;
+    quint64 m_mappingSize;
+    quint64 m_fileSize;
+    const quint64 m_growStep;
+};
+
+#endif /* __KIS_MAPPED_SWAP_FILE_H */
@@ -0,0 +1,217 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_memento_journal.h"
+
+#include <QDir>
+#include <QtConcurrent>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+#include "kis_tile_compressor_2.h"
+#include "tiles3/kis_tile_data.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/kis_memento_item.h"
+
+#define JOURNAL_PREFIX "KRITA_UNDO_JOURNAL_XXXXXX"
+
+
+KisMementoJournal::KisMementoJournal(KisTileDataStore *store)
+    : m_store(store),
+      m_fileFailed(false),
+      m_totalSize(0),
+      m_numRecords(0),
+      m_workerRunning(false)
+{
+    KisImageConfig config(true);
+    m_compressor =
+        new KisTileCompressor2(KisTileCompressor2::codecFromString(config.swapCompressionCodec()),
+                               config.swapCompressionLevel());
+
+    /**
+     * The allocator is given twice as much space as we ever store
+     * to leave some room for fragmentation, it cannot fail
+     * gracefully when it runs out of space
+     */
+    m_maxSize = qint64(config.maxSwapSize()) * MiB;
+    m_allocator = new KisChunkAllocator(config.swapSlabSize() * MiB, 2 * m_maxSize);
+}
+
+KisMementoJournal::~KisMementoJournal()
+{
+    waitForPendingItems();
+    m_pendingItems.clear();
+
+    delete m_allocator;
+    delete m_compressor;
+}
+
+void KisMementoJournal::scheduleItems(const QVector<KisMementoItemSP> &items)
+{
+    if (items.isEmpty()) return;
+
+    QMutexLocker locker(&m_pendingLock);
+    m_pendingItems += items;
+
+    if (!m_workerRunning) {
+        m_workerRunning = true;
+        m_worker = QtConcurrent::run([this] () { processPendingItems(); });
+    }
+}
+
+void KisMementoJournal::processPendingItems()
+{
+    while (true) {
+        QVector<KisMementoItemSP> items;
+
+        {
+            QMutexLocker locker(&m_pendingLock);
+            if (m_pendingItems.isEmpty()) {
+                m_workerRunning = false;
+                return;
+            }
+            items.swap(m_pendingItems);
+        }
+
+        for (const KisMementoItemSP &mi : items) {
+            // the revision has already been purged, no need to save it
+            if (mi->refCount() <= 1) continue;
+
+            mi->moveToJournal();
+        }
+    }
+}
+
+void KisMementoJournal::waitForPendingItems()
+{
+    QFuture<void> worker;
+
+    {
+        QMutexLocker locker(&m_pendingLock);
+        worker = m_worker;
+    }
+
+    worker.waitForFinished();
+}
+
+bool KisMementoJournal::openFile()
+{
+    if (m_file.isOpen()) return true;
+    if (m_fileFailed) return false;
+
+    const QString journalDir = KisImageConfig(true).swapDir();
+
+    QDir d(journalDir);
+    if (!d.exists() && !d.mkpath(journalDir)) {
+        m_fileFailed = true;
+    }
+
+    if (!m_fileFailed) {
+        m_file.setFileTemplate(journalDir + '/' + JOURNAL_PREFIX);
+        m_fileFailed = !m_file.open() || m_file.fileName().isEmpty();
+    }
+
+    if (m_fileFailed) {
+        qWarning() << "Could not create or open the undo journal; the undo history will be kept in memory" << journalDir;
+    }
+
+    return !m_fileFailed;
+}
+
+bool KisMementoJournal::writeTileData(KisTileData *td, Record &record)
+{
+    QMutexLocker locker(&m_lock);
+
+    if (!openFile()) return false;
+    if (m_totalSize + m_compressor->tileDataBufferSize(td) > m_maxSize) return false;
+
+    const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
+    if (m_buffer.size() < expectedBufferSize) {
+        m_buffer.resize(expectedBufferSize);
+    }
+
+    qint32 bytesWritten;
+
+    td->blockSwapping();
+    m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
+    td->unblockSwapping();
+
+    KisChunk chunk = m_allocator->getChunk(bytesWritten);
+
+    if (!m_file.seek(chunk.begin()) ||
+        m_file.write(m_buffer.constData(), bytesWritten) != bytesWritten) {
+
+        qWarning() << "Failed to write into the undo journal" << m_file.fileName();
+        m_allocator->freeChunk(chunk);
+        return false;
+    }
+
+    record.chunk = chunk;
+    record.size = bytesWritten;
+    record.pixelSize = td->pixelSize();
+
+    m_totalSize += bytesWritten;
+    m_numRecords++;
+
+    return true;
+}
+
+KisTileData* KisMementoJournal::readTileData(const Record &record)
+{
+    const QByteArray defaultPixel(record.pixelSize, 0);
+    KisTileData *td = m_store->createDefaultTileData(record.pixelSize, (const quint8*) defaultPixel.constData());
+
+    QMutexLocker locker(&m_lock);
+
+    if (m_buffer.size() < record.size) {
+        m_buffer.resize(record.size);
+    }
+
+    if (!m_file.seek(record.chunk.begin()) ||
+        m_file.read(m_buffer.data(), record.size) != record.size ||
+        !m_compressor->decompressTileData((quint8*) m_buffer.data(), record.size, td)) {
+
+        qWarning() << "Failed to read from the undo journal" << m_file.fileName();
+
+        locker.unlock();
+        m_store->freeTileData(td);
+        return 0;
+    }
+
+    return td;
+}
+
+void KisMementoJournal::forgetRecord(const Record &record)
+{
+    QMutexLocker locker(&m_lock);
+
+    m_allocator->freeChunk(record.chunk);
+    m_totalSize -= record.size;
+    m_numRecords--;
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_totalSize >= 0);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_numRecords >= 0);
+
+    /**
+     * Nobody needs the journal anymore, so we can give
+     * the disk space back to the system
+     */
+    if (!m_numRecords) {
+        m_file.resize(0);
+    }
+}
+
+qint64 KisMementoJournal::totalSize() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_totalSize;
+}
+
+qint64 KisMementoJournal::numRecords() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_numRecords;
+}
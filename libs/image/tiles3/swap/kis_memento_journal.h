@@ -0,0 +1,123 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_MEMENTO_JOURNAL_H
+#define __KIS_MEMENTO_JOURNAL_H
+
+#include <QMutex>
+#include <QByteArray>
+#include <QTemporaryFile>
+#include <QVector>
+#include <QFuture>
+
+#include "kritaimage_export.h"
+#include "kis_chunk_allocator.h"
+#include "kis_shared_ptr.h"
+
+class KisTileData;
+class KisTileDataStore;
+class KisAbstractTileCompressor;
+class KisMementoItem;
+typedef KisSharedPtr<KisMementoItem> KisMementoItemSP;
+
+/**
+ * A file where the memento managers put the tile datas of the old
+ * revisions of the undo history. The file is created next to the
+ * swap file when the first record is written.
+ *
+ * The space of the forgotten records is reused with the same
+ * KisChunkAllocator the swap file uses, so the file doesn't grow
+ * over a long session. The total size of the alive records is
+ * limited by the maximum swap size; when the limit is reached the
+ * revisions just stay in memory.
+ *
+ * The memento managers don't write into the journal themselves, they
+ * pass the items to scheduleItems() and the writing happens in a
+ * background job.
+ *
+ * \see KisMementoItem::moveToJournal()
+ */
+class KRITAIMAGE_EXPORT KisMementoJournal
+{
+public:
+    struct Record {
+        KisChunk chunk;
+        qint32 size {0};
+        qint32 pixelSize {0};
+    };
+
+public:
+    KisMementoJournal(KisTileDataStore *store);
+    ~KisMementoJournal();
+
+    /**
+     * Moves the tile datas of \p items into the journal in a
+     * background job. The items that are not referenced by anyone
+     * else by the time the job reaches them are skipped.
+     */
+    void scheduleItems(const QVector<KisMementoItemSP> &items);
+
+    /**
+     * Waits until all the scheduled items are processed
+     */
+    void waitForPendingItems();
+
+    /**
+     * Compresses the data of \p td and writes it into the journal.
+     * The tile data should be acquired by the caller. It is not
+     * changed by the call.
+     *
+     * \return false if the journal file cannot be written or
+     *         the journal is full
+     */
+    bool writeTileData(KisTileData *td, Record &record);
+
+    /**
+     * Creates a new tile data filled with the content of \p record.
+     * The tile data is not acquired, that is the duty of the caller.
+     *
+     * \return null if the journal file cannot be read
+     */
+    KisTileData* readTileData(const Record &record);
+
+    /**
+     * Notifies the journal that \p record will never be read again
+     */
+    void forgetRecord(const Record &record);
+
+    /**
+     * The size of the records that are still alive
+     */
+    qint64 totalSize() const;
+
+    /**
+     * The number of the records that are still alive
+     */
+    qint64 numRecords() const;
+
+private:
+    bool openFile();
+    void processPendingItems();
+
+private:
+    KisTileDataStore *m_store;
+    KisAbstractTileCompressor *m_compressor;
+    KisChunkAllocator *m_allocator;
+    QTemporaryFile m_file;
+    bool m_fileFailed;
+    QByteArray m_buffer;
+    qint64 m_maxSize;
+    qint64 m_totalSize;
+    qint64 m_numRecords;
+    mutable QMutex m_lock;
+
+    QVector<KisMementoItemSP> m_pendingItems;
+    bool m_workerRunning;
+    QFuture<void> m_worker;
+    QMutex m_pendingLock;
+};
+
+#endif /* __KIS_MEMENTO_JOURNAL_H */
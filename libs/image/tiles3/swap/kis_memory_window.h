@@ -9,12 +9,17 @@
 
 #include <QTemporaryFile>
 
-#include "kis_chunk_allocator.h"
+#include "kis_abstract_swap_space.h"
 
 
 #define DEFAULT_WINDOW_SIZE (16*MiB)
 
-class KRITAIMAGE_EXPORT KisMemoryWindow
+/**
+ * The default swap space backend. It maps two small windows of
+ * the swap file into memory, one for reading and one for writing,
+ * and moves them around when a chunk outside the window is requested.
+ */
+class KRITAIMAGE_EXPORT KisMemoryWindow : public KisAbstractSwapSpace
 {
 public:
     /**
@@ -22,18 +27,13 @@ public:
      * @param writeWindowSize write window size.
      */
     KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE);
-    ~KisMemoryWindow();
-
-    inline quint8* getReadChunkPtr(KisChunk readChunk) {
-        return getReadChunkPtr(readChunk.data());
-    }
+    ~KisMemoryWindow() override;
 
-    inline quint8* getWriteChunkPtr(KisChunk writeChunk) {
-        return getWriteChunkPtr(writeChunk.data());
-    }
+    using KisAbstractSwapSpace::getReadChunkPtr;
+    using KisAbstractSwapSpace::getWriteChunkPtr;
 
-    quint8* getReadChunkPtr(const KisChunkData &readChunk);
-    quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
+    quint8* getReadChunkPtr(const KisChunkData &readChunk) override;
+    quint8* getWriteChunkPtr(const KisChunkData &writeChunk) override;
 
 private:
     struct MappingWindow {
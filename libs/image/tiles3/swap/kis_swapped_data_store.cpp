@@ -7,14 +7,21 @@
 //#include "kis_debug.h"
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
+#include "kis_mapped_swap_file.h"
 #include "kis_image_config.h"
 
 #include "kis_tile_compressor_2.h"
 
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrentMap>
+
 //#define COMPRESSOR_VERSION 2
 
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_memoryMetric(0)
+    : m_swappedOutBytes(0),
+      m_swapOutTime(0),
+      m_memoryMetric(0)
 {
     KisImageConfig config(true);
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
@@ -22,14 +29,32 @@ KisSwappedDataStore::KisSwappedDataStore()
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    m_swapSpace = 0;
+
+    if (config.useMappedSwapFile() && KisMappedSwapFile::isSupported()) {
+        KisMappedSwapFile *mappedFile =
+            new KisMappedSwapFile(config.swapDir(), maxSwapSize, swapSlabSize);
+
+        if (mappedFile->isValid()) {
+            m_swapSpace = mappedFile;
+        } else {
+            delete mappedFile;
+        }
+    }
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    if (!m_swapSpace) {
+        m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    }
+
+    m_compressionCodec = KisTileCompressor2::codecFromString(config.swapCompressionCodec());
+    m_compressionLevel = config.swapCompressionLevel();
+
+    m_compressor = createCompressor();
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
+    qDeleteAll(m_batchCompressors);
     delete m_compressor;
     delete m_swapSpace;
     delete m_allocator;
@@ -43,6 +68,12 @@ quint64 KisSwappedDataStore::numTiles() const
     return m_allocator->numChunks();
 }
 
+KisAbstractTileCompressor* KisSwappedDataStore::createCompressor() const
+{
+    return new KisTileCompressor2(KisTileCompressor2::Codec(m_compressionCodec),
+                                  m_compressionLevel);
+}
+
 bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 {
     Q_ASSERT(td->data());
@@ -54,6 +85,9 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
      * So we can modify the tile data freely.
      */
 
+    QElapsedTimer timer;
+    timer.start();
+
     const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
     if(m_buffer.size() < expectedBufferSize)
         m_buffer.resize(expectedBufferSize);
@@ -61,13 +95,31 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     qint32 bytesWritten;
     m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
 
+    const qint64 tileDataSize = qint64(td->pixelSize()) * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+    if (!writeCompressedTileData(td, (quint8*) m_buffer.data(), bytesWritten)) {
+        return false;
+    }
+
+    registerSwapOut(tileDataSize, timer.nsecsElapsed());
+
+    return true;
+}
+
+bool KisSwappedDataStore::writeCompressedTileData(KisTileData *td, const quint8 *buffer, qint32 bytesWritten)
+{
+    /**
+     * This function is called with m_lock acquired
+     */
+
     KisChunk chunk = m_allocator->getChunk(bytesWritten);
     quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
     if (!ptr) {
         qWarning() << "swap out of tile failed";
+        m_allocator->freeChunk(chunk);
         return false;
     }
-    memcpy(ptr, m_buffer.data(), bytesWritten);
+    memcpy(ptr, buffer, bytesWritten);
 
     td->releaseMemory();
     td->setSwapChunk(chunk);
@@ -77,6 +129,98 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     return true;
 }
 
+void KisSwappedDataStore::swapOutTileDataBatch(const QVector<KisTileData*> &batch)
+{
+    if (batch.isEmpty()) return;
+
+    /**
+     * Only one batch can be processed at a time, because the
+     * compressors and the buffers are shared between the batches.
+     * The swap file itself is protected by m_lock, which we take
+     * only for the sequential write-out stage.
+     */
+    QMutexLocker batchLocker(&m_batchLock);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int numWorkers = qBound(1, QThread::idealThreadCount(), batch.size());
+
+    while (m_batchCompressors.size() < numWorkers) {
+        m_batchCompressors.append(createCompressor());
+    }
+
+    m_batchBuffers.resize(batch.size());
+    QVector<qint32> bytesWritten(batch.size(), 0);
+
+    /**
+     * Every worker compresses its own contiguous slice of the batch
+     * with its own compressor, so no synchronization is needed here
+     */
+    QVector<int> workers(numWorkers);
+    for (int i = 0; i < numWorkers; i++) {
+        workers[i] = i;
+    }
+
+    auto compressSlice = [&] (int worker) {
+        KisAbstractTileCompressor *compressor = m_batchCompressors[worker];
+
+        const int begin = worker * batch.size() / numWorkers;
+        const int end = (worker + 1) * batch.size() / numWorkers;
+
+        for (int i = begin; i < end; i++) {
+            KisTileData *td = batch[i];
+            Q_ASSERT(td->data());
+
+            QByteArray &buffer = m_batchBuffers[i];
+
+            const qint32 expectedBufferSize = compressor->tileDataBufferSize(td);
+            if (buffer.size() < expectedBufferSize) {
+                buffer.resize(expectedBufferSize);
+            }
+
+            compressor->compressTileData(td, (quint8*) buffer.data(), buffer.size(), bytesWritten[i]);
+        }
+    };
+
+    if (numWorkers > 1) {
+        QtConcurrent::blockingMap(workers, compressSlice);
+    } else {
+        compressSlice(0);
+    }
+
+    qint64 swappedOutBytes = 0;
+
+    {
+        QMutexLocker locker(&m_lock);
+
+        for (int i = 0; i < batch.size(); i++) {
+            KisTileData *td = batch[i];
+            const qint64 tileDataSize = qint64(td->pixelSize()) * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+            if (writeCompressedTileData(td, (quint8*) m_batchBuffers[i].data(), bytesWritten[i])) {
+                swappedOutBytes += tileDataSize;
+            }
+        }
+    }
+
+    registerSwapOut(swappedOutBytes, timer.nsecsElapsed());
+}
+
+void KisSwappedDataStore::registerSwapOut(qint64 bytes, qint64 nsecs)
+{
+    m_swappedOutBytes.fetchAndAddRelaxed(bytes);
+    m_swapOutTime.fetchAndAddRelaxed(nsecs);
+}
+
+qint64 KisSwappedDataStore::swapOutThroughput() const
+{
+    const qint64 nsecs = m_swapOutTime.loadAcquire();
+    const qint64 bytes = m_swappedOutBytes.loadAcquire();
+
+    return nsecs > 0 ? qint64(qreal(bytes) / nsecs * 1e9) : 0;
+}
+
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
@@ -92,6 +236,7 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
     Q_ASSERT(ptr);
     m_compressor->decompressTileData(ptr, chunk.size(), td);
+    m_swapSpace->releaseChunk(chunk);
     m_allocator->freeChunk(chunk);
 
     m_memoryMetric -= td->pixelSize();
@@ -101,6 +246,7 @@ void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
+    m_swapSpace->releaseChunk(td->swapChunk());
     m_allocator->freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
 
@@ -11,13 +11,15 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QVector>
+#include <QAtomicInteger>
 
 
 class QMutex;
 class KisTileData;
 class KisAbstractTileCompressor;
 class KisChunkAllocator;
-class KisMemoryWindow;
+class KisAbstractSwapSpace;
 
 class KRITAIMAGE_EXPORT KisSwappedDataStore
 {
@@ -38,6 +40,17 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Swap out a batch of tile data objects. The tiles are
+     * compressed in parallel on the global thread pool and then
+     * written into the swap file sequentially. The tiles that have
+     * been swapped out successfully have their data() released,
+     * the others are left untouched.
+     * LOCKING: the locks of all the tile datas should be taken
+     *          by the caller before making a call.
+     */
+    void swapOutTileDataBatch(const QVector<KisTileData*> &batch);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -59,17 +72,42 @@ public:
      */
     qint64 totalMemoryMetric() const;
 
+    /**
+     * Returns the average speed of swapping out in bytes per second,
+     * measured by the *uncompressed* size of the tile data
+     */
+    qint64 swapOutThroughput() const;
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
+private:
+    KisAbstractTileCompressor* createCompressor() const;
+    bool writeCompressedTileData(KisTileData *td, const quint8 *buffer, qint32 bytesWritten);
+    void registerSwapOut(qint64 bytes, qint64 nsecs);
+
 private:
     QByteArray m_buffer;
     KisAbstractTileCompressor *m_compressor;
 
+    int m_compressionCodec;
+    int m_compressionLevel;
+
+    /**
+     * Compressors and buffers used by the workers of
+     * swapOutTileDataBatch(), one per worker
+     */
+    QVector<KisAbstractTileCompressor*> m_batchCompressors;
+    QVector<QByteArray> m_batchBuffers;
+    QMutex m_batchLock;
+
+    QAtomicInteger<qint64> m_swappedOutBytes;
+    QAtomicInteger<qint64> m_swapOutTime;
+
     KisChunkAllocator *m_allocator;
-    KisMemoryWindow *m_swapSpace;
+    KisAbstractSwapSpace *m_swapSpace;
 
     QMutex m_lock;
 
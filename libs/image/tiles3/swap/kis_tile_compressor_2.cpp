@@ -8,21 +8,167 @@
 #include "kis_lzf_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
-#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
+#include <config-swap-compression.h>
+
+#ifdef HAVE_LZ4
+#include "kis_lz4_compression.h"
+#endif
+
+#ifdef HAVE_ZSTD
+#include "kis_zstd_compression.h"
+#endif
+
+#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
 
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(Codec codec, int level)
+    : m_codec(isCodecSupported(codec) ? codec : LZF),
+      m_level(level)
 {
-    m_compression = new KisLzfCompression();
+    if (m_codec != codec) {
+        warnKrita << "Tile compression codec" << codecToString(codec)
+                  << "is not supported by this build. Falling back to LZF.";
+    }
+
+    m_compression = createCompression(m_codec, m_level);
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
+    qDeleteAll(m_extraDecompressors);
     delete m_compression;
 }
 
+KisTileCompressor2::Codec KisTileCompressor2::codec() const
+{
+    return m_codec;
+}
+
+bool KisTileCompressor2::isCodecSupported(Codec codec)
+{
+    switch (codec) {
+    case LZF:
+        return true;
+    case LZ4:
+#ifdef HAVE_LZ4
+        return true;
+#else
+        return false;
+#endif
+    case ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+KisTileCompressor2::Codec KisTileCompressor2::codecFromString(const QString &name)
+{
+    const QString lowerName = name.toLower();
+
+    return lowerName == "lz4" ? LZ4 :
+        lowerName == "zstd" ? ZSTD :
+        LZF;
+}
+
+QString KisTileCompressor2::codecToString(Codec codec)
+{
+    return compressionName(codec).toLower();
+}
+
+QString KisTileCompressor2::compressionName(Codec codec)
+{
+    switch (codec) {
+    case LZ4:
+        return "LZ4";
+    case ZSTD:
+        return "ZSTD";
+    case LZF:
+        break;
+    }
+
+    return "LZF";
+}
+
+qint8 KisTileCompressor2::compressedDataFlag(Codec codec)
+{
+    switch (codec) {
+    case LZ4:
+        return LZ4_COMPRESSED_DATA_FLAG;
+    case ZSTD:
+        return ZSTD_COMPRESSED_DATA_FLAG;
+    case LZF:
+        break;
+    }
+
+    return COMPRESSED_DATA_FLAG;
+}
+
+KisAbstractCompression* KisTileCompressor2::createCompression(Codec codec, int level)
+{
+    Q_UNUSED(level);
+
+    switch (codec) {
+    case LZ4:
+#ifdef HAVE_LZ4
+        return new KisLz4Compression(level);
+#else
+        break;
+#endif
+    case ZSTD:
+#ifdef HAVE_ZSTD
+        return new KisZstdCompression(level);
+#else
+        break;
+#endif
+    case LZF:
+        break;
+    }
+
+    return new KisLzfCompression();
+}
+
+KisAbstractCompression* KisTileCompressor2::compressionForFlag(qint8 flag)
+{
+    if (flag == compressedDataFlag(m_codec)) {
+        return m_compression;
+    }
+
+    KisAbstractCompression *compression = m_extraDecompressors.value(flag, 0);
+
+    if (!compression) {
+        Codec codec;
+
+        switch (flag) {
+        case COMPRESSED_DATA_FLAG:
+            codec = LZF;
+            break;
+        case LZ4_COMPRESSED_DATA_FLAG:
+            codec = LZ4;
+            break;
+        case ZSTD_COMPRESSED_DATA_FLAG:
+            codec = ZSTD;
+            break;
+        default:
+            return 0;
+        }
+
+        if (!isCodecSupported(codec)) {
+            return 0;
+        }
+
+        compression = createCompression(codec, m_level);
+        m_extraDecompressors.insert(flag, compression);
+    }
+
+    return compression;
+}
+
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
     const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
@@ -59,11 +205,20 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
     if (headerItems.size() == 4) {
         qint32 x = headerItems.takeFirst().toInt();
         qint32 y = headerItems.takeFirst().toInt();
-        QString compressionName = headerItems.takeFirst();
+        QString codecName = headerItems.takeFirst();
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        /**
+         * The actual codec is recorded in the first byte of the
+         * tile data, so here we only check the name for sanity
+         */
+        const Codec codec = codecFromString(codecName);
+        if (codecName != compressionName(codec) || !isCodecSupported(codec)) {
+            warnFile << "Unsupported tile compression:" << codecName;
+            return false;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -117,8 +272,8 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
-        buffer[0] = COMPRESSED_DATA_FLAG;
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
+        buffer[0] = compressedDataFlag(m_codec);
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
@@ -136,12 +291,18 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
-    if(buffer[0] == COMPRESSED_DATA_FLAG) {
+    if(buffer[0] != RAW_DATA_FLAG) {
+        KisAbstractCompression *compression = compressionForFlag(buffer[0]);
+        if (!compression) {
+            warnKrita << "Unknown tile compression flag:" << int(buffer[0]);
+            return false;
+        }
+
         prepareWorkBuffers(tileDataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
                                                       tileData->data(),
@@ -179,5 +340,5 @@ inline QString KisTileCompressor2::getHeader(KisTileSP tile,
     qint32 width, height;
     tile->extent().getRect(&x, &y, &width, &height);
 
-    return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(m_compressionName).arg(compressedSize);
+    return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(compressionName(m_codec)).arg(compressedSize);
 }
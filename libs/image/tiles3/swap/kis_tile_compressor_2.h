@@ -9,14 +9,49 @@
 
 #include "kis_abstract_tile_compressor.h"
 
+#include <QHash>
+
 class KisAbstractCompression;
 
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    /**
+     * The algorithm used for compressing the tile data. The codec
+     * is recorded in the header of every compressed tile, so the
+     * compressor can decompress the data written by any codec,
+     * independently of the one it has been created with.
+     */
+    enum Codec {
+        LZF = 0,
+        LZ4,
+        ZSTD
+    };
+
+public:
+    /**
+     * \p level is passed to the codec unchanged. For Zstd it is the
+     * compression level, for LZ4 it is an acceleration factor, LZF
+     * ignores it. If \p codec is not supported by the current build,
+     * the compressor falls back to LZF.
+     */
+    KisTileCompressor2(Codec codec = LZF, int level = 1);
     ~KisTileCompressor2() override;
 
+    Codec codec() const;
+
+    /**
+     * Returns true if the codec has been compiled in
+     */
+    static bool isCodecSupported(Codec codec);
+
+    /**
+     * Converts the config-like name of the codec ("lzf", "lz4", "zstd")
+     * into the codec id. Unknown names are mapped to LZF.
+     */
+    static Codec codecFromString(const QString &name);
+    static QString codecToString(Codec codec);
+
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *io, KisTiledDataManager *dm) override;
 
@@ -37,16 +72,40 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    KisAbstractCompression* compressionForFlag(qint8 flag);
+
+    static KisAbstractCompression* createCompression(Codec codec, int level);
+    static QString compressionName(Codec codec);
+
 private:
+    /**
+     * The first byte of every compressed tile is a header that
+     * records the way the rest of the buffer is encoded. Values
+     * RAW_DATA_FLAG and COMPRESSED_DATA_FLAG are the ones written
+     * by the first version of the compressor (LZF only), so the old
+     * data is still readable. Newer codecs have their own flags.
+     */
     static const qint8 RAW_DATA_FLAG = 0;
     static const qint8 COMPRESSED_DATA_FLAG = 1;
+    static const qint8 LZ4_COMPRESSED_DATA_FLAG = 2;
+    static const qint8 ZSTD_COMPRESSED_DATA_FLAG = 3;
+
+    static qint8 compressedDataFlag(Codec codec);
 
 private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+
+    Codec m_codec;
+    int m_level;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+
+    /**
+     * Decompressors for the tiles written with a codec
+     * different from m_codec. Created on demand.
+     */
+    QHash<qint8, KisAbstractCompression*> m_extraDecompressors;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
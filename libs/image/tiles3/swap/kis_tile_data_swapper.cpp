@@ -11,12 +11,14 @@
 #include "tiles3/kis_tile_data.h"
 #include "tiles3/kis_tile_data_store.h"
 #include "tiles3/kis_tile_data_store_iterators.h"
+#include "KisSchedulerTracer.h"
 #include "kis_debug.h"
 
 #define SEC 1000
 
 const qint32 KisTileDataSwapper::TIMEOUT = -1;
 const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
+const qint32 KisTileDataSwapper::BATCH_SIZE = 64;
 
 //#define DEBUG_SWAPPER
 
@@ -30,6 +32,8 @@ const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
 
 class SoftSwapStrategy;
 class AggressiveSwapStrategy;
+class OwnerSwapStrategy;
+class InactiveSwapStrategy;
 
 
 struct Q_DECL_HIDDEN KisTileDataSwapper::Private
@@ -102,6 +106,7 @@ void KisTileDataSwapper::doJob()
      * to this function as well
      */
     QMutexLocker locker(&m_d->cycleLock);
+    KisSchedulerTracer::Scope tracerScope(KisSchedulerTracer::Swapper, "swap cycle");
 
     qint32 memoryMetric = m_d->store->memoryMetric();
 
@@ -114,6 +119,40 @@ void KisTileDataSwapper::doJob()
     DEBUG_VALUE(m_d->limits.hardLimitThreshold());
 
 
+    if (m_d->limits.historicalLimitThreshold() > 0) {
+        const qint64 historicalMetric = m_d->store->historicalMemoryMetric();
+        DEBUG_VALUE(historicalMetric);
+        DEBUG_VALUE(m_d->limits.historicalLimitThreshold());
+
+        if (historicalMetric > m_d->limits.historicalLimitThreshold()) {
+            qint64 historicalFree = historicalMetric - m_d->limits.historicalLimit();
+            DEBUG_VALUE(historicalFree);
+            DEBUG_ACTION("\t history pass");
+            memoryMetric -= pass<SoftSwapStrategy>(historicalFree);
+            DEBUG_VALUE(memoryMetric);
+        }
+    }
+
+    if (m_d->limits.inactiveDocumentLimitThreshold() > 0) {
+        const int activeOwner = m_d->store->activeMemoryOwner();
+        const QHash<int, qint64> ownersMetric = m_d->store->memoryOwnersMetric();
+
+        for (auto it = ownersMetric.constBegin(); it != ownersMetric.constEnd(); ++it) {
+            if (it.key() == activeOwner ||
+                it.value() <= m_d->limits.inactiveDocumentLimitThreshold()) {
+
+                continue;
+            }
+
+            qint64 ownerFree = it.value() - m_d->limits.inactiveDocumentLimit();
+            DEBUG_VALUE(it.key());
+            DEBUG_VALUE(ownerFree);
+            DEBUG_ACTION("\t inactive document pass");
+            memoryMetric -= pass<OwnerSwapStrategy>(ownerFree, OwnerSwapStrategy(it.key()));
+            DEBUG_VALUE(memoryMetric);
+        }
+    }
+
     if(memoryMetric > m_d->limits.softLimitThreshold()) {
         qint32 softFree =  memoryMetric - m_d->limits.softLimit();
         DEBUG_VALUE(softFree);
@@ -125,6 +164,15 @@ void KisTileDataSwapper::doJob()
             qint32 hardFree =  memoryMetric - m_d->limits.hardLimit();
             DEBUG_VALUE(hardFree);
             DEBUG_ACTION("\t pass1");
+            memoryMetric -= pass<InactiveSwapStrategy>(hardFree,
+                InactiveSwapStrategy(m_d->store->activeMemoryOwner()));
+            DEBUG_VALUE(memoryMetric);
+        }
+
+        if(memoryMetric > m_d->limits.hardLimitThreshold()) {
+            qint32 hardFree =  memoryMetric - m_d->limits.hardLimit();
+            DEBUG_VALUE(hardFree);
+            DEBUG_ACTION("\t pass2");
             memoryMetric -= pass<AggressiveSwapStrategy>(hardFree);
             DEBUG_VALUE(memoryMetric);
         }
@@ -179,29 +227,119 @@ public:
     }
 };
 
+/**
+ * Swaps out the tiles of a single document. The clock iterator
+ * together with the age of the tiles gives us an approximation
+ * of LRU order inside the document.
+ */
+class OwnerSwapStrategy
+{
+public:
+    typedef KisTileDataStoreClockIterator iterator;
+
+    OwnerSwapStrategy(int owner = 0) : m_owner(owner) {}
+
+    static inline iterator* beginIteration(KisTileDataStore *store) {
+        return store->beginClockIteration();
+    }
+
+    static inline void endIteration(KisTileDataStore *store, iterator *iter) {
+        store->endIteration(iter);
+    }
+
+    inline bool isInteresting(KisTileData *td) const {
+        return td->memoryOwner() == m_owner;
+    }
+
+    static inline bool swapOutFirst(KisTileData *td) {
+        return td->age() > 0;
+    }
+
+private:
+    int m_owner;
+};
+
+/**
+ * Swaps out the tiles of invisible layers and of all the documents
+ * except the active one. Used before the aggressive pass, so that
+ * the working tiles of the active document are the last ones to
+ * be swapped out.
+ */
+class InactiveSwapStrategy
+{
+public:
+    typedef KisTileDataStoreClockIterator iterator;
+
+    InactiveSwapStrategy(int activeOwner = 0) : m_activeOwner(activeOwner) {}
+
+    static inline iterator* beginIteration(KisTileDataStore *store) {
+        return store->beginClockIteration();
+    }
+
+    static inline void endIteration(KisTileDataStore *store, iterator *iter) {
+        store->endIteration(iter);
+    }
+
+    inline bool isInteresting(KisTileData *td) const {
+        const int owner = td->memoryOwner();
+        return td->lowMemoryPriority() || (owner && owner != m_activeOwner);
+    }
+
+    static inline bool swapOutFirst(KisTileData *td) {
+        return td->age() > 0;
+    }
+
+private:
+    int m_activeOwner;
+};
+
 
 template<class strategy>
-qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
+qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric, const strategy &s)
 {
     qint64 freedMetric = 0;
     QList<KisTileData*> additionalCandidates;
 
+    /**
+     * The victims are collected into batches, which are compressed
+     * in parallel by the swapped store. \p pendingMetric is the
+     * metric of the tiles that are waiting in the current batch.
+     */
+    QVector<KisTileData*> batch;
+    batch.reserve(BATCH_SIZE);
+    qint64 pendingMetric = 0;
+
     typename strategy::iterator *iter =
         strategy::beginIteration(m_d->store);
 
+    auto flushBatch = [&] () {
+        if (!batch.isEmpty()) {
+            freedMetric += iter->trySwapOutBatch(batch);
+            batch.clear();
+            pendingMetric = 0;
+        }
+    };
+
+    auto addToBatch = [&] (KisTileData *td) {
+        batch.append(td);
+        pendingMetric += td->pixelSize();
+
+        if (batch.size() >= BATCH_SIZE) {
+            flushBatch();
+        }
+    };
+
     KisTileData *item = 0;
 
     while (iter->hasNext()) {
         item = iter->next();
 
-        if (freedMetric >= needToFreeMetric) break;
+        if (freedMetric + pendingMetric >= needToFreeMetric) break;
 
-        if (!strategy::isInteresting(item)) continue;
+        if (!s.isInteresting(item)) continue;
 
-        if (strategy::swapOutFirst(item)) {
-            if (iter->trySwapOut(item)) {
-                freedMetric += item->pixelSize();
-            }
+        if (s.swapOutFirst(item)) {
+            addToBatch(item);
         }
         else {
             item->markOld();
@@ -210,14 +348,16 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 
     }
 
+    flushBatch();
+
     Q_FOREACH (item, additionalCandidates) {
-        if (freedMetric >= needToFreeMetric) break;
+        if (freedMetric + pendingMetric >= needToFreeMetric) break;
 
-        if (iter->trySwapOut(item)) {
-            freedMetric += item->pixelSize();
-        }
+        addToBatch(item);
     }
 
+    flushBatch();
+
     strategy::endIteration(m_d->store, iter);
 
     return freedMetric;
@@ -35,11 +35,13 @@ private:
     void run() override;
 
     void doJob();
-    template<class strategy> qint64 pass(qint64 needToFreeMetric);
+    template<class strategy> qint64 pass(qint64 needToFreeMetric,
+                                         const strategy &s = strategy());
 
 private:
     static const qint32 TIMEOUT;
     static const qint32 DELAY;
+    static const qint32 BATCH_SIZE;
 
 private:
     struct Private;
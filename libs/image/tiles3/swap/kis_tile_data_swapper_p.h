@@ -57,6 +57,12 @@ public:
 
         m_softLimitThreshold = qBound(0, MiB_TO_METRIC(config.tilesSoftLimit()), m_hardLimitThreshold);
         m_softLimit = m_softLimitThreshold - m_softLimitThreshold / 8;
+
+        m_historicalLimitThreshold = qBound(0, MiB_TO_METRIC(config.undoMemoryLimit()), m_hardLimitThreshold);
+        m_historicalLimit = m_historicalLimitThreshold - m_historicalLimitThreshold / 8;
+
+        m_inactiveDocumentLimitThreshold = qBound(0, MiB_TO_METRIC(config.inactiveDocumentMemoryLimit()), m_hardLimitThreshold);
+        m_inactiveDocumentLimit = m_inactiveDocumentLimitThreshold - m_inactiveDocumentLimitThreshold / 8;
     }
 
     /**
@@ -83,12 +89,44 @@ public:
         return m_softLimit;
     }
 
+    /**
+     * The limits for the memento tiles present in memory. They
+     * work independently from the diagram above. Zero threshold
+     * means there is no such limit.
+     */
+
+    inline qint32 historicalLimitThreshold() {
+        return m_historicalLimitThreshold;
+    }
+
+    inline qint32 historicalLimit() {
+        return m_historicalLimit;
+    }
+
+    /**
+     * The limits for the tiles of every document, except the
+     * active one, present in memory. Zero threshold means there
+     * is no such limit.
+     */
+
+    inline qint32 inactiveDocumentLimitThreshold() {
+        return m_inactiveDocumentLimitThreshold;
+    }
+
+    inline qint32 inactiveDocumentLimit() {
+        return m_inactiveDocumentLimit;
+    }
+
 private:
     qint32 m_emergencyThreshold;
     qint32 m_hardLimitThreshold;
     qint32 m_hardLimit;
     qint32 m_softLimitThreshold;
     qint32 m_softLimit;
+    qint32 m_historicalLimitThreshold;
+    qint32 m_historicalLimit;
+    qint32 m_inactiveDocumentLimitThreshold;
+    qint32 m_inactiveDocumentLimit;
 };
 
 
@@ -0,0 +1,42 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZSTD_COMPRESSION_H
+#define __KIS_ZSTD_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+/**
+ * A wrapper around Zstandard library. It gives much better compression
+ * ratio than LZF on painted data, at the cost of some extra CPU time on
+ * swapping out. The \p level is passed to ZSTD_compressCCtx() directly,
+ * low levels (1-3) are recommended for the swap file.
+ *
+ * The compression/decompression contexts are cached inside the object,
+ * so the object should not be used from several threads at once (which
+ * is the case for all other compressions as well).
+ */
+class KRITAIMAGE_EXPORT KisZstdCompression : public KisAbstractCompression
+{
+public:
+    KisZstdCompression(int level = 1);
+    ~KisZstdCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    int m_level;
+    ZSTD_CCtx_s *m_compressionContext;
+    ZSTD_DCtx_s *m_decompressionContext;
+};
+
+#endif /* __KIS_ZSTD_COMPRESSION_H */
@@ -15,11 +15,12 @@
 #include "tiles_test_utils.h"
 
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_mapped_swap_file.h"
 
 
 #define COLUMN2COLOR(col) (col%255)
 
-void KisSwappedDataStoreTest::testRoundTrip()
+void KisSwappedDataStoreTest::doTestRoundTrip(bool useMappedSwapFile)
 {
     const qint32 pixelSize = 1;
     const quint8 defaultPixel = 128;
@@ -29,6 +30,7 @@ void KisSwappedDataStoreTest::testRoundTrip()
     config.setMaxSwapSize(4);
     config.setSwapSlabSize(1);
     config.setSwapWindowSize(1);
+    config.setUseMappedSwapFile(useMappedSwapFile);
 
 
     KisSwappedDataStore store;
@@ -83,7 +85,7 @@ void KisSwappedDataStoreTest::processTileData(qint32 column, KisTileData *td, Ki
     }
 }
 
-void KisSwappedDataStoreTest::testRandomAccess()
+void KisSwappedDataStoreTest::doTestRandomAccess(bool useMappedSwapFile)
 {
     qsrand(10);
     const qint32 pixelSize = 1;
@@ -95,6 +97,7 @@ void KisSwappedDataStoreTest::testRandomAccess()
     config.setMaxSwapSize(40);
     config.setSwapSlabSize(1);
     config.setSwapWindowSize(1);
+    config.setUseMappedSwapFile(useMappedSwapFile);
 
 
     KisSwappedDataStore store;
@@ -119,5 +122,83 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testRoundTrip()
+{
+    doTestRoundTrip(false);
+}
+
+void KisSwappedDataStoreTest::testRandomAccess()
+{
+    doTestRandomAccess(false);
+}
+
+void KisSwappedDataStoreTest::testRoundTripMapped()
+{
+    if (!KisMappedSwapFile::isSupported()) {
+        QSKIP("Mapped swap file is not supported on this platform");
+    }
+
+    doTestRoundTrip(true);
+
+    KisImageConfig config(false);
+    config.setUseMappedSwapFile(false);
+}
+
+void KisSwappedDataStoreTest::testRandomAccessMapped()
+{
+    if (!KisMappedSwapFile::isSupported()) {
+        QSKIP("Mapped swap file is not supported on this platform");
+    }
+
+    doTestRandomAccess(true);
+
+    KisImageConfig config(false);
+    config.setUseMappedSwapFile(false);
+}
+
+void KisSwappedDataStoreTest::testBatchRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 1000;
+    const qint32 BATCH_SIZE = 64;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+
+    KisSwappedDataStore store;
+
+    QVector<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        memset(tileDataList[i]->data(), COLUMN2COLOR(i), TILESIZE);
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i += BATCH_SIZE) {
+        // FIXME: take a lock of the tile data
+        store.swapOutTileDataBatch(tileDataList.mid(i, BATCH_SIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+    QVERIFY(store.swapOutThroughput() > 0);
+
+    store.debugStatistics();
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    qDeleteAll(tileDataList);
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
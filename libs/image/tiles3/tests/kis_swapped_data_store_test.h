@@ -18,10 +18,18 @@ class KisSwappedDataStoreTest : public QObject
 private:
     void processTileData(qint32 column, KisTileData *td, KisSwappedDataStore &store);
 
+    void doTestRoundTrip(bool useMappedSwapFile);
+    void doTestRandomAccess(bool useMappedSwapFile);
+
 private Q_SLOTS:
     void testRoundTrip();
     void testRandomAccess();
 
+    void testRoundTripMapped();
+    void testRandomAccessMapped();
+
+    void testBatchRoundTrip();
+
 };
 
 #endif /* KIS_SWAPPED_DATA_STORE_TEST_H */
@@ -167,6 +167,80 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testLowLevelRoundTripLz4()
+{
+    if (!KisTileCompressor2::isCodecSupported(KisTileCompressor2::LZ4)) {
+        QSKIP("LZ4 is not supported by this build");
+    }
+
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::LZ4);
+    doLowLevelRoundTrip(compressor);
+    doLowLevelRoundTripIncompressible(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripZstd()
+{
+    if (!KisTileCompressor2::isCodecSupported(KisTileCompressor2::ZSTD)) {
+        QSKIP("Zstd is not supported by this build");
+    }
+
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::ZSTD, 3);
+    doLowLevelRoundTrip(compressor);
+    doLowLevelRoundTripIncompressible(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testCrossCodecDecompression()
+{
+    const qint32 pixelSize = 1;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager dm(pixelSize, &oddPixel1);
+    KisTileSP tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+
+    KisTileData *td = tile->tileData();
+
+    QList<KisTileCompressor2::Codec> codecs;
+    codecs << KisTileCompressor2::LZF
+           << KisTileCompressor2::LZ4
+           << KisTileCompressor2::ZSTD;
+
+    /**
+     * The codec is recorded in the tile header, so the data
+     * compressed with any codec should be readable by the
+     * compressor created for any other codec
+     */
+    Q_FOREACH (KisTileCompressor2::Codec writeCodec, codecs) {
+        if (!KisTileCompressor2::isCodecSupported(writeCodec)) continue;
+
+        Q_FOREACH (KisTileCompressor2::Codec readCodec, codecs) {
+            if (!KisTileCompressor2::isCodecSupported(readCodec)) continue;
+
+            KisTileCompressor2 writer(writeCodec);
+            KisTileCompressor2 reader(readCodec);
+
+            memset(td->data(), oddPixel1, TILESIZE);
+
+            qint32 bufferSize = writer.tileDataBufferSize(td);
+            quint8 *buffer = new quint8[bufferSize];
+            qint32 bytesWritten;
+            writer.compressTileData(td, buffer, bufferSize, bytesWritten);
+
+            memset(td->data(), oddPixel2, TILESIZE);
+
+            QVERIFY(reader.decompressTileData(buffer, bytesWritten, td));
+            QVERIFY(memoryIsFilled(oddPixel1, td->data(), TILESIZE));
+
+            delete[] buffer;
+        }
+    }
+
+    tile->unlockForWrite();
+}
+
 
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
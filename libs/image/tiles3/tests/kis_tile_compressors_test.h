@@ -26,6 +26,10 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testLowLevelRoundTripLz4();
+    void testLowLevelRoundTripZstd();
+    void testCrossCodecDecompression();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
@@ -8,6 +8,8 @@
 #include <simpletest.h>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_image_config.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -527,6 +529,429 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
     QVERIFY(memoryIsFilled(oddPixel2, tile10->data(), TILESIZE));
 }
 
+void KisTiledDataManagerTest::testShareUniformTiles()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    QRect fillRect(0,0,192,64);
+    QByteArray buffer(fillRect.width() * fillRect.height(), oddPixel1);
+
+    // make the last tile non-uniform
+    buffer[190] = oddPixel2;
+
+    KisMementoSP memento1 = dm.getMemento();
+    dm.writeBytes((quint8*)buffer.data(),
+                  fillRect.x(), fillRect.y(),
+                  fillRect.width(), fillRect.height());
+    dm.commit();
+
+    KisTileSP tile00 = dm.getTile(0, 0, false);
+    KisTileSP tile10 = dm.getTile(1, 0, false);
+    KisTileSP tile20 = dm.getTile(2, 0, false);
+
+    QCOMPARE(tile00->tileData(), tile10->tileData());
+    QVERIFY(tile00->tileData() != tile20->tileData());
+    QVERIFY(memoryIsFilled(oddPixel1, tile00->data(), TILESIZE));
+    QVERIFY(memoryIsFilled(oddPixel1, tile10->data(), TILESIZE));
+    QCOMPARE(tile20->data()[62], oddPixel2);
+
+    KisTileData *uniformTileData = tile00->tileData();
+    tile00 = tile10 = tile20 = 0;
+
+    // writing into a shared tile should detach it
+
+    KisMementoSP memento2 = dm.getMemento();
+    dm.setPixel(1, 1, &oddPixel2);
+    dm.commit();
+
+    tile00 = dm.getTile(0, 0, false);
+    tile10 = dm.getTile(1, 0, false);
+
+    QVERIFY(tile00->tileData() != uniformTileData);
+    QCOMPARE(tile10->tileData(), uniformTileData);
+    QCOMPARE(tile00->data()[65], oddPixel2);
+    QVERIFY(memoryIsFilled(oddPixel1, tile10->data(), TILESIZE));
+    tile00 = tile10 = 0;
+
+    dm.rollback(memento2);
+
+    tile00 = dm.getTile(0, 0, false);
+    tile10 = dm.getTile(1, 0, false);
+
+    QCOMPARE(tile00->tileData(), uniformTileData);
+    QCOMPARE(tile10->tileData(), uniformTileData);
+    QVERIFY(memoryIsFilled(oddPixel1, tile00->data(), TILESIZE));
+    tile00 = tile10 = 0;
+
+    dm.rollback(memento1);
+
+    tile00 = dm.getTile(0, 0, false);
+    QVERIFY(memoryIsFilled(defaultPixel, tile00->data(), TILESIZE));
+}
+
+void KisTiledDataManagerTest::testDeduplicateTiles()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setTileDataDeduplication(true);
+    }
+    store->testingRereadConfig();
+    store->testingSuspendPooler();
+
+    const qint64 deduplicatedBefore = store->memoryStatistics().deduplicatedSize;
+
+    {
+        quint8 defaultPixel = 0;
+        KisTiledDataManager dm1(1, &defaultPixel);
+        KisTiledDataManager dm2(1, &defaultPixel);
+
+        QRect tileRect(0,0,64,64);
+        QByteArray buffer(tileRect.width() * tileRect.height(), 0);
+        for (int i = 0; i < buffer.size(); i++) {
+            buffer[i] = i % 251;
+        }
+
+        KisMementoSP memento1 = dm1.getMemento();
+        dm1.writeBytes((quint8*)buffer.data(),
+                       tileRect.x(), tileRect.y(),
+                       tileRect.width(), tileRect.height());
+        dm1.commit();
+
+        store->m_pooler.forceHashTileDatas();
+
+        KisMementoSP memento2 = dm2.getMemento();
+        dm2.writeBytes((quint8*)buffer.data(),
+                       tileRect.x(), tileRect.y(),
+                       tileRect.width(), tileRect.height());
+        dm2.commit();
+
+        KisTileSP tile1 = dm1.getTile(0, 0, false);
+        KisTileSP tile2 = dm2.getTile(0, 0, false);
+
+        QCOMPARE(tile1->tileData(), tile2->tileData());
+        QCOMPARE(store->memoryStatistics().deduplicatedSize - deduplicatedBefore,
+                 qint64(tileRect.width() * tileRect.height()));
+        tile1 = tile2 = 0;
+
+        // writing into the shared tile should not affect the other device
+
+        quint8 oddPixel = 255;
+
+        KisMementoSP memento3 = dm2.getMemento();
+        dm2.setPixel(1, 1, &oddPixel);
+        dm2.commit();
+
+        tile1 = dm1.getTile(0, 0, false);
+        tile2 = dm2.getTile(0, 0, false);
+
+        QVERIFY(tile1->tileData() != tile2->tileData());
+        QVERIFY(!memcmp(tile1->data(), buffer.constData(), buffer.size()));
+        QCOMPARE(tile2->data()[65], oddPixel);
+        tile1 = tile2 = 0;
+    }
+
+    // when the devices and their history are gone, nothing is saved anymore
+    QCOMPARE(store->memoryStatistics().deduplicatedSize, deduplicatedBefore);
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setTileDataDeduplication(false);
+    }
+    store->testingRereadConfig();
+    store->testingResumePooler();
+}
+
+void KisTiledDataManagerTest::testCompactHistory()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUndoCompactionDepth(1);
+    }
+    store->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+    quint8 oddPixel3 = 130;
+    quint8 oddPixel4 = 131;
+
+    KisMementoSP memento1 = dm.getMemento();
+    dm.clear(0, 0, 128, 64, &oddPixel1);
+    dm.commit();
+
+    KisMementoSP memento2 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, &oddPixel2);
+    dm.commit();
+
+    KisMementoSP memento3 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, &oddPixel3);
+    dm.commit();
+
+    KisMementoSP memento4 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, &oddPixel4);
+    dm.commit();
+
+    /**
+     * The first three revisions have been merged, so only the
+     * latest one can be undone separately
+     */
+
+    auto checkPixels = [&dm] (quint8 pixel00, quint8 pixel10) {
+        KisTileSP tile00 = dm.getTile(0, 0, false);
+        KisTileSP tile10 = dm.getTile(1, 0, false);
+        return memoryIsFilled(pixel00, tile00->data(), TILESIZE) &&
+            memoryIsFilled(pixel10, tile10->data(), TILESIZE);
+    };
+
+    QVERIFY(checkPixels(oddPixel4, oddPixel1));
+
+    dm.rollback(memento4);
+    QVERIFY(checkPixels(oddPixel3, oddPixel1));
+
+    dm.rollback(memento3);
+    QVERIFY(checkPixels(defaultPixel, defaultPixel));
+
+    dm.rollback(memento2);
+    dm.rollback(memento1);
+    QVERIFY(checkPixels(defaultPixel, defaultPixel));
+
+    dm.rollforward(memento1);
+    dm.rollforward(memento2);
+    QVERIFY(checkPixels(defaultPixel, defaultPixel));
+
+    dm.rollforward(memento3);
+    QVERIFY(checkPixels(oddPixel3, oddPixel1));
+
+    dm.rollforward(memento4);
+    QVERIFY(checkPixels(oddPixel4, oddPixel1));
+
+    QCOMPARE(memento3->extent(), QRect(0, 0, 128, 64));
+
+    dm.purgeHistory(memento2);
+    dm.purgeHistory(memento4);
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUndoCompactionDepth(0);
+    }
+    store->testingRereadConfig();
+}
+
+void KisTiledDataManagerTest::testCompactHistoryInterleaved()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUndoCompactionDepth(1);
+    }
+    store->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+    quint8 oddPixel3 = 130;
+    quint8 oddPixel4 = 131;
+    quint8 oddPixel5 = 132;
+
+    /**
+     * The commands are undone in the order of the image-global
+     * undo stack: memento5, ..., memento1
+     */
+
+    KisMementoSP memento1 = dm1.getMemento();
+    dm1.clear(0, 0, 64, 64, &oddPixel1);
+    dm1.commit();
+
+    KisMementoSP memento2 = dm2.getMemento();
+    dm2.clear(0, 0, 64, 64, &oddPixel2);
+    dm2.commit();
+
+    KisMementoSP memento3 = dm1.getMemento();
+    dm1.clear(0, 0, 64, 64, &oddPixel3);
+    dm1.commit();
+
+    KisMementoSP memento4 = dm1.getMemento();
+    dm1.clear(0, 0, 64, 64, &oddPixel4);
+    dm1.commit();
+
+    // a command that doesn't touch the devices
+    store->notifyUndoHistoryChanged();
+    store->notifyUndoHistoryChanged();
+
+    KisMementoSP memento5 = dm1.getMemento();
+    dm1.clear(0, 0, 64, 64, &oddPixel5);
+    dm1.commit();
+
+    KisMementoSP memento6 = dm1.getMemento();
+    dm1.clear(0, 0, 64, 64, &defaultPixel);
+    dm1.commit();
+
+    auto checkPixels = [&dm1, &dm2] (quint8 pixel1, quint8 pixel2) {
+        KisTileSP tile1 = dm1.getTile(0, 0, false);
+        KisTileSP tile2 = dm2.getTile(0, 0, false);
+        return memoryIsFilled(pixel1, tile1->data(), TILESIZE) &&
+            memoryIsFilled(pixel2, tile2->data(), TILESIZE);
+    };
+
+    dm1.rollback(memento6);
+    QVERIFY(checkPixels(oddPixel5, oddPixel2));
+
+    // memento4 and memento5 are separated by another command
+    dm1.rollback(memento5);
+    QVERIFY(checkPixels(oddPixel4, oddPixel2));
+
+    // memento3 and memento4 are adjacent, so they have been merged
+    dm1.rollback(memento4);
+    QVERIFY(checkPixels(oddPixel1, oddPixel2));
+
+    dm1.rollback(memento3);
+    QVERIFY(checkPixels(oddPixel1, oddPixel2));
+
+    // memento1 is separated from memento3 by the command on dm2
+    dm2.rollback(memento2);
+    QVERIFY(checkPixels(oddPixel1, defaultPixel));
+
+    dm1.rollback(memento1);
+    QVERIFY(checkPixels(defaultPixel, defaultPixel));
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUndoCompactionDepth(0);
+    }
+    store->testingRereadConfig();
+}
+
+void KisTiledDataManagerTest::testJournalHistory()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    KisMementoJournal *journal = store->mementoJournal();
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUndoJournalDepth(1);
+    }
+    store->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    QRect tileRect(0,0,64,64);
+    QVector<QByteArray> buffers;
+    QVector<KisMementoSP> mementos;
+
+    for (int i = 0; i < 4; i++) {
+        QByteArray buffer(tileRect.width() * tileRect.height(), 0);
+        for (int j = 0; j < buffer.size(); j++) {
+            buffer[j] = (i + j) % 251;
+        }
+        buffers.append(buffer);
+
+        mementos.append(dm.getMemento());
+        dm.writeBytes((quint8*)buffer.data(),
+                      tileRect.x(), tileRect.y(),
+                      tileRect.width(), tileRect.height());
+        dm.commit();
+    }
+
+    auto tileContains = [&dm] (const QByteArray &buffer) {
+        KisTileSP tile = dm.getTile(0, 0, false);
+        return !memcmp(tile->data(), buffer.constData(), buffer.size());
+    };
+
+    /**
+     * The versions of the tile stored by all the revisions
+     * except the latest one are in the journal
+     */
+    journal->waitForPendingItems();
+    QCOMPARE(journal->numRecords(), qint64(3));
+    QVERIFY(tileContains(buffers[3]));
+
+    dm.rollback(mementos[3]);
+    QVERIFY(tileContains(buffers[2]));
+
+    dm.rollback(mementos[2]);
+    QVERIFY(tileContains(buffers[1]));
+    QCOMPARE(journal->numRecords(), qint64(1));
+
+    dm.rollback(mementos[1]);
+    QVERIFY(tileContains(buffers[0]));
+    QCOMPARE(journal->numRecords(), qint64(0));
+
+    dm.rollforward(mementos[1]);
+    dm.rollforward(mementos[2]);
+    dm.rollforward(mementos[3]);
+    QVERIFY(tileContains(buffers[3]));
+
+    dm.purgeHistory(mementos[3]);
+    journal->waitForPendingItems();
+    QCOMPARE(journal->numRecords(), qint64(0));
+
+    {
+        KisImageConfig cfg(false);
+        cfg.setUndoJournalDepth(0);
+    }
+    store->testingRereadConfig();
+}
+
+void KisTiledDataManagerTest::testMemoryOwner()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->testingSuspendPooler();
+
+    const int owner = store->registerMemoryOwner();
+    QVERIFY(owner > 0);
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 pixel = 1;
+    dm.setPixel(0, 0, &pixel);
+
+    dm.setMemoryOwner(owner, false);
+    QCOMPARE(dm.getTile(0, 0, false)->tileData()->memoryOwner(), owner);
+
+    /**
+     * The tiles created after the owner has been assigned
+     * inherit it on copy-on-write
+     */
+    dm.setPixel(64, 0, &pixel);
+    QCOMPARE(dm.getTile(1, 0, false)->tileData()->memoryOwner(), owner);
+    QVERIFY(!dm.getTile(1, 0, false)->tileData()->lowMemoryPriority());
+
+    store->memoryStatistics();
+    QCOMPARE(store->memoryOwnerMetric(owner), qint64(2));
+
+    dm.setMemoryOwner(owner, true);
+    QVERIFY(dm.getTile(0, 0, false)->tileData()->lowMemoryPriority());
+    QVERIFY(dm.getTile(1, 0, false)->tileData()->lowMemoryPriority());
+
+    KisTiledDataManager dm2(dm);
+    QCOMPARE(dm2.memoryOwner(), owner);
+    QVERIFY(dm2.lowMemoryPriority());
+
+    store->setActiveMemoryOwner(owner);
+    QCOMPARE(store->activeMemoryOwner(), owner);
+
+    store->unregisterMemoryOwner(owner);
+    QCOMPARE(store->activeMemoryOwner(), 0);
+
+    store->testingResumePooler();
+}
+
 //#include <valgrind/callgrind.h>
 
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
@@ -40,6 +40,12 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testShareUniformTiles();
+    void testDeduplicateTiles();
+    void testCompactHistory();
+    void testCompactHistoryInterleaved();
+    void testJournalHistory();
+    void testMemoryOwner();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
@@ -0,0 +1,126 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoAlphaMaskApplicatorAvx512.h"
+
+#include <immintrin.h>
+
+#include "KoAlphaMaskApplicatorBase.h"
+
+/**
+ * NOTE: this file is compiled with AVX-512 instructions enabled, so it
+ * should not instantiate any inline or template code shared with the
+ * rest of the library, otherwise the linker may pick the AVX-512 copy
+ * of it for the CPUs that don't support it.
+ */
+
+namespace {
+
+class KoAlphaMaskApplicatorRgba8Avx512 : public KoAlphaMaskApplicatorBase
+{
+    static const int numChannels = 4;
+    static const int vectorSize = 16;
+    static const int vectorPixelStride = numChannels * vectorSize;
+
+    /**
+     * The last incomplete vector is processed with masked loads and
+     * stores, which don't touch the memory of the masked out pixels
+     */
+    static inline __mmask16 pixelsMask(qint32 nPixels) {
+        return nPixels >= vectorSize ? __mmask16(0xFFFF) : __mmask16((1u << nPixels) - 1);
+    }
+
+    static inline __m512i brushColorVector(const quint8 *brushColor) {
+        return _mm512_set1_epi32(*reinterpret_cast<const quint32*>(brushColor) & 0x00FFFFFFu);
+    }
+
+public:
+    void applyInverseNormedFloatMask(quint8 *pixels,
+                                     const float *alpha,
+                                     qint32 nPixels) const override
+    {
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const __m512i colorChannelsMask = _mm512_set1_epi32(0x00FFFFFF);
+
+        for (; nPixels > 0; nPixels -= vectorSize) {
+            const __mmask16 mask = pixelsMask(nPixels);
+
+            const __m512 maskAlpha = _mm512_maskz_loadu_ps(mask, alpha);
+            __m512i data_i = _mm512_maskz_loadu_epi32(mask, pixels);
+
+            __m512 pixelAlpha = _mm512_cvtepi32_ps(_mm512_srli_epi32(data_i, 24));
+            pixelAlpha = _mm512_mul_ps(pixelAlpha, _mm512_sub_ps(one, maskAlpha));
+
+            // rounds to the nearest, like Vc::round()
+            const __m512i pixelAlpha_i = _mm512_cvtps_epi32(pixelAlpha);
+
+            data_i = _mm512_or_si512(_mm512_and_si512(data_i, colorChannelsMask),
+                                     _mm512_slli_epi32(pixelAlpha_i, 24));
+            _mm512_mask_storeu_epi32(pixels, mask, data_i);
+
+            pixels += vectorPixelStride;
+            alpha += vectorSize;
+        }
+    }
+
+    void fillInverseAlphaNormedFloatMaskWithColor(quint8 * pixels,
+                                                  const float * alpha,
+                                                  const quint8 *brushColor,
+                                                  qint32 nPixels) const override
+    {
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const __m512 unitValue = _mm512_set1_ps(255.0f);
+        const __m512i brushColor_i = brushColorVector(brushColor);
+
+        for (; nPixels > 0; nPixels -= vectorSize) {
+            const __mmask16 mask = pixelsMask(nPixels);
+
+            const __m512 maskAlpha = _mm512_maskz_loadu_ps(mask, alpha);
+            const __m512 pixelAlpha = _mm512_mul_ps(unitValue, _mm512_sub_ps(one, maskAlpha));
+            const __m512i pixelAlpha_i = _mm512_cvtps_epi32(pixelAlpha);
+
+            const __m512i data_i = _mm512_or_si512(brushColor_i, _mm512_slli_epi32(pixelAlpha_i, 24));
+            _mm512_mask_storeu_epi32(pixels, mask, data_i);
+
+            pixels += vectorPixelStride;
+            alpha += vectorSize;
+        }
+    }
+
+    void fillGrayBrushWithColor(quint8 *dst, const QRgb *brush, quint8 *brushColor, qint32 nPixels) const override
+    {
+        const __m512i brushColor_i = brushColorVector(brushColor);
+        const __m512i redChannelMask = _mm512_set1_epi32(0xFF);
+        const __m512i roundingOffset = _mm512_set1_epi32(0x80);
+
+        for (; nPixels > 0; nPixels -= vectorSize) {
+            const __mmask16 mask = pixelsMask(nPixels);
+
+            const __m512i maskPixels = _mm512_maskz_loadu_epi32(mask, brush);
+
+            const __m512i pixelAlpha = _mm512_srli_epi32(maskPixels, 24);
+            const __m512i pixelRed = _mm512_and_si512(maskPixels, redChannelMask);
+
+            // the same as KoAlphaMaskApplicator::multiply()
+            const __m512i c = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_sub_epi32(redChannelMask, pixelRed), pixelAlpha),
+                                               roundingOffset);
+            const __m512i pixelAlpha_i = _mm512_srli_epi32(_mm512_add_epi32(_mm512_srli_epi32(c, 8), c), 8);
+
+            const __m512i data_i = _mm512_or_si512(brushColor_i, _mm512_slli_epi32(pixelAlpha_i, 24));
+            _mm512_mask_storeu_epi32(dst, mask, data_i);
+
+            dst += vectorPixelStride;
+            brush += vectorSize;
+        }
+    }
+};
+
+}
+
+KoAlphaMaskApplicatorBase* createRgba8AlphaMaskApplicatorAvx512()
+{
+    return new KoAlphaMaskApplicatorRgba8Avx512();
+}
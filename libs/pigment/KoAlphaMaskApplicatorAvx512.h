@@ -0,0 +1,30 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOALPHAMASKAPPLICATORAVX512_H
+#define KOALPHAMASKAPPLICATORAVX512_H
+
+#include "kritapigment_export.h"
+
+class KoAlphaMaskApplicatorBase;
+
+/**
+ * Creates the AVX-512 implementation of the applicator for 8-bit
+ * 4-channel pixels with the alpha channel in the last byte (RGBA8
+ * and the like).
+ *
+ * Vc has no AVX-512 backend, so the kernels are written with the
+ * intrinsics directly and the file is compiled with AVX-512 flags
+ * separately from the rest of the per-arch code. The caller must
+ * check KoMultiArchBuildSupport::avx512Enabled() before calling it.
+ *
+ * The results are the same as the ones of Vc's implementations:
+ * the alpha is rounded to the nearest value, not truncated like in
+ * the scalar version.
+ */
+KRITAPIGMENT_EXPORT KoAlphaMaskApplicatorBase* createRgba8AlphaMaskApplicatorAvx512();
+
+#endif // KOALPHAMASKAPPLICATORAVX512_H
@@ -11,6 +11,24 @@
 
 #include "KoAlphaMaskApplicatorFactoryImpl.h"
 
+#ifdef HAVE_AVX512_KERNELS
+#include <type_traits>
+#include "KoAlphaMaskApplicatorAvx512.h"
+
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_>
+KoAlphaMaskApplicatorBase*
+KoAlphaMaskApplicatorFactoryImpl<_channels_type_, _channels_nb_, _alpha_pos_>::createAvx512(int)
+{
+    const bool isRgba8 =
+        std::is_same<_channels_type_, quint8>::value &&
+        _channels_nb_ == 4 && _alpha_pos_ == 3;
+
+    return isRgba8 ? createRgba8AlphaMaskApplicatorAvx512() : nullptr;
+}
+#endif
+
 template <typename channels_type>
 struct CreateApplicator
 {
@@ -20,6 +20,16 @@ public:
 
     template<Vc::Implementation _impl>
     static KoAlphaMaskApplicatorBase* create(int);
+
+#ifdef HAVE_AVX512_KERNELS
+    /**
+     * Returns the AVX-512 implementation of the applicator or null
+     * if there is none for this pixel format
+     *
+     * \see KoAlphaMaskApplicatorAvx512.h
+     */
+    static KoAlphaMaskApplicatorBase* createAvx512(int);
+#endif
 };
 
 
@@ -15,6 +15,7 @@
 #include "KoColorProfile.h"
 #include "KoColorSpace.h"
 #include "KoCopyColorConversionTransformation.h"
+#include "KoLutColorConversionTransformation.h"
 #include "KoMultipleColorConversionTransformation.h"
 
 
@@ -225,6 +226,17 @@ KoColorConversionTransformation* KoColorConversionSystem::createColorConverter(c
     if (*srcColorSpace == *dstColorSpace) {
         return new KoCopyColorConversionTransformation(srcColorSpace);
     }
+    if (conversionFlags.testFlag(KoColorConversionTransformation::BakeToLut)) {
+        KoColorConversionTransformation *exactTransfo =
+            createColorConverter(srcColorSpace, dstColorSpace, renderingIntent,
+                                 conversionFlags & ~KoColorConversionTransformation::BakeToLut);
+
+        if (!KoLutColorConversionTransformation::isSupported(srcColorSpace, dstColorSpace)) {
+            return exactTransfo;
+        }
+
+        return new KoLutColorConversionTransformation(exactTransfo, conversionFlags);
+    }
     dbgPigmentCCS << srcColorSpace->id() << (srcColorSpace->profile() ? srcColorSpace->profile()->name() : "default");
     dbgPigmentCCS << dstColorSpace->id() << (dstColorSpace->profile() ? dstColorSpace->profile()->name() : "default");
     Path path = findBestPath(
@@ -0,0 +1,469 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoLutColorConversionTransformation.h"
+
+#include <vector>
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include "KoChannelInfo.h"
+#include "KoColorModelStandardIds.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceMaths.h"
+#include "kis_assert.h"
+
+namespace {
+
+/**
+ * The number of floats stored for every node of the table. Four color
+ * channels at most, so the interpolation loop has a fixed length and
+ * is vectorized by the compiler.
+ */
+const int lutStride = 4;
+
+/**
+ * Memory indexes of the color and alpha channels of a pixel. All the
+ * channels have the same type.
+ */
+struct PixelLayout {
+    KoChannelInfo::enumChannelValueType valueType = KoChannelInfo::OTHER;
+    QVector<int> colorChannels;
+    int alphaChannel = -1;
+};
+
+bool isSupportedValueType(KoChannelInfo::enumChannelValueType valueType)
+{
+    return valueType == KoChannelInfo::UINT8 ||
+        valueType == KoChannelInfo::UINT16 ||
+#ifdef HAVE_OPENEXR
+        valueType == KoChannelInfo::FLOAT16 ||
+#endif
+        valueType == KoChannelInfo::FLOAT32;
+}
+
+bool fetchPixelLayout(const KoColorSpace *cs, PixelLayout *layout)
+{
+    const QList<KoChannelInfo*> channels = cs->channels();
+    if (channels.isEmpty()) return false;
+
+    layout->valueType = channels.first()->channelValueType();
+    const int channelSize = channels.first()->size();
+
+    if (!isSupportedValueType(layout->valueType)) return false;
+
+    Q_FOREACH (const KoChannelInfo *channel, channels) {
+        if (channel->channelValueType() != layout->valueType ||
+            channel->size() != channelSize ||
+            channel->pos() % channelSize != 0) {
+
+            return false;
+        }
+
+        const int index = channel->pos() / channelSize;
+
+        if (channel->channelType() == KoChannelInfo::ALPHA) {
+            if (layout->alphaChannel >= 0) return false;
+            layout->alphaChannel = index;
+        } else {
+            layout->colorChannels << index;
+        }
+    }
+
+    return !layout->colorChannels.isEmpty() &&
+        layout->colorChannels.size() <= lutStride;
+}
+
+template<typename T>
+inline float toUnitFloat(T value)
+{
+    return KoColorSpaceMaths<T, float>::scaleToA(value);
+}
+
+template<typename T>
+inline T fromUnitFloat(float value)
+{
+    return KoColorSpaceMaths<float, T>::scaleToA(value);
+}
+
+}
+
+struct Q_DECL_HIDDEN KoLutColorConversionTransformation::Private {
+    typedef void (*TransformFunc)(const Private *d, const quint8 *src, quint8 *dst, qint32 nPixels);
+    typedef qint32 (*RangeScanFunc)(const Private *d, const quint8 *src, qint32 nPixels, bool inRange);
+
+    QScopedPointer<const KoColorConversionTransformation> exactTransformation;
+
+    int gridSize = 0;
+    std::vector<float> lut;
+
+    PixelLayout srcLayout;
+    PixelLayout dstLayout;
+    int srcPixelSize = 0;
+    int dstPixelSize = 0;
+
+    TransformFunc transformFunc = 0;
+
+    /**
+     * Set only for floating point sources, their values may lie
+     * outside the range covered by the table
+     */
+    RangeScanFunc rangeScanFunc = 0;
+
+    template<typename SrcT>
+    void fillGrid(quint8 *pixels) const;
+
+    template<typename SrcT>
+    static qint32 scanRange(const Private *d, const quint8 *src, qint32 nPixels, bool inRange);
+
+    template<typename DstT>
+    void readNodes(const quint8 *pixels);
+
+    template<typename SrcT, typename DstT>
+    static void transformImpl(const Private *d, const quint8 *src, quint8 *dst, qint32 nPixels);
+
+    template<typename SrcT>
+    TransformFunc selectTransformFunc() const;
+};
+
+template<typename SrcT>
+void KoLutColorConversionTransformation::Private::fillGrid(quint8 *pixels) const
+{
+    const float scale = 1.0f / (gridSize - 1);
+    const int c0 = srcLayout.colorChannels[0];
+    const int c1 = srcLayout.colorChannels[1];
+    const int c2 = srcLayout.colorChannels[2];
+
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
+            for (int z = 0; z < gridSize; z++) {
+                SrcT *pixel = reinterpret_cast<SrcT*>(pixels);
+
+                pixel[c0] = fromUnitFloat<SrcT>(x * scale);
+                pixel[c1] = fromUnitFloat<SrcT>(y * scale);
+                pixel[c2] = fromUnitFloat<SrcT>(z * scale);
+                pixel[srcLayout.alphaChannel] = fromUnitFloat<SrcT>(1.0f);
+
+                pixels += srcPixelSize;
+            }
+        }
+    }
+}
+
+template<typename DstT>
+void KoLutColorConversionTransformation::Private::readNodes(const quint8 *pixels)
+{
+    const int numNodes = gridSize * gridSize * gridSize;
+    const int numColorChannels = dstLayout.colorChannels.size();
+
+    lut.assign(numNodes * lutStride, 0.0f);
+
+    float *node = lut.data();
+
+    for (int i = 0; i < numNodes; i++) {
+        const DstT *pixel = reinterpret_cast<const DstT*>(pixels);
+
+        for (int c = 0; c < numColorChannels; c++) {
+            node[c] = toUnitFloat<DstT>(pixel[dstLayout.colorChannels[c]]);
+        }
+
+        node += lutStride;
+        pixels += dstPixelSize;
+    }
+}
+
+template<typename SrcT, typename DstT>
+void KoLutColorConversionTransformation::Private::transformImpl(const Private *d, const quint8 *src, quint8 *dst, qint32 nPixels)
+{
+    const int n = d->gridSize;
+    const float scale = n - 1;
+
+    const int strideZ = lutStride;
+    const int strideY = n * strideZ;
+    const int strideX = n * strideY;
+
+    const int c0 = d->srcLayout.colorChannels[0];
+    const int c1 = d->srcLayout.colorChannels[1];
+    const int c2 = d->srcLayout.colorChannels[2];
+    const int srcAlpha = d->srcLayout.alphaChannel;
+
+    const int numDstColorChannels = d->dstLayout.colorChannels.size();
+    const int *dstColorChannels = d->dstLayout.colorChannels.constData();
+    const int dstAlpha = d->dstLayout.alphaChannel;
+
+    const float *lut = d->lut.data();
+
+    float result[lutStride];
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        const SrcT *s = reinterpret_cast<const SrcT*>(src);
+        DstT *t = reinterpret_cast<DstT*>(dst);
+
+        // integer sources are always in range, the floating point ones are prefiltered by scanRange()
+        const float x = qBound(0.0f, toUnitFloat<SrcT>(s[c0]), 1.0f) * scale;
+        const float y = qBound(0.0f, toUnitFloat<SrcT>(s[c1]), 1.0f) * scale;
+        const float z = qBound(0.0f, toUnitFloat<SrcT>(s[c2]), 1.0f) * scale;
+
+        const int ix = qMin(int(x), n - 2);
+        const int iy = qMin(int(y), n - 2);
+        const int iz = qMin(int(z), n - 2);
+
+        const float fx = x - ix;
+        const float fy = y - iy;
+        const float fz = z - iz;
+
+        /**
+         * Tetrahedral interpolation: the cube is split into six
+         * tetrahedra along its main diagonal. The order of the
+         * fractional parts selects the tetrahedron the point
+         * lies in, that is, the two intermediate vertices
+         * between (0,0,0) and (1,1,1).
+         */
+        int o1, o2;
+        float a, b, c;
+
+        if (fx >= fy) {
+            if (fy >= fz) {
+                o1 = strideX; o2 = strideX + strideY; a = fx; b = fy; c = fz;
+            } else if (fx >= fz) {
+                o1 = strideX; o2 = strideX + strideZ; a = fx; b = fz; c = fy;
+            } else {
+                o1 = strideZ; o2 = strideX + strideZ; a = fz; b = fx; c = fy;
+            }
+        } else {
+            if (fx >= fz) {
+                o1 = strideY; o2 = strideX + strideY; a = fy; b = fx; c = fz;
+            } else if (fy >= fz) {
+                o1 = strideY; o2 = strideY + strideZ; a = fy; b = fz; c = fx;
+            } else {
+                o1 = strideZ; o2 = strideY + strideZ; a = fz; b = fy; c = fx;
+            }
+        }
+
+        const int o3 = strideX + strideY + strideZ;
+
+        const float w0 = 1.0f - a;
+        const float w1 = a - b;
+        const float w2 = b - c;
+        const float w3 = c;
+
+        const float *base = lut + ix * strideX + iy * strideY + iz * strideZ;
+
+        for (int ch = 0; ch < lutStride; ch++) {
+            result[ch] = w0 * base[ch] + w1 * base[o1 + ch] + w2 * base[o2 + ch] + w3 * base[o3 + ch];
+        }
+
+        for (int ch = 0; ch < numDstColorChannels; ch++) {
+            t[dstColorChannels[ch]] = fromUnitFloat<DstT>(result[ch]);
+        }
+
+        if (dstAlpha >= 0) {
+            t[dstAlpha] = fromUnitFloat<DstT>(toUnitFloat<SrcT>(s[srcAlpha]));
+        }
+
+        src += d->srcPixelSize;
+        dst += d->dstPixelSize;
+    }
+}
+
+/**
+ * Returns the number of the leading pixels whose color channels are
+ * all inside (or, when \p inRange is false, not all inside) [0, 1]
+ */
+template<typename SrcT>
+qint32 KoLutColorConversionTransformation::Private::scanRange(const Private *d, const quint8 *src, qint32 nPixels, bool inRange)
+{
+    const int c0 = d->srcLayout.colorChannels[0];
+    const int c1 = d->srcLayout.colorChannels[1];
+    const int c2 = d->srcLayout.colorChannels[2];
+
+    qint32 i = 0;
+
+    for (; i < nPixels; i++) {
+        const SrcT *s = reinterpret_cast<const SrcT*>(src);
+
+        const float x = toUnitFloat<SrcT>(s[c0]);
+        const float y = toUnitFloat<SrcT>(s[c1]);
+        const float z = toUnitFloat<SrcT>(s[c2]);
+
+        // written so that NaN values are considered out of range
+        const bool pixelInRange =
+            x >= 0.0f && x <= 1.0f &&
+            y >= 0.0f && y <= 1.0f &&
+            z >= 0.0f && z <= 1.0f;
+
+        if (pixelInRange != inRange) break;
+
+        src += d->srcPixelSize;
+    }
+
+    return i;
+}
+
+template<typename SrcT>
+typename KoLutColorConversionTransformation::Private::TransformFunc
+KoLutColorConversionTransformation::Private::selectTransformFunc() const
+{
+    switch (dstLayout.valueType) {
+    case KoChannelInfo::UINT8:
+        return &transformImpl<SrcT, quint8>;
+    case KoChannelInfo::UINT16:
+        return &transformImpl<SrcT, quint16>;
+#ifdef HAVE_OPENEXR
+    case KoChannelInfo::FLOAT16:
+        return &transformImpl<SrcT, half>;
+#endif
+    case KoChannelInfo::FLOAT32:
+        return &transformImpl<SrcT, float>;
+    default:
+        return 0;
+    }
+}
+
+KoLutColorConversionTransformation::KoLutColorConversionTransformation(const KoColorConversionTransformation *exactTransformation,
+                                                                       ConversionFlags conversionFlags)
+    : KoColorConversionTransformation(exactTransformation->srcColorSpace(),
+                                      exactTransformation->dstColorSpace(),
+                                      exactTransformation->renderingIntent(),
+                                      conversionFlags)
+    , d(new Private)
+{
+    d->exactTransformation.reset(exactTransformation);
+
+    const KoColorSpace *srcCs = exactTransformation->srcColorSpace();
+    const KoColorSpace *dstCs = exactTransformation->dstColorSpace();
+
+    KIS_ASSERT(isSupported(srcCs, dstCs));
+
+    fetchPixelLayout(srcCs, &d->srcLayout);
+    fetchPixelLayout(dstCs, &d->dstLayout);
+
+    d->srcPixelSize = srcCs->pixelSize();
+    d->dstPixelSize = dstCs->pixelSize();
+    d->gridSize = gridSize(conversionFlags);
+
+    const int numNodes = d->gridSize * d->gridSize * d->gridSize;
+
+    QVector<quint8> srcNodes(numNodes * d->srcPixelSize);
+    QVector<quint8> dstNodes(numNodes * d->dstPixelSize);
+
+    switch (d->srcLayout.valueType) {
+    case KoChannelInfo::UINT16:
+        d->fillGrid<quint16>(srcNodes.data());
+        d->transformFunc = d->selectTransformFunc<quint16>();
+        break;
+#ifdef HAVE_OPENEXR
+    case KoChannelInfo::FLOAT16:
+        d->fillGrid<half>(srcNodes.data());
+        d->transformFunc = d->selectTransformFunc<half>();
+        d->rangeScanFunc = &Private::scanRange<half>;
+        break;
+#endif
+    case KoChannelInfo::FLOAT32:
+        d->fillGrid<float>(srcNodes.data());
+        d->transformFunc = d->selectTransformFunc<float>();
+        d->rangeScanFunc = &Private::scanRange<float>;
+        break;
+    default:
+        break;
+    }
+
+    exactTransformation->transform(srcNodes.constData(), dstNodes.data(), numNodes);
+
+    switch (d->dstLayout.valueType) {
+    case KoChannelInfo::UINT8:
+        d->readNodes<quint8>(dstNodes.constData());
+        break;
+    case KoChannelInfo::UINT16:
+        d->readNodes<quint16>(dstNodes.constData());
+        break;
+#ifdef HAVE_OPENEXR
+    case KoChannelInfo::FLOAT16:
+        d->readNodes<half>(dstNodes.constData());
+        break;
+#endif
+    case KoChannelInfo::FLOAT32:
+        d->readNodes<float>(dstNodes.constData());
+        break;
+    default:
+        break;
+    }
+
+    KIS_ASSERT(d->transformFunc);
+}
+
+KoLutColorConversionTransformation::~KoLutColorConversionTransformation()
+{
+    delete d;
+}
+
+void KoLutColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    if (!d->rangeScanFunc) {
+        d->transformFunc(d, src, dst, nPixels);
+        return;
+    }
+
+    /**
+     * The pixels are split into the runs of the ones covered by the
+     * table and the out-of-range ones, the latter are converted exactly
+     */
+    bool inRange = true;
+
+    while (nPixels > 0) {
+        const qint32 runLength = d->rangeScanFunc(d, src, nPixels, inRange);
+
+        if (runLength > 0) {
+            if (inRange) {
+                d->transformFunc(d, src, dst, runLength);
+            } else {
+                d->exactTransformation->transform(src, dst, runLength);
+            }
+
+            src += runLength * d->srcPixelSize;
+            dst += runLength * d->dstPixelSize;
+            nPixels -= runLength;
+        }
+
+        inRange = !inRange;
+    }
+}
+
+bool KoLutColorConversionTransformation::isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    if (srcCs->colorModelId() != RGBAColorModelID) return false;
+
+    /**
+     * 8-bit data is already well-optimized by LCMS, for it the table
+     * would only bring the interpolation error
+     */
+    if (srcCs->colorDepthId() != Integer16BitsColorDepthID &&
+        srcCs->colorDepthId() != Float16BitsColorDepthID &&
+        srcCs->colorDepthId() != Float32BitsColorDepthID) {
+
+        return false;
+    }
+
+    PixelLayout srcLayout;
+    PixelLayout dstLayout;
+
+    return fetchPixelLayout(srcCs, &srcLayout) &&
+        srcLayout.colorChannels.size() == 3 &&
+        srcLayout.alphaChannel >= 0 &&
+        fetchPixelLayout(dstCs, &dstLayout);
+}
+
+int KoLutColorConversionTransformation::gridSize(ConversionFlags conversionFlags)
+{
+    return conversionFlags.testFlag(HighQuality) ? 65 :
+        conversionFlags.testFlag(LowQuality) ? 17 : 33;
+}
@@ -0,0 +1,67 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef _KO_LUT_COLOR_CONVERSION_TRANSFORMATION_H_
+#define _KO_LUT_COLOR_CONVERSION_TRANSFORMATION_H_
+
+#include <KoColorConversionTransformation.h>
+
+#include "kritapigment_export.h"
+
+/**
+ * A color conversion that approximates another conversion with a 3D
+ * lookup table. The table is sampled once, when the transformation is
+ * created, and then the colors are calculated with tetrahedral
+ * interpolation between the nodes of the table.
+ *
+ * It is much faster than calling LCMS for 16-bit and floating point
+ * data and for the long conversion chains (proofing, PQ), but it is not
+ * exact. Therefore it is used only when the conversion is requested
+ * with KoColorConversionTransformation::BakeToLut flag. The size of the
+ * table depends on HighQuality and LowQuality flags.
+ *
+ * Only RGBA sources with 16-bit integer or floating point channels are
+ * supported. The table covers [0, 1] range of the source channels. The
+ * pixels of floating point sources that lie outside of this range (the
+ * unbounded, HDR, data) are passed to the exact transformation, so they
+ * are never clipped. The destination can be any color space with up to
+ * four color channels of the same type.
+ *
+ * The approximation is meant for the display conversions. Destructive
+ * conversions of the image data should not request it.
+ */
+class KRITAPIGMENT_EXPORT KoLutColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    /**
+     * Bakes \p exactTransformation into a lookup table. The
+     * transformation is owned by the object, it is used for the
+     * out-of-range pixels of floating point sources.
+     */
+    KoLutColorConversionTransformation(const KoColorConversionTransformation *exactTransformation,
+                                       ConversionFlags conversionFlags);
+    ~KoLutColorConversionTransformation() override;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+    /**
+     * @return true if the conversion between \p srcCs and \p dstCs can
+     * be baked into a lookup table
+     */
+    static bool isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs);
+
+    /**
+     * @return the number of nodes of the table along every axis for
+     * the given conversion flags
+     */
+    static int gridSize(ConversionFlags conversionFlags);
+
+private:
+    struct Private;
+    Private * const d;
+};
+
+#endif
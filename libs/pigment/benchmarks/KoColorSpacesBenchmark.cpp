@@ -6,12 +6,18 @@
 
 #include "KoColorSpacesBenchmark.h"
 
+#include <QtConcurrentMap>
+
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
 
 #define NB_PIXELS 1000000
 
+// the same number of pixels as in a patch of 4x4 tiles
+#define NB_PIXELS_PER_PATCH 65536
+
 void KoColorSpacesBenchmark::createRowsColumns()
 {
     QTest::addColumn<QString>("modelID");
@@ -34,6 +40,37 @@ void KoColorSpacesBenchmark::createRowsColumns()
 #define END_BENCHMARK \
     delete[] data;
 
+void KoColorSpacesBenchmark::createConversionRowsColumns()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<QString>("depthID");
+
+    QTest::newRow("RGBA8 -> CMYKA8") << CMYKAColorModelID.id() << Integer8BitsColorDepthID.id();
+    QTest::newRow("RGBA8 -> RGBA16") << RGBAColorModelID.id() << Integer16BitsColorDepthID.id();
+    QTest::newRow("RGBA8 -> RGBAF16") << RGBAColorModelID.id() << Float16BitsColorDepthID.id();
+}
+
+#define START_CONVERSION_BENCHMARK \
+    QFETCH(QString, modelID); \
+    QFETCH(QString, depthID); \
+    \
+    const KoColorSpace* srcColorSpace = KoColorSpaceRegistry::instance()->rgb8(); \
+    const KoColorSpace* dstColorSpace = KoColorSpaceRegistry::instance()->colorSpace(modelID, depthID, 0); \
+    if (!dstColorSpace) { \
+        QSKIP("the destination color space is not available"); \
+    } \
+    const int srcPixelSize = srcColorSpace->pixelSize(); \
+    const int dstPixelSize = dstColorSpace->pixelSize(); \
+    quint8* srcData = new quint8[NB_PIXELS * srcPixelSize]; \
+    quint8* dstData = new quint8[NB_PIXELS * dstPixelSize]; \
+    for (int i = 0; i < NB_PIXELS * srcPixelSize; i++) { \
+        srcData[i] = quint8(i * 31); \
+    }
+
+#define END_CONVERSION_BENCHMARK \
+    delete[] srcData; \
+    delete[] dstData;
+
 void KoColorSpacesBenchmark::benchmarkAlpha_data()
 {
     createRowsColumns();
@@ -134,4 +171,54 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+void KoColorSpacesBenchmark::benchmarkConversion_data()
+{
+    createConversionRowsColumns();
+}
+
+void KoColorSpacesBenchmark::benchmarkConversion()
+{
+    START_CONVERSION_BENCHMARK
+    QBENCHMARK {
+        srcColorSpace->convertPixelsTo(srcData, dstData, dstColorSpace, NB_PIXELS,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+    }
+    END_CONVERSION_BENCHMARK
+}
+
+void KoColorSpacesBenchmark::benchmarkConversionParallel_data()
+{
+    createConversionRowsColumns();
+}
+
+/**
+ * Converts the buffer in patches on the global thread pool, the same
+ * way as KisPaintDevice::convertTo() does it. Every thread gets its own
+ * transformation from KoColorConversionCache.
+ */
+void KoColorSpacesBenchmark::benchmarkConversionParallel()
+{
+    START_CONVERSION_BENCHMARK
+
+    QVector<int> patches;
+    for (int i = 0; i < NB_PIXELS; i += NB_PIXELS_PER_PATCH) {
+        patches << i;
+    }
+
+    auto convertPatch = [&] (int firstPixel) {
+        const int numPixels = qMin(NB_PIXELS_PER_PATCH, NB_PIXELS - firstPixel);
+        srcColorSpace->convertPixelsTo(srcData + firstPixel * srcPixelSize,
+                                       dstData + firstPixel * dstPixelSize,
+                                       dstColorSpace, numPixels,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+    };
+
+    QBENCHMARK {
+        QtConcurrent::blockingMap(patches, convertPatch);
+    }
+    END_CONVERSION_BENCHMARK
+}
+
 SIMPLE_TEST_MAIN(KoColorSpacesBenchmark)
@@ -14,6 +14,7 @@ class KoColorSpacesBenchmark : public QObject
     Q_OBJECT
 private:
     void createRowsColumns();
+    void createConversionRowsColumns();
 private Q_SLOTS:
     void benchmarkAlpha_data();
     void benchmarkAlpha();
@@ -27,6 +28,10 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkConversion_data();
+    void benchmarkConversion();
+    void benchmarkConversionParallel_data();
+    void benchmarkConversionParallel();
 };
 
 #endif
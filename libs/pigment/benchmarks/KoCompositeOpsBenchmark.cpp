@@ -9,6 +9,7 @@
 #include "../compositeops/KoCompositeOpAlphaDarken.h"
 #include "../compositeops/KoCompositeOpOver.h"
 #include <KoOptimizedCompositeOpFactory.h>
+#include <KoColorModelStandardIds.h>
 
 #include <KoColorSpaceTraits.h>
 #include <KoColorSpaceRegistry.h>
@@ -26,12 +27,15 @@ const quint8 OPACITY_HALF = 128;
 const int TILES_IN_WIDTH = IMG_WIDTH / TILE_WIDTH;
 const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
 
+// the buffers are big enough for the 64-bit pixels
+const int BUFFER_LENGTH = IMG_HEIGHT * IMG_WIDTH * KoBgrU16Traits::pixelSize;
 
-#define COMPOSITE_BENCHMARK \
+
+#define COMPOSITE_BENCHMARK_PIXEL_SIZE(pixelSize) \
         for (int y = 0; y < TILES_IN_HEIGHT; y++){                                              \
             for (int x = 0; x < TILES_IN_WIDTH; x++) {                                           \
-                const int rowStride = IMG_WIDTH * KoBgrU8Traits::pixelSize;  \
-                const int bufOffset = y * rowStride + x * TILE_WIDTH * KoBgrU8Traits::pixelSize;  \
+                const int rowStride = IMG_WIDTH * pixelSize;  \
+                const int bufOffset = y * rowStride + x * TILE_WIDTH * pixelSize;  \
                 compositeOp->composite(m_dstBuffer + bufOffset, rowStride,      \
                                       m_srcBuffer + bufOffset, rowStride,      \
                                       m_mskBuffer + bufOffset, rowStride,                                                            \
@@ -40,13 +44,28 @@ const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
             }                                                                                   \
         }
 
-void KoCompositeOpsBenchmark::initTestCase()
+#define COMPOSITE_BENCHMARK COMPOSITE_BENCHMARK_PIXEL_SIZE(KoBgrU8Traits::pixelSize)
+
+#ifdef HAVE_OPENEXR
+/**
+ * Random bytes would give NaN, infinite and denormal values,
+ * so fill the buffers with proper half-float pixels
+ */
+void fillHalfFloatBuffer(quint8 *buffer)
 {
-    const int bufLen = IMG_HEIGHT * IMG_WIDTH * KoBgrU8Traits::pixelSize;
+    half *pixels = reinterpret_cast<half*>(buffer);
+
+    for (int i = 0; i < IMG_WIDTH * IMG_HEIGHT * 4; i++) {
+        pixels[i] = half(float(qrand()) / RAND_MAX);
+    }
+}
+#endif
 
-    m_dstBuffer = new quint8[bufLen];
-    m_srcBuffer = new quint8[bufLen];
-    m_mskBuffer = new quint8[bufLen];
+void KoCompositeOpsBenchmark::initTestCase()
+{
+    m_dstBuffer = new quint8[BUFFER_LENGTH];
+    m_srcBuffer = new quint8[BUFFER_LENGTH];
+    m_mskBuffer = new quint8[BUFFER_LENGTH];
 }
 
 // this is called before every benchmark
@@ -54,7 +73,7 @@ void KoCompositeOpsBenchmark::init()
 {
     qsrand(42);
 
-    for (int i = 0; i < int(IMG_WIDTH * IMG_HEIGHT * KoBgrU8Traits::pixelSize); i++) {
+    for (int i = 0; i < BUFFER_LENGTH; i++) {
         const int randVal = qrand();
 
         m_srcBuffer[i] = randVal & 0x0000FF;
@@ -96,5 +115,123 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
     }
 }
 
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiply()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createMultiplyOp32(KoColorSpaceRegistry::instance()->rgb8());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreen()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createScreenOp32(KoColorSpaceRegistry::instance()->rgb8());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlay()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createOverlayOp32(KoColorSpaceRegistry::instance()->rgb8());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeColorDodge()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createColorDodgeOp32(KoColorSpaceRegistry::instance()->rgb8());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeLinearLight()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createLinearLightOp32(KoColorSpaceRegistry::instance()->rgb8());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverU64()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createOverOpU64(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(KoBgrU16Traits::pixelSize)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamyU64()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyU64(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(KoBgrU16Traits::pixelSize)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeCopyU64()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createCopyOpU64(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(KoBgrU16Traits::pixelSize)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverF16()
+{
+#ifdef HAVE_OPENEXR
+    fillHalfFloatBuffer(m_srcBuffer);
+    fillHalfFloatBuffer(m_dstBuffer);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), "");
+
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(KoRgbF16Traits::pixelSize)
+    }
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamyF16()
+{
+#ifdef HAVE_OPENEXR
+    fillHalfFloatBuffer(m_srcBuffer);
+    fillHalfFloatBuffer(m_dstBuffer);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), "");
+
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs);
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(KoRgbF16Traits::pixelSize)
+    }
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeCopyF16()
+{
+#ifdef HAVE_OPENEXR
+    fillHalfFloatBuffer(m_srcBuffer);
+    fillHalfFloatBuffer(m_dstBuffer);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), "");
+
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(KoRgbF16Traits::pixelSize)
+    }
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
@@ -21,6 +21,17 @@ private Q_SLOTS:
     void benchmarkCompositeOver();
     void benchmarkCompositeAlphaDarkenHard();
     void benchmarkCompositeAlphaDarkenCreamy();
+    void benchmarkCompositeMultiply();
+    void benchmarkCompositeScreen();
+    void benchmarkCompositeOverlay();
+    void benchmarkCompositeColorDodge();
+    void benchmarkCompositeLinearLight();
+    void benchmarkCompositeOverU64();
+    void benchmarkCompositeAlphaDarkenCreamyU64();
+    void benchmarkCompositeCopyU64();
+    void benchmarkCompositeOverF16();
+    void benchmarkCompositeAlphaDarkenCreamyF16();
+    void benchmarkCompositeCopyF16();
 
 private:
     quint8 * m_dstBuffer;
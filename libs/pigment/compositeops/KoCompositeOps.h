@@ -122,6 +122,78 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     }
 };
 
+#ifdef HAVE_OPENEXR
+
+template<>
+struct OptimizedOpsSelector<KoRgbF16Traits>
+{
+    static KoCompositeOp* createAlphaDarkenOp(const KoColorSpace *cs) {
+        return useCreamyAlphaDarken() ?
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs) :
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(cs);
+
+    }
+    static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    }
+};
+
+#endif /* HAVE_OPENEXR */
+
+/**
+ * Returns an optimized version of KoCompositeOpGenericSC<Traits, func>
+ * or null if there is no such version
+ */
+template<class Traits>
+struct OptimizedSeparableOpsSelector
+{
+    typedef typename Traits::channels_type Arg;
+    typedef Arg (*CompositeFunc)(Arg, Arg);
+
+    template<CompositeFunc func>
+    static KoCompositeOp* createOp(const KoColorSpace *cs) {
+        Q_UNUSED(cs);
+        return 0;
+    }
+};
+
+template<>
+struct OptimizedSeparableOpsSelector<KoBgrU8Traits>
+{
+    typedef quint8 (*CompositeFunc)(quint8, quint8);
+
+    template<CompositeFunc func>
+    static KoCompositeOp* createOp(const KoColorSpace *cs) {
+        return
+            func == &cfMultiply<quint8> ? KoOptimizedCompositeOpFactory::createMultiplyOp32(cs) :
+            func == &cfScreen<quint8> ? KoOptimizedCompositeOpFactory::createScreenOp32(cs) :
+            func == &cfOverlay<quint8> ? KoOptimizedCompositeOpFactory::createOverlayOp32(cs) :
+            func == &cfColorDodge<quint8> ? KoOptimizedCompositeOpFactory::createColorDodgeOp32(cs) :
+            func == &cfLinearLight<quint8> ? KoOptimizedCompositeOpFactory::createLinearLightOp32(cs) :
+            0;
+    }
+};
+
+template<>
+struct OptimizedSeparableOpsSelector<KoRgbF32Traits>
+{
+    typedef float (*CompositeFunc)(float, float);
+
+    template<CompositeFunc func>
+    static KoCompositeOp* createOp(const KoColorSpace *cs) {
+        return
+            func == &cfMultiply<float> ? KoOptimizedCompositeOpFactory::createMultiplyOp128(cs) :
+            func == &cfScreen<float> ? KoOptimizedCompositeOpFactory::createScreenOp128(cs) :
+            func == &cfOverlay<float> ? KoOptimizedCompositeOpFactory::createOverlayOp128(cs) :
+            func == &cfColorDodge<float> ? KoOptimizedCompositeOpFactory::createColorDodgeOp128(cs) :
+            func == &cfLinearLight<float> ? KoOptimizedCompositeOpFactory::createLinearLightOp128(cs) :
+            0;
+    }
+};
+
 
 template<class Traits>
 struct AddGeneralOps<Traits, true>
@@ -132,7 +204,14 @@ struct AddGeneralOps<Traits, true>
 
      template<CompositeFunc func>
      static void add(KoColorSpace* cs, const QString& id, const QString& description, const QString& category) {
-         cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func>(cs, id, description, category));
+         KoCompositeOp *op = OptimizedSeparableOpsSelector<Traits>::template createOp<func>(cs);
+
+         if (op) {
+             Q_ASSERT(op->id() == id);
+             cs->addCompositeOp(op);
+         } else {
+             cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func>(cs, id, description, category));
+         }
      }
 
      static void add(KoColorSpace* cs) {
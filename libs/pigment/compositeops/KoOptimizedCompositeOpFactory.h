@@ -8,6 +8,7 @@
 #define KOOPTIMIZEDCOMPOSITEOPFACTORY_H
 
 #include "kritapigment_export.h"
+#include <KoConfig.h>
 
 class KoCompositeOp;
 class KoColorSpace;
@@ -39,6 +40,24 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+
+#ifdef HAVE_OPENEXR
+    static KoCompositeOp* createAlphaDarkenOpHardF16(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpCreamyF16(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createCopyOpF16(const KoColorSpace *cs);
+#endif
+
+    static KoCompositeOp* createMultiplyOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createScreenOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createOverlayOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createColorDodgeOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createLinearLightOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createMultiplyOp128(const KoColorSpace *cs);
+    static KoCompositeOp* createScreenOp128(const KoColorSpace *cs);
+    static KoCompositeOp* createOverlayOp128(const KoColorSpace *cs);
+    static KoCompositeOp* createColorDodgeOp128(const KoColorSpace *cs);
+    static KoCompositeOp* createLinearLightOp128(const KoColorSpace *cs);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -51,6 +51,48 @@ class KoOptimizedCompositeOpCopyU64;
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpCopy32;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenHardF16;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamyF16;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverF16;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpCopyF16;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpMultiply32;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpScreen32;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverlay32;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpColorDodge32;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpLinearLight32;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpMultiply128;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpScreen128;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverlay128;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpColorDodge128;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpLinearLight128;
+
 template<template<Vc::Implementation I> class CompositeOp>
 struct KoOptimizedCompositeOpFactoryPerArch
 {
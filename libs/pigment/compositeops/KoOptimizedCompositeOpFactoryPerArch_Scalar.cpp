@@ -11,6 +11,8 @@
 #include "KoAlphaDarkenParamsWrapper.h"
 #include "KoCompositeOpOver.h"
 #include "KoCompositeOpCopy2.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
 
 template<>
 template<>
@@ -109,3 +111,118 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyU64>
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+#ifdef HAVE_OPENEXR
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpOver<KoRgbF16Traits>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpCopy2<KoRgbF16Traits>(param);
+}
+
+#endif /* HAVE_OPENEXR */
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpMultiply32>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpMultiply32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfMultiply<quint8>>(param, COMPOSITE_MULT, i18n("Multiply"), KoCompositeOp::categoryArithmetic());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpScreen32>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpScreen32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfScreen<quint8>>(param, COMPOSITE_SCREEN, i18n("Screen"), KoCompositeOp::categoryLight());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverlay32>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverlay32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfOverlay<quint8>>(param, COMPOSITE_OVERLAY, i18n("Overlay"), KoCompositeOp::categoryMix());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpColorDodge32>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpColorDodge32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfColorDodge<quint8>>(param, COMPOSITE_DODGE, i18n("Color Dodge"), KoCompositeOp::categoryLight());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpLinearLight32>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpLinearLight32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoBgrU8Traits, &cfLinearLight<quint8>>(param, COMPOSITE_LINEAR_LIGHT, i18n("Linear Light"), KoCompositeOp::categoryLight());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpMultiply128>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpMultiply128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF32Traits, &cfMultiply<float>>(param, COMPOSITE_MULT, i18n("Multiply"), KoCompositeOp::categoryArithmetic());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpScreen128>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpScreen128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF32Traits, &cfScreen<float>>(param, COMPOSITE_SCREEN, i18n("Screen"), KoCompositeOp::categoryLight());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverlay128>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverlay128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF32Traits, &cfOverlay<float>>(param, COMPOSITE_OVERLAY, i18n("Overlay"), KoCompositeOp::categoryMix());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpColorDodge128>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpColorDodge128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF32Traits, &cfColorDodge<float>>(param, COMPOSITE_DODGE, i18n("Color Dodge"), KoCompositeOp::categoryLight());
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpLinearLight128>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpLinearLight128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF32Traits, &cfLinearLight<float>>(param, COMPOSITE_LINEAR_LIGHT, i18n("Linear Light"), KoCompositeOp::categoryLight());
+}
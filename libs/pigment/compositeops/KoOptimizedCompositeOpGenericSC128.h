@@ -0,0 +1,199 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
+
+#include "KoColorSpaceTraits.h"
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoStreamedCompositeOpFunctions.h"
+
+
+/**
+ * A vectorized version of KoCompositeOpGenericSC<KoRgbF32Traits, func>.
+ *
+ * The generic op does the intermediate math in doubles, here everything
+ * is done in floats, so the results may differ in a few least
+ * significant bits.
+ */
+template<class BlendFunc, bool alphaLocked, bool allChannelFlags>
+struct GenericSCCompositor128 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags.isEmpty() ? QBitArray(4, true) : params.channelFlags)
+        {
+        }
+        const QBitArray channelFlags;
+    };
+
+    static ALWAYS_INLINE Vc::float_v blendChannel(Vc::float_v::AsArg src, Vc::float_v::AsArg dst,
+                                                  Vc::float_v::AsArg srcFactor, Vc::float_v::AsArg dstFactor,
+                                                  Vc::float_v::AsArg blendFactor,
+                                                  Vc::float_v::AsArg newDstAlpha, const Vc::float_m &newAlphaIsZero)
+    {
+        const Vc::float_v result =
+            (dstFactor * dst + srcFactor * src + blendFactor * BlendFunc::composeChannelsF32(src, dst)) / newDstAlpha;
+
+        // the lanes with zero alpha have NaN values in the result
+        return Vc::iif(newAlphaIsZero, dst, result);
+    }
+
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        Vc::float_v src_alpha;
+        Vc::float_v dst_alpha;
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        PixelWrapper<float, _impl> dataWrapper;
+        dataWrapper.read(const_cast<quint8*>(src), src_c1, src_c2, src_c3, src_alpha);
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        src_alpha *= Vc::float_v(opacity);
+
+        if (haveMask) {
+            // division instead of the multiplication by reciprocal
+            // to get the same values as KoLuts::Uint8ToFloat
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) / Vc::float_v(255.0f);
+        }
+
+        const Vc::float_v oneValue(1.0f);
+
+        const Vc::float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+        const Vc::float_m newAlphaIsZero = new_alpha == Vc::float_v(Vc::Zero);
+
+        const Vc::float_v srcFactor = (oneValue - dst_alpha) * src_alpha;
+        const Vc::float_v dstFactor = (oneValue - src_alpha) * dst_alpha;
+        const Vc::float_v blendFactor = dst_alpha * src_alpha;
+
+        dst_c1 = blendChannel(src_c1, dst_c1, srcFactor, dstFactor, blendFactor, new_alpha, newAlphaIsZero);
+        dst_c2 = blendChannel(src_c2, dst_c2, srcFactor, dstFactor, blendFactor, new_alpha, newAlphaIsZero);
+        dst_c3 = blendChannel(src_c3, dst_c3, srcFactor, dstFactor, blendFactor, new_alpha, newAlphaIsZero);
+
+        Vc::float_v dst_alpha_out = new_alpha;
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, dst_alpha_out);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const float *s = reinterpret_cast<const float*>(src);
+        float *d = reinterpret_cast<float*>(dst);
+
+        const float srcAlpha = s[alpha_pos];
+        const float dstAlpha = d[alpha_pos];
+        const float maskAlpha = haveMask ? scale<float>(*mask) : unitValue<float>();
+
+        if (!allChannelFlags && dstAlpha == zeroValue<float>()) {
+            KoStreamedMathFunctions::clearPixel<16>(dst);
+        }
+
+        const float newDstAlpha =
+            KoCompositeOpGenericSC<KoRgbF32Traits, BlendFunc::template composeChannel<float>>::
+                template composeColorChannels<alphaLocked, allChannelFlags>(
+                    s, srcAlpha, d, dstAlpha, maskAlpha, opacity, oparams.channelFlags);
+
+        d[alpha_pos] = alphaLocked ? dstAlpha : newDstAlpha;
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in 16 byte
+ * colorspaces with alpha channel placed at the last float of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl, class BlendFunc>
+class KoOptimizedCompositeOpGenericSC128 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpGenericSC128(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite128<haveMask, false, GenericSCCompositor128<BlendFunc, false, true> >(params);
+        } else {
+            const bool alphaLocked = !params.channelFlags.at(3);
+
+            if (alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunc, true, false> >(params);
+            } else {
+                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunc, false, false> >(params);
+            }
+        }
+    }
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpMultiply128 : public KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendMultiply<_impl>>
+{
+public:
+    KoOptimizedCompositeOpMultiply128(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendMultiply<_impl>>(cs, COMPOSITE_MULT, i18n("Multiply"), KoCompositeOp::categoryArithmetic()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpScreen128 : public KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendScreen<_impl>>
+{
+public:
+    KoOptimizedCompositeOpScreen128(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendScreen<_impl>>(cs, COMPOSITE_SCREEN, i18n("Screen"), KoCompositeOp::categoryLight()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverlay128 : public KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendOverlay<_impl>>
+{
+public:
+    KoOptimizedCompositeOpOverlay128(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendOverlay<_impl>>(cs, COMPOSITE_OVERLAY, i18n("Overlay"), KoCompositeOp::categoryMix()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpColorDodge128 : public KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendColorDodge<_impl>>
+{
+public:
+    KoOptimizedCompositeOpColorDodge128(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendColorDodge<_impl>>(cs, COMPOSITE_DODGE, i18n("Color Dodge"), KoCompositeOp::categoryLight()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpLinearLight128 : public KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendLinearLight<_impl>>
+{
+public:
+    KoOptimizedCompositeOpLinearLight128(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC128<_impl, KoStreamedBlendLinearLight<_impl>>(cs, COMPOSITE_LINEAR_LIGHT, i18n("Linear Light"), KoCompositeOp::categoryLight()) {}
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
@@ -0,0 +1,210 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H_
+
+#include "KoColorSpaceTraits.h"
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoStreamedCompositeOpFunctions.h"
+
+
+/**
+ * A vectorized version of KoCompositeOpGenericSC<KoBgrU8Traits, func>.
+ *
+ * The pixels are unpacked into 32-bit integer lanes and all the math
+ * is done with the same integer formulas as in KoColorSpaceMaths<quint8>,
+ * so the result is bit-exact with the generic op, including the
+ * wrapping of the intermediate values in Arithmetic::blend().
+ */
+template<class BlendFunc, bool alphaLocked, bool allChannelFlags>
+struct GenericSCCompositor32 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags.isEmpty() ? QBitArray(4, true) : params.channelFlags),
+              opacity(Arithmetic::scale<quint8>(params.opacity))
+        {
+        }
+        const QBitArray channelFlags;
+
+        // rounded to 8 bits, just like KoCompositeOpBase does
+        const quint8 opacity;
+    };
+
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(opacity);
+
+        using int_v = typename KoStreamedMath<_impl>::int_v;
+        using uint_v = typename KoStreamedMath<_impl>::uint_v;
+        using M = KoStreamedIntegerMath<_impl>;
+
+        uint_v srcPixels;
+        uint_v dstPixels;
+
+        if (src_aligned) {
+            srcPixels.load((const quint32*)src, Vc::Aligned);
+        } else {
+            srcPixels.load((const quint32*)src, Vc::Unaligned);
+        }
+        dstPixels.load((const quint32*)dst, Vc::Aligned);
+
+        const int_v lowByteMask(0xFF);
+
+        int_v srcAlpha = int_v(srcPixels >> 24);
+        const int_v dstAlpha = int_v(dstPixels >> 24);
+
+        if (haveMask) {
+            const int_v maskAlpha = int_v(uint_v(mask));
+            srcAlpha = M::mul(srcAlpha, maskAlpha, int_v(oparams.opacity));
+        } else {
+            srcAlpha = M::mul(srcAlpha, lowByteMask, int_v(oparams.opacity));
+        }
+
+        /**
+         * NOTE: unlike the Over op, we cannot skip the vector when the
+         * source is fully transparent. The integer math of the generic
+         * op doesn't guarantee that such pixels are kept unchanged.
+         */
+
+        const int_v newDstAlpha = srcAlpha + dstAlpha - M::mul(srcAlpha, dstAlpha);
+        const auto newAlphaIsZero = newDstAlpha == int_v(0);
+        const int_v safeNewDstAlpha = Vc::iif(newAlphaIsZero, int_v(1), newDstAlpha);
+
+        const int_v srcFactor = M::inv(dstAlpha);
+        const int_v dstFactor = M::inv(srcAlpha);
+
+        uint_v result = uint_v(newDstAlpha) << 24;
+
+        for (int shift = 0; shift < 24; shift += 8) {
+            const int_v s = int_v(srcPixels >> shift) & lowByteMask;
+            const int_v d = int_v(dstPixels >> shift) & lowByteMask;
+
+            // Arithmetic::blend() sums up the values in quint8
+            const int_v blended =
+                (M::mul(dstFactor, dstAlpha, d) +
+                 M::mul(srcFactor, srcAlpha, s) +
+                 M::mul(dstAlpha, srcAlpha, BlendFunc::composeChannelsU8(s, d))) & lowByteMask;
+
+            const int_v value = M::div(blended, safeNewDstAlpha) & lowByteMask;
+
+            result = result | (uint_v(Vc::iif(newAlphaIsZero, d, value)) << shift);
+        }
+
+        result.store((quint32*)dst, Vc::Aligned);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(opacity);
+
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const quint8 srcAlpha = src[alpha_pos];
+        const quint8 dstAlpha = dst[alpha_pos];
+        const quint8 maskAlpha = haveMask ? *mask : unitValue<quint8>();
+
+        if (!allChannelFlags && dstAlpha == zeroValue<quint8>()) {
+            KoStreamedMathFunctions::clearPixel<4>(dst);
+        }
+
+        const quint8 newDstAlpha =
+            KoCompositeOpGenericSC<KoBgrU8Traits, BlendFunc::template composeChannel<quint8>>::
+                template composeColorChannels<alphaLocked, allChannelFlags>(
+                    src, srcAlpha, dst, dstAlpha, maskAlpha, oparams.opacity, oparams.channelFlags);
+
+        dst[alpha_pos] = alphaLocked ? dstAlpha : newDstAlpha;
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in 4 byte
+ * colorspaces with alpha channel placed at the last byte of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl, class BlendFunc>
+class KoOptimizedCompositeOpGenericSC32 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpGenericSC32(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite32<haveMask, false, GenericSCCompositor32<BlendFunc, false, true> >(params);
+        } else {
+            const bool alphaLocked = !params.channelFlags.at(3);
+
+            if (alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, GenericSCCompositor32<BlendFunc, true, false> >(params);
+            } else {
+                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, GenericSCCompositor32<BlendFunc, false, false> >(params);
+            }
+        }
+    }
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpMultiply32 : public KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendMultiply<_impl>>
+{
+public:
+    KoOptimizedCompositeOpMultiply32(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendMultiply<_impl>>(cs, COMPOSITE_MULT, i18n("Multiply"), KoCompositeOp::categoryArithmetic()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpScreen32 : public KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendScreen<_impl>>
+{
+public:
+    KoOptimizedCompositeOpScreen32(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendScreen<_impl>>(cs, COMPOSITE_SCREEN, i18n("Screen"), KoCompositeOp::categoryLight()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverlay32 : public KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendOverlay<_impl>>
+{
+public:
+    KoOptimizedCompositeOpOverlay32(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendOverlay<_impl>>(cs, COMPOSITE_OVERLAY, i18n("Overlay"), KoCompositeOp::categoryMix()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpColorDodge32 : public KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendColorDodge<_impl>>
+{
+public:
+    KoOptimizedCompositeOpColorDodge32(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendColorDodge<_impl>>(cs, COMPOSITE_DODGE, i18n("Color Dodge"), KoCompositeOp::categoryLight()) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpLinearLight32 : public KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendLinearLight<_impl>>
+{
+public:
+    KoOptimizedCompositeOpLinearLight32(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSC32<_impl, KoStreamedBlendLinearLight<_impl>>(cs, COMPOSITE_LINEAR_LIGHT, i18n("Linear Light"), KoCompositeOp::categoryLight()) {}
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H_
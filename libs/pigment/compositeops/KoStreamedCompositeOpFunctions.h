@@ -0,0 +1,197 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef __KOSTREAMED_COMPOSITE_OP_FUNCTIONS_H
+#define __KOSTREAMED_COMPOSITE_OP_FUNCTIONS_H
+
+#include "KoCompositeOpFunctions.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Integer arithmetic of KoColorSpaceMaths<quint8> reimplemented for
+ * vectors of 8-bit values unpacked into 32-bit lanes. The functions
+ * reproduce UINT8_MULT, UINT8_MULT3 and UINT8_DIVIDE bit-to-bit, so
+ * the vectorized ops give exactly the same result as the generic ones.
+ */
+template<Vc::Implementation _impl>
+struct KoStreamedIntegerMath
+{
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+
+    static ALWAYS_INLINE int_v inv(const int_v &a) {
+        return int_v(0xFF) - a;
+    }
+
+    static ALWAYS_INLINE int_v mul(const int_v &a, const int_v &b) {
+        const int_v c = a * b + int_v(0x80);
+        return ((c >> 8) + c) >> 8;
+    }
+
+    static ALWAYS_INLINE int_v mul(const int_v &a, const int_v &b, const int_v &c) {
+        const int_v t = a * b * c + int_v(0x7F5B);
+        return ((t >> 7) + t) >> 16;
+    }
+
+    /**
+     * (a * 255 + b / 2) / b
+     *
+     * There is no integer division in SSE/AVX, so the division is done
+     * in floats. The numerator is less than 2^24, therefore the rounding
+     * error of the float division is always smaller than the distance to
+     * the next integer and truncation gives exactly the integer quotient.
+     */
+    static ALWAYS_INLINE int_v div(const int_v &a, const int_v &b) {
+        const int_v n = a * int_v(0xFF) + (b >> 1);
+        return int_v(Vc::simd_cast<Vc::float_v>(n) / Vc::simd_cast<Vc::float_v>(b));
+    }
+
+    static ALWAYS_INLINE int_v clamp(const int_v &a) {
+        const int_v zero(0);
+        const int_v unit(0xFF);
+        return Vc::iif(a < zero, zero, Vc::iif(a > unit, unit, a));
+    }
+};
+
+/**
+ * Vectorized versions of the separable blending functions from
+ * KoCompositeOpFunctions.h. Every struct provides:
+ *
+ * composeChannel<T>()     --- the original scalar function, used for
+ *                             the unaligned pixels and by the fallback
+ *                             for the non-vectorized architectures
+ *
+ * composeChannelsU8()     --- the same function for 8-bit channels,
+ *                             gives exactly the same result as
+ *                             composeChannel<quint8>()
+ *
+ * composeChannelsF32()    --- the same function for float channels
+ */
+
+template<Vc::Implementation _impl>
+struct KoStreamedBlendMultiply
+{
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+    using M = KoStreamedIntegerMath<_impl>;
+
+    template<typename T>
+    static inline T composeChannel(T src, T dst) {
+        return cfMultiply<T>(src, dst);
+    }
+
+    static ALWAYS_INLINE int_v composeChannelsU8(const int_v &src, const int_v &dst) {
+        return M::mul(src, dst);
+    }
+
+    static ALWAYS_INLINE Vc::float_v composeChannelsF32(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src * dst;
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedBlendScreen
+{
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+    using M = KoStreamedIntegerMath<_impl>;
+
+    template<typename T>
+    static inline T composeChannel(T src, T dst) {
+        return cfScreen<T>(src, dst);
+    }
+
+    static ALWAYS_INLINE int_v composeChannelsU8(const int_v &src, const int_v &dst) {
+        return src + dst - M::mul(src, dst);
+    }
+
+    static ALWAYS_INLINE Vc::float_v composeChannelsF32(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + dst - src * dst;
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedBlendOverlay
+{
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+    using M = KoStreamedIntegerMath<_impl>;
+
+    template<typename T>
+    static inline T composeChannel(T src, T dst) {
+        return cfOverlay<T>(src, dst);
+    }
+
+    // cfHardLight() with swapped arguments
+    static ALWAYS_INLINE int_v composeChannelsU8(const int_v &src, const int_v &dst) {
+        const int_v dst2 = dst + dst;
+        const int_v dst2Screen = dst2 - int_v(0xFF);
+
+        // 0x7F is KoColorSpaceMathsTraits<quint8>::halfValue
+        return Vc::iif(dst > int_v(0x7F),
+                       dst2Screen + src - M::mul(dst2Screen, src),
+                       M::mul(dst2, src));
+    }
+
+    static ALWAYS_INLINE Vc::float_v composeChannelsF32(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v dst2 = dst + dst;
+        const Vc::float_v dst2Screen = dst2 - Vc::float_v(1.0f);
+
+        return Vc::iif(dst > Vc::float_v(0.5f),
+                       dst2Screen + src - dst2Screen * src,
+                       dst2 * src);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedBlendColorDodge
+{
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+    using M = KoStreamedIntegerMath<_impl>;
+
+    template<typename T>
+    static inline T composeChannel(T src, T dst) {
+        return cfColorDodge<T>(src, dst);
+    }
+
+    static ALWAYS_INLINE int_v composeChannelsU8(const int_v &src, const int_v &dst) {
+        const int_v unit(0xFF);
+        const int_v invSrc = M::inv(src);
+        const auto srcIsUnit = invSrc == int_v(0);
+
+        // the lanes with zero divisor are overwritten below
+        const int_v result = M::div(dst, Vc::iif(srcIsUnit, int_v(1), invSrc));
+        return Vc::iif(srcIsUnit, unit, Vc::iif(result > unit, unit, result));
+    }
+
+    /**
+     * KoColorSpaceMaths<float>::clamp() bounds the value with
+     * +/-FLT_MAX only, so there is no clamping here
+     */
+    static ALWAYS_INLINE Vc::float_v composeChannelsF32(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v unit(1.0f);
+        return Vc::iif(src == unit, unit, dst / (unit - src));
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedBlendLinearLight
+{
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+    using M = KoStreamedIntegerMath<_impl>;
+
+    template<typename T>
+    static inline T composeChannel(T src, T dst) {
+        return cfLinearLight<T>(src, dst);
+    }
+
+    static ALWAYS_INLINE int_v composeChannelsU8(const int_v &src, const int_v &dst) {
+        return M::clamp(src + src + dst - int_v(0xFF));
+    }
+
+    // see a comment in KoStreamedBlendColorDodge
+    static ALWAYS_INLINE Vc::float_v composeChannelsF32(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + src + dst - Vc::float_v(1.0f);
+    }
+};
+
+#endif /* __KOSTREAMED_COMPOSITE_OP_FUNCTIONS_H */
@@ -661,6 +661,121 @@ struct PixelWrapper<float, _impl>
     const Vc::float_v::IndexType indexes;
 };
 
+#ifdef HAVE_OPENEXR
+
+/**
+ * Vc doesn't build any implementation with -mf16c, but all the CPUs
+ * supporting AVX2 have F16C instructions, so in AVX2 objects we can
+ * enable them for the conversion functions only. Other implementations
+ * use OpenEXR's conversion tables.
+ */
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define KO_STREAMED_MATH_HAVE_F16C 1
+#define KO_STREAMED_MATH_F16C_FUNCTION
+#elif defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+#define KO_STREAMED_MATH_HAVE_F16C 1
+#define KO_STREAMED_MATH_F16C_FUNCTION __attribute__((target("f16c")))
+#else
+#define KO_STREAMED_MATH_HAVE_F16C 0
+#endif
+
+/**
+ * Half-float pixels are converted into a temporary float buffer and
+ * then processed by PixelWrapper<float, _impl>. The conversion is
+ * exact and the conversion back rounds to the nearest even value,
+ * the same as half(float) does.
+ */
+template<Vc::Implementation _impl>
+struct PixelWrapper<half, _impl>
+{
+    static constexpr int numChannels = Vc::float_v::size() * 4;
+
+    ALWAYS_INLINE
+    static half lerpMixedUintFloat(half a, half b, float alpha) {
+        return half(Arithmetic::lerp(float(a), float(b), alpha));
+    }
+
+    ALWAYS_INLINE
+    static half roundFloatToUint(float x) {
+        return half(x);
+    }
+
+    ALWAYS_INLINE
+    static void normalizeAlpha(float &alpha) {
+        Q_UNUSED(alpha);
+    }
+
+    ALWAYS_INLINE
+    static void denormalizeAlpha(float &alpha) {
+        Q_UNUSED(alpha);
+    }
+
+#if KO_STREAMED_MATH_HAVE_F16C
+
+    KO_STREAMED_MATH_F16C_FUNCTION
+    static void convertToFloat(const half *src, float *dst) {
+        for (int i = 0; i < numChannels; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_store_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+    }
+
+    KO_STREAMED_MATH_F16C_FUNCTION
+    static void convertFromFloat(const float *src, half *dst) {
+        for (int i = 0; i < numChannels; i += 8) {
+            const __m128i h = _mm256_cvtps_ph(_mm256_load_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+        }
+    }
+
+#else
+
+    ALWAYS_INLINE
+    static void convertToFloat(const half *src, float *dst) {
+        for (int i = 0; i < numChannels; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    ALWAYS_INLINE
+    static void convertFromFloat(const float *src, half *dst) {
+        for (int i = 0; i < numChannels; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+#endif
+
+    ALWAYS_INLINE
+    void read(quint8 *dstPtr, Vc::float_v &dst_c1, Vc::float_v &dst_c2, Vc::float_v &dst_c3, Vc::float_v &dst_alpha)
+    {
+        convertToFloat(reinterpret_cast<const half*>(dstPtr), buffer);
+        floatWrapper.read(reinterpret_cast<quint8*>(buffer), dst_c1, dst_c2, dst_c3, dst_alpha);
+    }
+
+    ALWAYS_INLINE
+    void write(quint8 *dstPtr, Vc::float_v &dst_c1, Vc::float_v &dst_c2, Vc::float_v &dst_c3, Vc::float_v &dst_alpha)
+    {
+        floatWrapper.write(reinterpret_cast<quint8*>(buffer), dst_c1, dst_c2, dst_c3, dst_alpha);
+        convertFromFloat(buffer, reinterpret_cast<half*>(dstPtr));
+    }
+
+    ALWAYS_INLINE
+    void clearPixels(quint8 *dataDst) {
+        memset(dataDst, 0, Vc::float_v::size() * sizeof(half) * 4);
+    }
+
+    ALWAYS_INLINE
+    void copyPixels(const quint8 *dataSrc, quint8 *dataDst) {
+        memcpy(dataDst, dataSrc, Vc::float_v::size() * sizeof(half) * 4);
+    }
+
+    PixelWrapper<float, _impl> floatWrapper;
+    alignas(32) float buffer[numChannels];
+};
+
+#endif /* HAVE_OPENEXR */
+
 namespace KoStreamedMathFunctions {
 
 template<int pixelSize>
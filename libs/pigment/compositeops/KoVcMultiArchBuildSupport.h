@@ -48,29 +48,26 @@ namespace Vc {
 #endif /* HAVE_VC */
 
 
+#ifdef HAVE_AVX512_KERNELS
+#include <cpuid.h>
+#endif
+
 #include <QDebug>
 #include <ksharedconfig.h>
 #include <kconfig.h>
 #include <kconfiggroup.h>
 
-template<class FactoryType>
-typename FactoryType::ReturnType
-createOptimizedClass(typename FactoryType::ParamType param)
+namespace KoMultiArchBuildSupport {
+
+inline Vc::Implementation detectBestImplementation()
 {
-    static bool isConfigInitialized = false;
-    static bool useVectorization = true;
-    static bool disableAVXOptimizations = false;
-
-    if (!isConfigInitialized) {
-        KConfigGroup cfg = KSharedConfig::openConfig()->group("");
-        useVectorization = !cfg.readEntry("amdDisableVectorWorkaround", false);
-        disableAVXOptimizations = cfg.readEntry("disableAVXOptimizations", false);
-        isConfigInitialized = true;
-    }
+    KConfigGroup cfg = KSharedConfig::openConfig()->group("");
+    const bool useVectorization = !cfg.readEntry("amdDisableVectorWorkaround", false);
+    const bool disableAVXOptimizations = cfg.readEntry("disableAVXOptimizations", false);
 
     if (!useVectorization) {
         qWarning() << "WARNING: vector instructions disabled by \'amdDisableVectorWorkaround\' option!";
-        return FactoryType::template create<Vc::ScalarImpl>(param);
+        return Vc::ScalarImpl;
     }
 
 #ifdef HAVE_VC
@@ -88,22 +85,145 @@ createOptimizedClass(typename FactoryType::ParamType param)
      * TODO: Add FMA3/4 when it is adopted by Vc
      */
     if (!disableAVXOptimizations && Vc::isImplementationSupported(Vc::AVX2Impl)) {
-        return FactoryType::template create<Vc::AVX2Impl>(param);
+        return Vc::AVX2Impl;
     } else if (!disableAVXOptimizations && Vc::isImplementationSupported(Vc::AVXImpl)) {
-        return FactoryType::template create<Vc::AVXImpl>(param);
+        return Vc::AVXImpl;
     } else if (Vc::isImplementationSupported(Vc::SSE41Impl)) {
-        return FactoryType::template create<Vc::SSE41Impl>(param);
+        return Vc::SSE41Impl;
     } else if (Vc::isImplementationSupported(Vc::SSSE3Impl)) {
-        return FactoryType::template create<Vc::SSSE3Impl>(param);
+        return Vc::SSSE3Impl;
     } else if (Vc::isImplementationSupported(Vc::SSE2Impl)) {
-        return FactoryType::template create<Vc::SSE2Impl>(param);
-    } else {
+        return Vc::SSE2Impl;
+    }
+#else
+    Q_UNUSED(disableAVXOptimizations);
 #endif
-        return FactoryType::template create<Vc::ScalarImpl>(param);
-#ifdef HAVE_VC
+
+    return Vc::ScalarImpl;
+}
+
+/**
+ * Returns the best implementation supported by the CPU and allowed by
+ * the user's configuration. The detection is done only once, all the
+ * factories share the result.
+ */
+inline Vc::Implementation bestImplementation()
+{
+    static const Vc::Implementation impl = detectBestImplementation();
+    return impl;
+}
+
+#ifdef HAVE_AVX512_KERNELS
+
+/**
+ * Checks that both the CPU and the OS support AVX-512F, that is
+ * the OS saves the opmask and the upper halves of ZMM registers
+ * on context switch
+ */
+inline bool isAvx512Supported()
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+
+    const unsigned int osxsaveBit = 1u << 27;
+    if (!(ecx & osxsaveBit)) return false;
+
+    unsigned int xcr0Low, xcr0High;
+    __asm__ ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+    Q_UNUSED(xcr0High);
+
+    // SSE, AVX, opmask, ZMM_Hi256 and Hi16_ZMM states
+    const unsigned int avx512StateMask = 0xE6;
+    if ((xcr0Low & avx512StateMask) != avx512StateMask) return false;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+
+    const unsigned int avx512fBit = 1u << 16;
+    return ebx & avx512fBit;
+}
+
+/**
+ * Vc has no AVX-512 implementation, so the AVX-512 kernels are
+ * selected on top of its AVX2 one. They are disabled by the same
+ * options as AVX2, plus their own 'disableAVX512Optimizations'
+ */
+inline bool detectAvx512Enabled()
+{
+    if (bestImplementation() != Vc::AVX2Impl || !isAvx512Supported()) return false;
+
+    KConfigGroup cfg = KSharedConfig::openConfig()->group("");
+    if (cfg.readEntry("disableAVX512Optimizations", false)) {
+        qWarning() << "WARNING: AVX-512 optimizations are disabled by \'disableAVX512Optimizations\' option!";
+        return false;
+    }
+
+    return true;
+}
+
+inline bool avx512Enabled()
+{
+    static const bool enabled = detectAvx512Enabled();
+    return enabled;
+}
+
+/**
+ * The factories that have an AVX-512 implementation of (some of)
+ * their classes provide a static createAvx512() method. It returns
+ * null when there is no such implementation for the requested class.
+ */
+template<class FactoryType>
+auto tryCreateAvx512(typename FactoryType::ParamType param, int)
+    -> decltype(FactoryType::createAvx512(param))
+{
+    return FactoryType::createAvx512(param);
+}
+
+template<class FactoryType>
+typename FactoryType::ReturnType
+tryCreateAvx512(typename FactoryType::ParamType, long)
+{
+    return nullptr;
+}
+
+#endif /* HAVE_AVX512_KERNELS */
+
+}
+
+template<class FactoryType>
+typename FactoryType::ReturnType
+createOptimizedClass(typename FactoryType::ParamType param)
+{
+    /**
+     * Every new implementation should be added here and to
+     * detectBestImplementation(), the rest of the per-arch code
+     * gets it via the template parameter.
+     */
+#ifdef HAVE_AVX512_KERNELS
+    if (KoMultiArchBuildSupport::avx512Enabled()) {
+        typename FactoryType::ReturnType result =
+            KoMultiArchBuildSupport::tryCreateAvx512<FactoryType>(param, 0);
+
+        if (result) return result;
     }
 #endif
 
+    switch (KoMultiArchBuildSupport::bestImplementation()) {
+#ifdef HAVE_VC
+    case Vc::AVX2Impl:
+        return FactoryType::template create<Vc::AVX2Impl>(param);
+    case Vc::AVXImpl:
+        return FactoryType::template create<Vc::AVXImpl>(param);
+    case Vc::SSE41Impl:
+        return FactoryType::template create<Vc::SSE41Impl>(param);
+    case Vc::SSSE3Impl:
+        return FactoryType::template create<Vc::SSSE3Impl>(param);
+    case Vc::SSE2Impl:
+        return FactoryType::template create<Vc::SSE2Impl>(param);
+#endif
+    default:
+        return FactoryType::template create<Vc::ScalarImpl>(param);
+    }
 }
 
 template<class FactoryType>
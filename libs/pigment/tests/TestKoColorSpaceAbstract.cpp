@@ -6,9 +6,19 @@
 
 #include "KoColorSpaceAbstract.h"
 #include "KoColorSpaceTraits.h"
+#include "KoColorModelStandardIds.h"
+#include "KoAlphaMaskApplicatorFactory.h"
+#include "KoVcMultiArchBuildSupport.h"
+
+#ifdef HAVE_AVX512_KERNELS
+#include "KoAlphaMaskApplicatorAvx512.h"
+#endif
 
 #include <cfloat>
 
+#include <QScopedPointer>
+#include <QVector>
+
 #include <simpletest.h>
 
 template <class T>
@@ -399,4 +409,85 @@ void TestKoColorSpaceAbstract::testMixColorsOpU8NoAlphaLinear()
 }
 
 
+void checkAlphaMaskApplicatorU8(const KoAlphaMaskApplicatorBase *applicator)
+{
+    using Trait = KoColorSpaceTrait<quint8, 4, 3>;
+    const int pixelSize = Trait::pixelSize;
+
+    // the sizes are chosen to cover the incomplete vectors
+    for (int numPixels = 0; numPixels < 70; numPixels++) {
+        const int numGuardPixels = 4;
+        const int numBytes = (numPixels + numGuardPixels) * pixelSize;
+
+        QVector<quint8> pixels(numBytes);
+        QVector<float> alpha(numPixels);
+        QVector<QRgb> brush(numPixels);
+
+        for (int i = 0; i < numBytes; i++) {
+            pixels[i] = quint8(i * 37 + numPixels);
+        }
+
+        for (int i = 0; i < numPixels; i++) {
+            alpha[i] = float((i * 13) % 101) / 100.0f;
+            brush[i] = qRgba(i * 17, 0, 0, 255 - i * 3);
+        }
+
+        quint8 brushColor[4] = {10, 20, 30, 40};
+
+        auto checkResult = [&] (const QVector<quint8> &result, const QVector<quint8> &expected) {
+            for (int i = 0; i < numBytes; i++) {
+                const bool isAlpha = i % pixelSize == Trait::alpha_pos;
+                const QString message = QString("pixels: %1, byte: %2").arg(numPixels).arg(i);
+
+                /**
+                 * The vector implementations round the alpha, the scalar
+                 * one truncates it
+                 */
+                if (i < numPixels * pixelSize && isAlpha) {
+                    QVERIFY2(qAbs(result[i] - expected[i]) <= 1, qPrintable(message));
+                } else {
+                    QVERIFY2(result[i] == expected[i], qPrintable(message));
+                }
+            }
+        };
+
+        QVector<quint8> result = pixels;
+        QVector<quint8> expected = pixels;
+        applicator->applyInverseNormedFloatMask(result.data(), alpha.data(), numPixels);
+        Trait::applyInverseAlphaNormedFloatMask(expected.data(), alpha.data(), numPixels);
+        checkResult(result, expected);
+
+        result = pixels;
+        expected = pixels;
+        applicator->fillInverseAlphaNormedFloatMaskWithColor(result.data(), alpha.data(), brushColor, numPixels);
+        Trait::fillInverseAlphaNormedFloatMaskWithColor(expected.data(), alpha.data(), brushColor, numPixels);
+        checkResult(result, expected);
+
+        result = pixels;
+        expected = pixels;
+        applicator->fillGrayBrushWithColor(result.data(), brush.data(), brushColor, numPixels);
+        Trait::fillGrayBrushWithColor(expected.data(), brush.data(), brushColor, numPixels);
+        checkResult(result, expected);
+    }
+}
+
+void TestKoColorSpaceAbstract::testAlphaMaskApplicatorU8()
+{
+    QScopedPointer<KoAlphaMaskApplicatorBase> applicator(
+        KoAlphaMaskApplicatorFactory::create(Integer8BitsColorDepthID, 4, 3));
+
+    checkAlphaMaskApplicatorU8(applicator.data());
+
+#ifdef HAVE_AVX512_KERNELS
+    if (KoMultiArchBuildSupport::isAvx512Supported()) {
+        QScopedPointer<KoAlphaMaskApplicatorBase> avx512Applicator(
+            createRgba8AlphaMaskApplicatorAvx512());
+
+        checkAlphaMaskApplicatorU8(avx512Applicator.data());
+    } else {
+        qDebug() << "AVX-512 is not supported by the CPU, the AVX-512 applicator is not checked";
+    }
+#endif
+}
+
 QTEST_GUILESS_MAIN(TestKoColorSpaceAbstract)
@@ -15,6 +15,7 @@ private Q_SLOTS:
     void testMixColorsOpF32();
     void testMixColorsOpU8NoAlpha();
     void testMixColorsOpU8NoAlphaLinear();
+    void testAlphaMaskApplicatorU8();
 };
 
 #endif
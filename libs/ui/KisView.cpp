@@ -80,6 +80,7 @@
 #include "kis_processing_applicator.h"
 #include "processing/fill_processing_visitor.h"
 #include "utils/KisClipboardUtil.h"
+#include "tiles3/kis_tile_data_store.h"
 
 //static
 QString KisView::newObjectName()
@@ -266,6 +267,11 @@ void KisView::notifyCurrentStateChanged(bool isCurrent)
     KisInputManager *inputManager = globalInputManager();
     if (d->isCurrent) {
         inputManager->attachPriorityEventFilter(&d->canvasController);
+
+        if (image()) {
+            KisTileDataStore::instance()->setActiveMemoryOwner(image()->memoryOwner());
+            image()->setVisibleRect(d->canvas.visibleImageRect());
+        }
     } else {
         inputManager->detachPriorityEventFilter(&d->canvasController);
     }
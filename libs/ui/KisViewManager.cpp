@@ -82,6 +82,8 @@
 #include "kis_group_layer.h"
 #include <kis_image.h>
 #include <kis_image_barrier_locker.h>
+#include <KisSchedulerTracer.h>
+#include <KoFileDialog.h>
 #include "kis_image_manager.h"
 #include <kis_layer.h>
 #include "kis_mainwindow_observer.h"
@@ -688,6 +690,10 @@ void KisViewManager::createActions()
     KisAction *tabletDebugger = actionManager()->createAction("tablet_debugger");
     connect(tabletDebugger, SIGNAL(triggered()), this, SLOT(toggleTabletLogger()));
 
+    KisAction *schedulerTracing = actionManager()->createAction("scheduler_tracing");
+    schedulerTracing->setChecked(KisSchedulerTracer::instance()->isEnabled());
+    connect(schedulerTracing, SIGNAL(toggled(bool)), this, SLOT(toggleSchedulerTracing(bool)));
+
     d->createTemplate = actionManager()->createAction("create_template");
     connect(d->createTemplate, SIGNAL(triggered()), this, SLOT(slotCreateTemplate()));
 
@@ -836,6 +842,26 @@ void KisViewManager::blockUntilOperationsFinishedForced(KisImageSP image)
     d->blockUntilOperationsFinishedImpl(image, true);
 }
 
+void KisViewManager::runWhenOperationsFinished(KisImageSP image, std::function<void()> func)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(image);
+
+    QPointer<KisViewManager> self(this);
+    KisImageWSP weakImage(image);
+
+    image->runBarrierAsync(
+        [] () {},
+        [self, weakImage, func] () {
+            if (!self) return;
+
+            KisImageSP image = weakImage;
+            KisImageSP currentImage = self->image();
+            if (!image || image != currentImage) return;
+
+            func();
+        });
+}
+
 void KisViewManager::slotCreateTemplate()
 {
     if (!document()) return;
@@ -1261,6 +1287,31 @@ void KisViewManager::toggleTabletLogger()
     d->inputManager.toggleTabletLogger();
 }
 
+void KisViewManager::toggleSchedulerTracing(bool value)
+{
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+
+    if (value) {
+        tracer->clear();
+        tracer->setEnabled(true);
+        return;
+    }
+
+    tracer->setEnabled(false);
+
+    KoFileDialog dialog(mainWindow(), KoFileDialog::SaveFile, "SaveSchedulerTrace");
+    dialog.setCaption(i18nc("@title:window", "Save Scheduler Trace"));
+    dialog.setMimeTypeFilters(QStringList("application/json"));
+
+    const QString fileName = dialog.filename();
+    if (fileName.isEmpty()) return;
+
+    if (!tracer->exportChromeTrace(fileName)) {
+        QMessageBox::warning(mainWindow(), i18nc("@title:window", "Krita"),
+                             i18n("Could not save the scheduler trace to %1", fileName));
+    }
+}
+
 void KisViewManager::openResourcesDirectory()
 {
     QString dir = KoResourcePaths::locateLocal("data", "");
@@ -11,6 +11,8 @@
 #include <QQueue>
 #include <QPointer>
 
+#include <functional>
+
 #include <KisMainWindow.h>
 #include <KoToolManager.h>
 
@@ -156,6 +158,20 @@ public:  // Krita specific interfaces
      */
     void blockUntilOperationsFinishedForced(KisImageSP image);
 
+    /**
+     * @brief runWhenOperationsFinished is an asynchronous alternative to
+     *        blockUntilOperationsFinished(). It calls \p func in the GUI
+     *        thread when all the actions queued on \p image are finished,
+     *        without blocking the GUI meanwhile.
+     *
+     * \p func is not called if the view manager or the image is deleted
+     * meanwhile, or if \p image is not the current image of the view
+     * manager anymore.
+     *
+     * @see KisImage::runBarrierAsync()
+     */
+    void runWhenOperationsFinished(KisImageSP image, std::function<void()> func);
+
 public:
 
     KisGridManager * gridManager() const;
@@ -225,6 +241,7 @@ private Q_SLOTS:
     void slotSaveIncrementalBackup();
     void showStatusBar(bool toggled);
     void toggleTabletLogger();
+    void toggleSchedulerTracing(bool value);
     void openResourcesDirectory();
     void initializeStatusBarVisibility();
     void guiUpdateTimeout();
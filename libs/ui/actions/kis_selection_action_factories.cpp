@@ -61,16 +61,18 @@
 
 namespace ActionHelper {
 
-    void copyFromDevice(KisViewManager *view,
-                        KisPaintDeviceSP device,
-                        bool makeSharpClip = false,
-                        const KisTimeSpan &range = KisTimeSpan())
+    /**
+     * Creates a clip of \p device masked with \p selection. The top-left
+     * corner of the clip in image coordinates is returned in \p clipOffset.
+     * The call doesn't access any GUI objects, so it can be made from
+     * a stroke job.
+     */
+    KisPaintDeviceSP createClip(KisImageSP image,
+                                KisSelectionSP selection,
+                                KisPaintDeviceSP device,
+                                bool makeSharpClip,
+                                QPoint *clipOffset)
     {
-        KisImageWSP image = view->image();
-        if (!image) return;
-
-        KisSelectionSP selection = view->selection();
-
         QRect rc = (selection) ? selection->selectedExactRect() : image->bounds();
 
         KisPaintDeviceSP clip = new KisPaintDevice(device->colorSpace());
@@ -119,7 +121,21 @@ namespace ActionHelper {
             }
         }
 
-        KisClipboard::instance()->setClip(clip, rc.topLeft(), range);
+        *clipOffset = rc.topLeft();
+        return clip;
+    }
+
+    void copyFromDevice(KisViewManager *view,
+                        KisPaintDeviceSP device,
+                        bool makeSharpClip = false,
+                        const KisTimeSpan &range = KisTimeSpan())
+    {
+        KisImageWSP image = view->image();
+        if (!image) return;
+
+        QPoint clipOffset;
+        KisPaintDeviceSP clip = createClip(image, view->selection(), device, makeSharpClip, &clipOffset);
+        KisClipboard::instance()->setClip(clip, clipOffset, range);
     }
 
 }
@@ -371,14 +387,32 @@ void KisCutCopyActionFactory::run(bool willCut, bool makeSharpClip, KisViewManag
 
 void KisCopyMergedActionFactory::run(KisViewManager *view)
 {
-    KisImageWSP image = view->image();
+    KisImageSP image = view->image();
     if (!image) return;
-    if (!view->blockUntilOperationsFinished(image)) return;
 
-    image->barrierLock();
-    KisPaintDeviceSP dev = image->root()->projection();
-    ActionHelper::copyFromDevice(view, dev);
-    image->unlock();
+    /**
+     * Copying the projection of a big image may take a while, so do it
+     * in a barrier job of the image instead of waiting for the pending
+     * operations in the GUI thread. The clipboard is updated when the
+     * clip is ready.
+     */
+    KisSelectionSP selection = view->selection();
+    QSharedPointer<QPoint> clipOffset(new QPoint());
+    QSharedPointer<KisPaintDeviceSP> clip(new KisPaintDeviceSP());
+    KisImageWSP weakImage(image);
+
+    image->runBarrierAsync(
+        [weakImage, selection, clip, clipOffset] () {
+            KisImageSP image = weakImage;
+            if (!image) return;
+
+            *clip = ActionHelper::createClip(image, selection, image->root()->projection(),
+                                             false, clipOffset.data());
+        },
+        [clip, clipOffset] () {
+            if (!*clip) return;
+            KisClipboard::instance()->setClip(*clip, *clipOffset);
+        });
 
     KisProcessingApplicator *ap = beginAction(view, kundo2_i18n("Copy Merged"));
     endAction(ap, KisOperationConfiguration(id()).toXML());
@@ -970,6 +970,12 @@ QRect KisCanvas2::regionOfInterest() const
     return m_d->regionOfInterest;
 }
 
+QRect KisCanvas2::visibleImageRect() const
+{
+    return m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect() &
+        m_d->coordinatesConverter->imageRectInImagePixels();
+}
+
 void KisCanvas2::slotUpdateRegionOfInterest()
 {
     const QRect oldRegionOfInterest = m_d->regionOfInterest;
@@ -984,6 +990,10 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         emit sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
+
+    if (m_d->view->isCurrent()) {
+        image()->setVisibleRect(visibleImageRect());
+    }
 }
 
 void KisCanvas2::slotReferenceImagesChanged()
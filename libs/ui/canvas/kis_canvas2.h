@@ -209,6 +209,11 @@ public: // KisCanvas2 methods
      */
     QRect regionOfInterest() const;
 
+    /**
+     * @return area of the image (in image coordinates) that is visible on the canvas
+     */
+    QRect visibleImageRect() const;
+
     /**
      * Set artificial limit outside which the image will not be rendered
      * \p rc is measured in image pixels
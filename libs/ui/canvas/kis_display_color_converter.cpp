@@ -409,6 +409,7 @@ KisDisplayColorConverter::conversionFlags()
 
     if (cfg.useBlackPointCompensation()) conversionFlags |= KoColorConversionTransformation::BlackpointCompensation;
     if (!cfg.allowLCMSOptimization()) conversionFlags |= KoColorConversionTransformation::NoOptimization;
+    if (cfg.useLutColorConversion()) conversionFlags |= KoColorConversionTransformation::BakeToLut;
 
     return conversionFlags;
 }
@@ -656,6 +656,7 @@ ColorSettingsTab::ColorSettingsTab(QWidget *parent, const char *name)
 
     m_page->chkBlackpoint->setChecked(cfg.useBlackPointCompensation());
     m_page->chkAllowLCMSOptimization->setChecked(cfg.allowLCMSOptimization());
+    m_page->chkUseLutColorConversion->setChecked(cfg.useLutColorConversion());
     m_page->chkForcePaletteColor->setChecked(cfg.forcePaletteColors());
     KisImageConfig cfgImage(true);
 
@@ -789,6 +790,7 @@ void ColorSettingsTab::setDefault()
 
     m_page->chkBlackpoint->setChecked(cfg.useBlackPointCompensation(true));
     m_page->chkAllowLCMSOptimization->setChecked(cfg.allowLCMSOptimization(true));
+    m_page->chkUseLutColorConversion->setChecked(cfg.useLutColorConversion(true));
     m_page->chkForcePaletteColor->setChecked(cfg.forcePaletteColors(true));
     m_page->cmbMonitorIntent->setCurrentIndex(cfg.monitorRenderIntent(true));
     m_page->chkUseSystemMonitorProfile->setChecked(cfg.useSystemMonitorProfile(true));
@@ -1071,6 +1073,7 @@ void PerformanceTab::load(bool requestDefault)
 
     sliderThreadsLimit->setValue(m_lastUsedThreadsLimit);
     sliderFrameClonesLimit->setValue(m_lastUsedClonesLimit);
+    chkAdaptiveThreadCount->setChecked(cfg.useAdaptiveThreadCount(requestDefault));
 
     sliderFpsLimit->setValue(cfg.fpsLimit(requestDefault));
 
@@ -1134,6 +1137,7 @@ void PerformanceTab::save()
 
     cfg.setMaxNumberOfThreads(sliderThreadsLimit->value());
     cfg.setFrameRenderingClones(sliderFrameClonesLimit->value());
+    cfg.setUseAdaptiveThreadCount(chkAdaptiveThreadCount->isChecked());
     cfg.setFpsLimit(sliderFpsLimit->value());
 
     {
@@ -1873,6 +1877,7 @@ bool KisDlgPreferences::editPreferences()
                                           (double)m_colorSettings->m_page->sldAdaptationState->value()/20);
         cfg.setUseBlackPointCompensation(m_colorSettings->m_page->chkBlackpoint->isChecked());
         cfg.setAllowLCMSOptimization(m_colorSettings->m_page->chkAllowLCMSOptimization->isChecked());
+        cfg.setUseLutColorConversion(m_colorSettings->m_page->chkUseLutColorConversion->isChecked());
         cfg.setForcePaletteColors(m_colorSettings->m_page->chkForcePaletteColor->isChecked());
         cfg.setPasteBehaviour(m_colorSettings->m_pasteBehaviourGroup.checkedId());
         cfg.setRenderIntent(m_colorSettings->m_page->cmbMonitorIntent->currentIndex());
@@ -61,7 +61,17 @@ void ImageSize::slotImageSize()
     KisImageSP image = viewManager()->image().toStrongRef();
     if (!image) return;
 
-    if(!viewManager()->blockUntilOperationsFinished(image)) return;
+    /**
+     * The dialog needs the size of the image after all the pending
+     * operations, but the GUI is not blocked while waiting for them
+     */
+    viewManager()->runWhenOperationsFinished(image, [this] () { showImageSizeDialog(); });
+}
+
+void ImageSize::showImageSizeDialog()
+{
+    KisImageSP image = viewManager()->image().toStrongRef();
+    if (!image) return;
 
     DlgImageSize * dlgImageSize = new DlgImageSize(viewManager()->mainWindow(), image->width(), image->height(), image->yRes());
     Q_CHECK_PTR(dlgImageSize);
@@ -78,10 +88,16 @@ void ImageSize::slotImageSize()
 
 void ImageSize::slotCanvasSize()
 {
-    KisImageWSP image = viewManager()->image();
+    KisImageSP image = viewManager()->image().toStrongRef();
     if (!image) return;
 
-    if(!viewManager()->blockUntilOperationsFinished(image)) return;
+    viewManager()->runWhenOperationsFinished(image, [this] () { showCanvasSizeDialog(); });
+}
+
+void ImageSize::showCanvasSizeDialog()
+{
+    KisImageWSP image = viewManager()->image();
+    if (!image) return;
 
     DlgCanvasSize * dlgCanvasSize = new DlgCanvasSize(viewManager()->mainWindow(), image->width(), image->height(), image->yRes());
     Q_CHECK_PTR(dlgCanvasSize);
@@ -99,10 +115,20 @@ void ImageSize::slotCanvasSize()
 
 void ImageSize::scaleLayerImpl(KisNodeSP rootNode)
 {
-    KisImageWSP image = viewManager()->image();
+    KisImageSP image = viewManager()->image().toStrongRef();
     if (!image) return;
 
-    if(!viewManager()->blockUntilOperationsFinished(image)) return;
+    /**
+     * The bounds of the layer are valid only when all the pending
+     * updates are finished
+     */
+    viewManager()->runWhenOperationsFinished(image, [this, rootNode] () { showLayerSizeDialog(rootNode); });
+}
+
+void ImageSize::showLayerSizeDialog(KisNodeSP rootNode)
+{
+    KisImageWSP image = viewManager()->image();
+    if (!image) return;
 
     QRect bounds;
     KisSelectionSP selection = viewManager()->selection();
@@ -147,10 +173,16 @@ void ImageSize::slotScaleAllLayers()
 
 void ImageSize::slotSelectionScale()
 {
-    KisImageSP image = viewManager()->image();
+    KisImageSP image = viewManager()->image().toStrongRef();
     if (!image) return;
 
-    if(!viewManager()->blockUntilOperationsFinished(image)) return;
+    viewManager()->runWhenOperationsFinished(image, [this] () { showSelectionScaleDialog(); });
+}
+
+void ImageSize::showSelectionScaleDialog()
+{
+    KisImageSP image = viewManager()->image().toStrongRef();
+    if (!image) return;
 
     KisLayerSP layer = viewManager()->activeLayer();
 
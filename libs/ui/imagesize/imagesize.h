@@ -23,6 +23,11 @@ public:
 private:
     void scaleLayerImpl(KisNodeSP rootNode);
 
+    void showImageSizeDialog();
+    void showCanvasSizeDialog();
+    void showLayerSizeDialog(KisNodeSP rootNode);
+    void showSelectionScaleDialog();
+
 private Q_SLOTS:
 
     void slotImageSize();
@@ -627,6 +627,16 @@ void KisConfig::setAllowLCMSOptimization(bool allowLCMSOptimization)
     m_cfg.writeEntry("allowLCMSOptimization", allowLCMSOptimization);
 }
 
+bool KisConfig::useLutColorConversion(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("useLutColorConversion", false));
+}
+
+void KisConfig::setUseLutColorConversion(bool useLutColorConversion)
+{
+    m_cfg.writeEntry("useLutColorConversion", useLutColorConversion);
+}
+
 bool KisConfig::forcePaletteColors(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("colorsettings/forcepalettecolors", false));
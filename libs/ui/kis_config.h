@@ -153,6 +153,15 @@ public:
     bool allowLCMSOptimization(bool defaultValue = false) const;
     void setAllowLCMSOptimization(bool allowLCMSOptimization);
 
+    /**
+     * Approximate the display conversions with a 3D lookup table
+     * (KoColorConversionTransformation::BakeToLut). Faster for high
+     * bit depth RGB images, but slightly less precise. Never used
+     * for the conversions of the image data itself.
+     */
+    bool useLutColorConversion(bool defaultValue = false) const;
+    void setUseLutColorConversion(bool useLutColorConversion);
+
     bool forcePaletteColors(bool defaultValue = false) const;
     void setForcePaletteColors(bool forcePaletteColors);
 
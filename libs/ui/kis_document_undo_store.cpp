@@ -8,6 +8,7 @@
 
 #include "KisDocument.h"
 #include <kundo2stack.h>
+#include "tiles3/kis_tile_data_store.h"
 
 
 /*****************************************************************/
@@ -18,6 +19,14 @@ KisDocumentUndoStore::KisDocumentUndoStore(KisDocument *doc)
     : m_doc(doc)
 {
     connect(doc->undoStack(), SIGNAL(indexChanged(int)), this, SIGNAL(historyStateChanged()));
+
+    /**
+     * Let the paint devices know about the commands that don't touch
+     * them, otherwise they might compact their revisions across them
+     */
+    connect(doc->undoStack(), &KUndo2QStack::indexChanged, this, [] () {
+        KisTileDataStore::instance()->notifyUndoHistoryChanged();
+    });
 }
 
 const KUndo2Command* KisDocumentUndoStore::presentCommand()
@@ -670,8 +670,18 @@ KisNodeSP KisLayerManager::addGeneratorLayer(KisNodeSP activeNode)
 void KisLayerManager::flattenImage()
 {
     KisImageSP image = m_view->image();
+    if (!image) return;
 
-    if (!m_view->blockUntilOperationsFinished(image)) return;
+    /**
+     * The number of the hidden layers is known only when all the
+     * pending operations are finished
+     */
+    m_view->runWhenOperationsFinished(image, [this] () { flattenImageImpl(); });
+}
+
+void KisLayerManager::flattenImageImpl()
+{
+    KisImageSP image = m_view->image();
 
     if (image) {
         bool doIt = true;
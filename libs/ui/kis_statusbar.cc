@@ -290,7 +290,7 @@ void KisStatusBar::updateMemoryStatus()
             ->fetchMemoryStatistics(m_imageView ? m_imageView->image() : 0);
     const KFormat format;
 
-    const QString imageStatsMsg =
+    QString imageStatsMsg =
             i18nc("tooltip on statusbar memory reporting button (image stats)",
                   "Image size:\t %1\n"
                   "  - layers:\t\t %2\n"
@@ -301,14 +301,29 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.projectionsSize),
                   format.formatByteSize(stats.lodSize));
 
+    if (stats.documentMemoryLimit > 0) {
+        imageStatsMsg +=
+            i18nc("tooltip on statusbar memory reporting button (image stats)",
+                  "  - in memory:\t %1 / %2\n",
+                  format.formatByteSize(stats.documentMemorySize),
+                  format.formatByteSize(stats.documentMemoryLimit));
+    } else {
+        imageStatsMsg +=
+            i18nc("tooltip on statusbar memory reporting button (image stats)",
+                  "  - in memory:\t %1\n",
+                  format.formatByteSize(stats.documentMemorySize));
+    }
+
     const QString memoryStatsMsg =
             i18nc("tooltip on statusbar memory reporting button (total stats)",
                   "Memory used:\t %1 / %2\n"
                   "  image data:\t %3 / %4\n"
                   "  pool:\t\t %5 / %6\n"
                   "  undo data:\t %7\n"
+                  "  deduplicated:\t %8\n"
                   "\n"
-                  "Swap used:\t %8",
+                  "Swap used:\t %9\n"
+                  "Swap-out speed:\t %10/s",
                   format.formatByteSize(stats.totalMemorySize),
                   format.formatByteSize(stats.totalMemoryLimit),
 
@@ -319,7 +334,9 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.tilesPoolLimit),
 
                   format.formatByteSize(stats.historicalMemorySize),
-                  format.formatByteSize(stats.swapSize));
+                  format.formatByteSize(stats.deduplicatedSize),
+                  format.formatByteSize(stats.swapSize),
+                  format.formatByteSize(stats.swapOutThroughput));
 
     QString longStats = imageStatsMsg + "\n" + memoryStatsMsg;
 
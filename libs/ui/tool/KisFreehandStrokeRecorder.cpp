@@ -0,0 +1,353 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFreehandStrokeRecorder.h"
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+
+#include <KoColorSpace.h>
+#include <kundo2magicstring.h>
+
+#include <brushengine/kis_paintop_preset.h>
+#include "kis_node.h"
+#include "kis_dom_utils.h"
+#include "kis_debug.h"
+
+Q_GLOBAL_STATIC(KisFreehandStrokeRecorder, s_instance)
+
+namespace {
+
+const QString ROOT_TAG = "strokelog";
+const QString STROKE_TAG = "stroke";
+const QString JOB_TAG = "job";
+
+void saveColor(QDomDocument &doc, QDomElement &parent, const QString &tag, const KoColor &color)
+{
+    QDomElement colorElt = doc.createElement(tag);
+    colorElt.setAttribute("channeldepth", color.colorSpace()->colorDepthId().id());
+    color.toXML(doc, colorElt);
+    parent.appendChild(colorElt);
+}
+
+KoColor loadColor(const QDomElement &parent, const QString &tag)
+{
+    QDomElement colorElt = parent.firstChildElement(tag);
+    if (colorElt.isNull()) return KoColor();
+
+    bool ok = false;
+    KoColor color = KoColor::fromXML(colorElt.firstChildElement(),
+                                     colorElt.attribute("channeldepth"), &ok);
+    return ok ? color : KoColor();
+}
+
+void savePaintInformation(QDomDocument &doc, QDomElement &parent, const QString &tag, const KisPaintInformation &pi)
+{
+    QDomElement piElt = doc.createElement(tag);
+    pi.toXML(doc, piElt);
+    parent.appendChild(piElt);
+}
+
+void savePoint(QDomElement &elt, const QString &prefix, const QPointF &pt)
+{
+    elt.setAttribute(prefix + "X", KisDomUtils::toString(pt.x()));
+    elt.setAttribute(prefix + "Y", KisDomUtils::toString(pt.y()));
+}
+
+QPointF loadPoint(const QDomElement &elt, const QString &prefix)
+{
+    return QPointF(KisDomUtils::toDouble(elt.attribute(prefix + "X", "0.0")),
+                   KisDomUtils::toDouble(elt.attribute(prefix + "Y", "0.0")));
+}
+
+}
+
+struct KisFreehandStrokeRecorder::Private
+{
+    QMutex lock;
+    QElapsedTimer sessionTimer;
+    QElapsedTimer strokeTimer;
+
+    QFile file;
+    QTextStream stream;
+
+    QDomDocument strokeDoc;
+    QDomElement strokeElt;
+
+    /**
+     * Checked before taking the lock and once again under it, the log
+     * may be finished by another thread in between
+     */
+    QAtomicInt isEnabled;
+
+    QDomElement createJob(const QString &type, int strokeInfoId) {
+        QDomElement jobElt = strokeDoc.createElement(JOB_TAG);
+        jobElt.setAttribute("type", type);
+        jobElt.setAttribute("strokeInfoId", strokeInfoId);
+        jobElt.setAttribute("time", QString::number(strokeTimer.nsecsElapsed() / 1000));
+        strokeElt.appendChild(jobElt);
+        return jobElt;
+    }
+
+    void finishLog() {
+        QMutexLocker l(&lock);
+
+        if (!isEnabled.loadAcquire()) return;
+        isEnabled.storeRelease(false);
+
+        stream << "</" << ROOT_TAG << ">\n";
+        stream.flush();
+        file.close();
+    }
+};
+
+KisFreehandStrokeRecorder::KisFreehandStrokeRecorder()
+    : m_d(new Private)
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv("KRITA_STROKE_LOG"));
+    if (fileName.isEmpty()) return;
+
+    m_d->file.setFileName(fileName);
+    if (!m_d->file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisFreehandStrokeRecorder: failed to open" << fileName << "for writing";
+        return;
+    }
+
+    m_d->stream.setDevice(&m_d->file);
+    m_d->stream.setCodec("UTF-8");
+    m_d->stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    m_d->stream << "<" << ROOT_TAG << " version=\"1\">\n";
+
+    m_d->sessionTimer.start();
+    m_d->isEnabled.storeRelease(true);
+
+    /**
+     * The log is finished when the event loop quits, the order of
+     * destruction of the global statics is undefined
+     */
+    if (QCoreApplication::instance()) {
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                         [this] () { m_d->finishLog(); });
+    } else {
+        warnKrita << "KisFreehandStrokeRecorder: no application object, the log" << fileName << "will not be finished";
+    }
+}
+
+KisFreehandStrokeRecorder::~KisFreehandStrokeRecorder()
+{
+}
+
+KisFreehandStrokeRecorder* KisFreehandStrokeRecorder::instance()
+{
+    return s_instance;
+}
+
+bool KisFreehandStrokeRecorder::isEnabled() const
+{
+    return m_d->isEnabled.loadAcquire();
+}
+
+void KisFreehandStrokeRecorder::startStroke(KisResourcesSnapshotSP resources, int numStrokeInfos, const KUndo2MagicString &name)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->lock);
+    if (!m_d->isEnabled.loadAcquire()) return;
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->strokeElt.isNull());
+
+    m_d->strokeDoc = QDomDocument();
+    m_d->strokeElt = m_d->strokeDoc.createElement(STROKE_TAG);
+    m_d->strokeDoc.appendChild(m_d->strokeElt);
+    m_d->strokeTimer.start();
+
+    KisNodeSP node = resources->currentNode();
+
+    m_d->strokeElt.setAttribute("node", node ? node->name() : QString());
+    m_d->strokeElt.setAttribute("name", name.toString());
+    m_d->strokeElt.setAttribute("time", QString::number(m_d->sessionTimer.nsecsElapsed() / 1000));
+    m_d->strokeElt.setAttribute("numStrokeInfos", numStrokeInfos);
+    m_d->strokeElt.setAttribute("opacity", resources->opacity());
+    m_d->strokeElt.setAttribute("compositeOp", resources->compositeOpId());
+
+    saveColor(m_d->strokeDoc, m_d->strokeElt, "fgColor", resources->currentFgColor());
+    saveColor(m_d->strokeDoc, m_d->strokeElt, "bgColor", resources->currentBgColor());
+
+    KisPaintOpPresetSP preset = resources->currentPaintOpPreset();
+    if (preset) {
+        QDomElement presetElt = m_d->strokeDoc.createElement("preset");
+        preset->toXML(m_d->strokeDoc, presetElt);
+        m_d->strokeElt.appendChild(presetElt);
+    }
+}
+
+void KisFreehandStrokeRecorder::endStroke(bool cancelled)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->lock);
+    if (!m_d->isEnabled.loadAcquire()) return;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->strokeElt.isNull());
+
+    if (cancelled) {
+        m_d->strokeElt.setAttribute("cancelled", 1);
+    }
+
+    m_d->strokeElt.save(m_d->stream, 1);
+    m_d->stream.flush();
+
+    m_d->strokeElt = QDomElement();
+    m_d->strokeDoc = QDomDocument();
+}
+
+void KisFreehandStrokeRecorder::paintAt(int strokeInfoId, const KisPaintInformation &pi)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->lock);
+    if (!m_d->isEnabled.loadAcquire()) return;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->strokeElt.isNull());
+
+    QDomElement jobElt = m_d->createJob("point", strokeInfoId);
+    savePaintInformation(m_d->strokeDoc, jobElt, "pi1", pi);
+}
+
+void KisFreehandStrokeRecorder::paintLine(int strokeInfoId, const KisPaintInformation &pi1, const KisPaintInformation &pi2)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->lock);
+    if (!m_d->isEnabled.loadAcquire()) return;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->strokeElt.isNull());
+
+    QDomElement jobElt = m_d->createJob("line", strokeInfoId);
+    savePaintInformation(m_d->strokeDoc, jobElt, "pi1", pi1);
+    savePaintInformation(m_d->strokeDoc, jobElt, "pi2", pi2);
+}
+
+void KisFreehandStrokeRecorder::paintBezierCurve(int strokeInfoId,
+                                                 const KisPaintInformation &pi1,
+                                                 const QPointF &control1,
+                                                 const QPointF &control2,
+                                                 const KisPaintInformation &pi2)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->lock);
+    if (!m_d->isEnabled.loadAcquire()) return;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->strokeElt.isNull());
+
+    QDomElement jobElt = m_d->createJob("curve", strokeInfoId);
+    savePaintInformation(m_d->strokeDoc, jobElt, "pi1", pi1);
+    savePaintInformation(m_d->strokeDoc, jobElt, "pi2", pi2);
+    savePoint(jobElt, "control1", control1);
+    savePoint(jobElt, "control2", control2);
+}
+
+bool KisFreehandStrokeRecorder::loadLog(const QString &fileName,
+                                        KisResourcesInterfaceSP resourcesInterface,
+                                        QVector<Stroke> *strokes)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        warnKrita << "KisFreehandStrokeRecorder: failed to open" << fileName;
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+
+    /**
+     * If Krita crashed, the log has no closing tag. All the strokes
+     * saved before the crash are still complete, so just close it.
+     */
+    if (!data.trimmed().endsWith("</" + ROOT_TAG.toLatin1() + ">")) {
+        data += "</" + ROOT_TAG.toLatin1() + ">\n";
+    }
+
+    QDomDocument doc;
+    QString errorMsg;
+    int errorLine = 0;
+    if (!doc.setContent(data, &errorMsg, &errorLine)) {
+        warnKrita << "KisFreehandStrokeRecorder: failed to parse" << fileName
+                  << "line" << errorLine << ":" << errorMsg;
+        return false;
+    }
+
+    QDomElement root = doc.documentElement();
+    if (root.tagName() != ROOT_TAG) return false;
+
+    for (QDomElement strokeElt = root.firstChildElement(STROKE_TAG);
+         !strokeElt.isNull();
+         strokeElt = strokeElt.nextSiblingElement(STROKE_TAG)) {
+
+        Stroke stroke;
+        stroke.nodeName = strokeElt.attribute("node");
+        stroke.name = strokeElt.attribute("name");
+        stroke.time = strokeElt.attribute("time", "0").toLongLong();
+        stroke.numStrokeInfos = qMax(1, strokeElt.attribute("numStrokeInfos", "1").toInt());
+        stroke.cancelled = strokeElt.attribute("cancelled", "0").toInt();
+        stroke.opacity = strokeElt.attribute("opacity", QString::number(OPACITY_OPAQUE_U8)).toInt();
+        stroke.compositeOpId = strokeElt.attribute("compositeOp");
+        stroke.fgColor = loadColor(strokeElt, "fgColor");
+        stroke.bgColor = loadColor(strokeElt, "bgColor");
+
+        QDomElement presetElt = strokeElt.firstChildElement("preset");
+        if (!presetElt.isNull()) {
+            stroke.preset = KisPaintOpPresetSP(new KisPaintOpPreset());
+            stroke.preset->fromXML(presetElt, resourcesInterface);
+            if (!stroke.preset->valid()) {
+                warnKrita << "KisFreehandStrokeRecorder: failed to load preset"
+                          << presetElt.attribute("name");
+                stroke.preset.clear();
+            }
+        }
+
+        for (QDomElement jobElt = strokeElt.firstChildElement(JOB_TAG);
+             !jobElt.isNull();
+             jobElt = jobElt.nextSiblingElement(JOB_TAG)) {
+
+            Job job;
+            const QString type = jobElt.attribute("type");
+
+            if (type == "point") {
+                job.type = Job::POINT;
+            } else if (type == "line") {
+                job.type = Job::LINE;
+            } else if (type == "curve") {
+                job.type = Job::CURVE;
+            } else {
+                warnKrita << "KisFreehandStrokeRecorder: unknown job type" << type;
+                continue;
+            }
+
+            job.strokeInfoId = jobElt.attribute("strokeInfoId", "0").toInt();
+            job.time = jobElt.attribute("time", "0").toLongLong();
+            job.pi1 = KisPaintInformation::fromXML(jobElt.firstChildElement("pi1"));
+
+            if (job.type != Job::POINT) {
+                job.pi2 = KisPaintInformation::fromXML(jobElt.firstChildElement("pi2"));
+            }
+
+            if (job.type == Job::CURVE) {
+                job.control1 = loadPoint(jobElt, "control1");
+                job.control2 = loadPoint(jobElt, "control2");
+            }
+
+            stroke.jobs.append(job);
+        }
+
+        strokes->append(stroke);
+    }
+
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_FREEHAND_STROKE_RECORDER_H
+#define __KIS_FREEHAND_STROKE_RECORDER_H
+
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+#include <QPointF>
+#include <QSharedPointer>
+
+#include <KoColor.h>
+
+#include "kis_types.h"
+#include "kis_resources_snapshot.h"
+#include <brushengine/kis_paint_information.h>
+
+#include "kritaui_export.h"
+
+class KUndo2MagicString;
+class KisResourcesInterface;
+typedef QSharedPointer<KisResourcesInterface> KisResourcesInterfaceSP;
+
+/**
+ * Records the freehand strokes of a painting session into an XML log,
+ * so that the session could be replayed later against the same image
+ * without the GUI (see KisStrokeReplayBenchmark).
+ *
+ * For every stroke the recorder saves the name of the node, the preset,
+ * the colors, opacity and composite op, the number of stroke infos
+ * (e.g. for the multibrush tool) and the sequence of the painting jobs
+ * passed to FreehandStrokeStrategy together with the time of their
+ * submission.
+ *
+ * The recording is activated by setting KRITA_STROKE_LOG environment
+ * variable to the name of the log file. The log is finalized when
+ * the application is about to quit.
+ *
+ * NOTE: the preset is saved without its embedded resources, so the
+ *       brush tips and patterns it uses should be available when
+ *       the log is replayed
+ */
+class KRITAUI_EXPORT KisFreehandStrokeRecorder
+{
+public:
+    struct Job {
+        enum Type {
+            POINT,
+            LINE,
+            CURVE
+        };
+
+        Type type = POINT;
+        int strokeInfoId = 0;
+
+        /// the time of submission since the start of the stroke, in microseconds
+        qint64 time = 0;
+
+        KisPaintInformation pi1;
+        KisPaintInformation pi2;
+        QPointF control1;
+        QPointF control2;
+    };
+
+    struct Stroke {
+        QString nodeName;
+        QString name;
+
+        /// the time of the start of the stroke since the start of the session, in microseconds
+        qint64 time = 0;
+
+        int numStrokeInfos = 1;
+        bool cancelled = false;
+
+        KisPaintOpPresetSP preset;
+        KoColor fgColor;
+        KoColor bgColor;
+        quint8 opacity = OPACITY_OPAQUE_U8;
+        QString compositeOpId;
+
+        QVector<Job> jobs;
+    };
+
+public:
+    KisFreehandStrokeRecorder();
+    ~KisFreehandStrokeRecorder();
+
+    static KisFreehandStrokeRecorder* instance();
+
+    bool isEnabled() const;
+
+    void startStroke(KisResourcesSnapshotSP resources, int numStrokeInfos, const KUndo2MagicString &name);
+    void endStroke(bool cancelled);
+
+    void paintAt(int strokeInfoId, const KisPaintInformation &pi);
+    void paintLine(int strokeInfoId, const KisPaintInformation &pi1, const KisPaintInformation &pi2);
+    void paintBezierCurve(int strokeInfoId,
+                          const KisPaintInformation &pi1,
+                          const QPointF &control1,
+                          const QPointF &control2,
+                          const KisPaintInformation &pi2);
+
+    /**
+     * Reads the strokes from a log saved by the recorder. Returns false
+     * if the file cannot be read or parsed.
+     */
+    static bool loadLog(const QString &fileName,
+                        KisResourcesInterfaceSP resourcesInterface,
+                        QVector<Stroke> *strokes);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_FREEHAND_STROKE_RECORDER_H */
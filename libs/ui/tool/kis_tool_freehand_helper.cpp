@@ -35,6 +35,7 @@
 #include "strokes/KisFreehandStrokeInfo.h"
 #include "KisAsyncronousStrokeUpdateHelper.h"
 #include "kis_canvas_resource_provider.h"
+#include "KisFreehandStrokeRecorder.h"
 
 #include <math.h>
 
@@ -297,6 +298,10 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
 
     m_d->strokeId = m_d->strokesFacade->startStroke(stroke);
 
+    KisFreehandStrokeRecorder::instance()->startStroke(m_d->resources,
+                                                       m_d->strokeInfos.size(),
+                                                       m_d->transactionText);
+
     m_d->history.clear();
     m_d->distanceHistory.clear();
 
@@ -634,6 +639,8 @@ void KisToolFreehandHelper::endPaint()
 
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
+
+    KisFreehandStrokeRecorder::instance()->endStroke(false);
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -664,6 +671,8 @@ void KisToolFreehandHelper::cancelPaint()
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
 
+    KisFreehandStrokeRecorder::instance()->endStroke(true);
+
 }
 
 int KisToolFreehandHelper::elapsedStrokeTime() const
@@ -897,6 +906,8 @@ void KisToolFreehandHelper::paintAt(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi));
 
+    KisFreehandStrokeRecorder::instance()->paintAt(strokeInfoId, pi);
+
 }
 
 void KisToolFreehandHelper::paintLine(int strokeInfoId,
@@ -907,6 +918,8 @@ void KisToolFreehandHelper::paintLine(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
 
+    KisFreehandStrokeRecorder::instance()->paintLine(strokeInfoId, pi1, pi2);
+
 }
 
 void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
@@ -944,6 +957,8 @@ void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
                                new FreehandStrokeStrategy::Data(strokeInfoId,
                                                                 pi1, control1, control2, pi2));
 
+    KisFreehandStrokeRecorder::instance()->paintBezierCurve(strokeInfoId, pi1, control1, control2, pi2);
+
 }
 
 void KisToolFreehandHelper::createPainters(QVector<KisFreehandStrokeInfo*> &strokeInfos,
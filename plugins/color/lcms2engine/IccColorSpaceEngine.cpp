@@ -39,6 +39,7 @@ public:
             }
         }
         conversionFlags |= KoColorConversionTransformation::CopyAlpha;
+        conversionFlags &= ~KoColorConversionTransformation::BakeToLut;
 
         m_transform = cmsCreateTransform(srcProfile->lcmsProfile(),
                                          srcColorSpaceType,
@@ -97,6 +98,7 @@ public:
             }
         }
         conversionFlags |= KoColorConversionTransformation::CopyAlpha;
+        conversionFlags &= ~KoColorConversionTransformation::BakeToLut;
 
         quint16 alarm[cmsMAXCHANNELS];//this seems to be bgr???
         alarm[0] = (cmsUInt16Number)gamutWarning[2]*256;
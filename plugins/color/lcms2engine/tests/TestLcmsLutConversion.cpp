@@ -0,0 +1,275 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestLcmsLutConversion.h"
+
+#include <simpletest.h>
+#include "sdk/tests/testpigment.h"
+
+#include <random>
+
+#include <QElapsedTimer>
+
+#include "kis_debug.h"
+
+#include "KoColorConversionCache.h"
+#include "KoColorModelStandardIds.h"
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoLutColorConversionTransformation.h"
+
+namespace {
+
+const KoColorSpace* colorSpace(const KoID &model, const KoID &depth, const KoColorProfile *profile = 0)
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(model.id(), depth.id(), profile);
+}
+
+}
+
+void TestLcmsLutConversion::testIsSupported()
+{
+    const KoColorSpace *rgb8 = colorSpace(RGBAColorModelID, Integer8BitsColorDepthID);
+    const KoColorSpace *rgb16 = colorSpace(RGBAColorModelID, Integer16BitsColorDepthID);
+    const KoColorSpace *rgbF32 = colorSpace(RGBAColorModelID, Float32BitsColorDepthID);
+    const KoColorSpace *cmyk8 = colorSpace(CMYKAColorModelID, Integer8BitsColorDepthID);
+    const KoColorSpace *lab16 = colorSpace(LABAColorModelID, Integer16BitsColorDepthID);
+
+    QVERIFY(KoLutColorConversionTransformation::isSupported(rgb16, cmyk8));
+    QVERIFY(KoLutColorConversionTransformation::isSupported(rgbF32, rgb8));
+    QVERIFY(KoLutColorConversionTransformation::isSupported(rgb16, lab16));
+
+    // 8-bit sources and non-RGB sources are not baked
+    QVERIFY(!KoLutColorConversionTransformation::isSupported(rgb8, cmyk8));
+    QVERIFY(!KoLutColorConversionTransformation::isSupported(lab16, rgb16));
+}
+
+void TestLcmsLutConversion::testAccuracy_data()
+{
+    QTest::addColumn<QString>("srcModel");
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstModel");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<QString>("dstProfile");
+    QTest::addColumn<qreal>("tolerance");
+
+    const QString p2020PQ = KoColorSpaceRegistry::instance()->p2020PQProfile()->name();
+    const QString p709SRGB = KoColorSpaceRegistry::instance()->p709SRGBProfile()->name();
+
+    QTest::newRow("sRGB U16 -> CMYK U8")
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << QString()
+        << CMYKAColorModelID.id() << Integer8BitsColorDepthID.id() << QString()
+        << 0.05;
+
+    QTest::newRow("sRGB U16 -> CMYK U16")
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << QString()
+        << CMYKAColorModelID.id() << Integer16BitsColorDepthID.id() << QString()
+        << 0.05;
+
+    QTest::newRow("sRGB U16 -> Lab U16")
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << QString()
+        << LABAColorModelID.id() << Integer16BitsColorDepthID.id() << QString()
+        << 0.01;
+
+    QTest::newRow("scRGB F32 -> sRGB U16")
+        << RGBAColorModelID.id() << Float32BitsColorDepthID.id() << QString()
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << p709SRGB
+        << 0.03;
+
+    // the highlights are clipped, which gives a kink inside the cells of the table
+    QTest::newRow("Rec2020 PQ U16 -> sRGB U8")
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << p2020PQ
+        << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << p709SRGB
+        << 0.1;
+}
+
+/**
+ * Compares the baked conversion against the exact one on random
+ * colors and reports the error and the speedup
+ */
+void TestLcmsLutConversion::testAccuracy()
+{
+    QFETCH(QString, srcModel);
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, dstModel);
+    QFETCH(QString, dstDepth);
+    QFETCH(QString, dstProfile);
+    QFETCH(qreal, tolerance);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcCS = srcProfile.isEmpty() ?
+        registry->colorSpace(srcModel, srcDepth, 0) :
+        registry->colorSpace(srcModel, srcDepth, srcProfile);
+
+    const KoColorSpace *dstCS = dstProfile.isEmpty() ?
+        registry->colorSpace(dstModel, dstDepth, 0) :
+        registry->colorSpace(dstModel, dstDepth, dstProfile);
+
+    if (!srcCS || !dstCS) {
+        QSKIP("the color spaces are not available");
+    }
+
+    const int numPixels = 1 << 18;
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QVector<quint8> src(numPixels * srcCS->pixelSize());
+    QVector<quint8> exact(numPixels * dstCS->pixelSize());
+    QVector<quint8> baked(numPixels * dstCS->pixelSize());
+
+    {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        QVector<float> channels(srcCS->channelCount());
+
+        for (int i = 0; i < numPixels; i++) {
+            for (int c = 0; c < channels.size(); c++) {
+                channels[c] = distribution(generator);
+            }
+            srcCS->fromNormalisedChannelsValue(src.data() + i * srcCS->pixelSize(), channels);
+        }
+    }
+
+    QScopedPointer<KoColorConversionTransformation> exactTransfo(
+        srcCS->createColorConverter(dstCS, intent, flags));
+
+    QScopedPointer<KoColorConversionTransformation> bakedTransfo(
+        srcCS->createColorConverter(dstCS, intent, flags | KoColorConversionTransformation::BakeToLut));
+
+    QVERIFY(dynamic_cast<KoLutColorConversionTransformation*>(bakedTransfo.data()));
+
+    QElapsedTimer timer;
+
+    timer.start();
+    exactTransfo->transform(src.constData(), exact.data(), numPixels);
+    const qint64 exactTime = timer.nsecsElapsed();
+
+    timer.restart();
+    bakedTransfo->transform(src.constData(), baked.data(), numPixels);
+    const qint64 bakedTime = timer.nsecsElapsed();
+
+    QVector<float> exactChannels(dstCS->channelCount());
+    QVector<float> bakedChannels(dstCS->channelCount());
+
+    qreal maxError = 0.0;
+    qreal sumError = 0.0;
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(exact.constData() + i * dstCS->pixelSize(), exactChannels);
+        dstCS->normalisedChannelsValue(baked.constData() + i * dstCS->pixelSize(), bakedChannels);
+
+        for (int c = 0; c < exactChannels.size(); c++) {
+            const qreal error = qAbs(exactChannels[c] - bakedChannels[c]);
+            maxError = qMax(maxError, error);
+            sumError += error;
+        }
+    }
+
+    const qreal meanError = sumError / (numPixels * dstCS->channelCount());
+
+    qDebug() << QTest::currentDataTag()
+             << "max error" << maxError
+             << "mean error" << meanError
+             << "exact" << exactTime / 1000000.0 << "ms"
+             << "baked" << bakedTime / 1000000.0 << "ms";
+
+    QVERIFY(maxError < tolerance);
+    QVERIFY(meanError < 0.1 * tolerance);
+}
+
+void TestLcmsLutConversion::testCachedConverter()
+{
+    const KoColorSpace *srcCS = colorSpace(RGBAColorModelID, Integer16BitsColorDepthID);
+    const KoColorSpace *dstCS = colorSpace(CMYKAColorModelID, Integer8BitsColorDepthID);
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    KoColorConversionCache *cache = KoColorSpaceRegistry::instance()->colorConversionCache();
+
+    // the baked and the exact transformations are cached separately
+    {
+        KoCachedColorConversionTransformation baked =
+            cache->cachedConverter(srcCS, dstCS, intent, flags | KoColorConversionTransformation::BakeToLut);
+        QVERIFY(dynamic_cast<const KoLutColorConversionTransformation*>(baked.transformation()));
+    }
+
+    {
+        KoCachedColorConversionTransformation exact =
+            cache->cachedConverter(srcCS, dstCS, intent, flags);
+        QVERIFY(!dynamic_cast<const KoLutColorConversionTransformation*>(exact.transformation()));
+    }
+}
+
+/**
+ * The values of floating point sources outside [0, 1] are not covered
+ * by the table, they should be converted exactly instead of clipped
+ */
+void TestLcmsLutConversion::testUnboundedSource()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcCS = colorSpace(RGBAColorModelID, Float32BitsColorDepthID);
+    const KoColorSpace *dstCS = registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(),
+                                                     registry->p2020PQProfile());
+
+    if (!srcCS || !dstCS) {
+        QSKIP("the color spaces are not available");
+    }
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    // in-range and out-of-range pixels are interleaved to check the runs
+    const QVector<float> srcValues = {
+        0.5f, 0.25f, 0.75f, 1.0f,
+        4.0f, 0.5f, 0.5f, 1.0f,
+        12.0f, 25.0f, 60.0f, 1.0f,
+        0.1f, 0.2f, 0.3f, 1.0f,
+        -0.05f, 0.5f, 0.5f, 1.0f,
+        0.9f, 0.9f, 0.9f, 1.0f,
+    };
+
+    const int numPixels = srcValues.size() / 4;
+    const bool isOutOfRange[] = {false, true, true, false, true, false};
+
+    QVector<float> exact(numPixels * 4);
+    QVector<float> baked(numPixels * 4);
+
+    QScopedPointer<KoColorConversionTransformation> exactTransfo(
+        srcCS->createColorConverter(dstCS, intent, flags));
+
+    QScopedPointer<KoColorConversionTransformation> bakedTransfo(
+        srcCS->createColorConverter(dstCS, intent, flags | KoColorConversionTransformation::BakeToLut));
+
+    QVERIFY(dynamic_cast<KoLutColorConversionTransformation*>(bakedTransfo.data()));
+
+    exactTransfo->transform(reinterpret_cast<const quint8*>(srcValues.constData()),
+                            reinterpret_cast<quint8*>(exact.data()), numPixels);
+    bakedTransfo->transform(reinterpret_cast<const quint8*>(srcValues.constData()),
+                            reinterpret_cast<quint8*>(baked.data()), numPixels);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int c = 0; c < 4; c++) {
+            const float exactValue = exact[i * 4 + c];
+            const float bakedValue = baked[i * 4 + c];
+
+            if (isOutOfRange[i]) {
+                QCOMPARE(bakedValue, exactValue);
+            } else {
+                QVERIFY2(qAbs(bakedValue - exactValue) < 0.03f,
+                         qPrintable(QString("pixel %1 channel %2: %3 vs %4")
+                                    .arg(i).arg(c).arg(bakedValue).arg(exactValue)));
+            }
+        }
+    }
+}
+
+KISTEST_MAIN(TestLcmsLutConversion)
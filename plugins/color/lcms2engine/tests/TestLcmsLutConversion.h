@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTLCMSLUTCONVERSION_H
+#define TESTLCMSLUTCONVERSION_H
+
+#include <QObject>
+
+class TestLcmsLutConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIsSupported();
+    void testAccuracy_data();
+    void testAccuracy();
+    void testCachedConverter();
+    void testUnboundedSource();
+};
+
+#endif // TESTLCMSLUTCONVERSION_H
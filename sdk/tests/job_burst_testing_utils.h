@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __JOB_BURST_TESTING_UTILS_H
+#define __JOB_BURST_TESTING_UTILS_H
+
+#include <QAtomicInt>
+#include <QRunnable>
+
+
+namespace TestUtil {
+
+/**
+ * Emulates a stroke that consists of a sequential job followed by a
+ * burst of small concurrent jobs. The children are started right from
+ * the worker thread, like KisUpdaterContext does it when a job finishes.
+ *
+ * \p Executor is anything with start(QRunnable*), e.g. QThreadPool or
+ * KisWorkStealingExecutor. Every finished job increments \p counter,
+ * so a burst adds numChildren + 1 to it.
+ */
+template <class Executor>
+class BurstRunnable : public QRunnable
+{
+public:
+    BurstRunnable(Executor *executor, QAtomicInt &counter,
+                  int numChildren, int workAmount = 0)
+        : m_executor(executor),
+          m_counter(counter),
+          m_numChildren(numChildren),
+          m_workAmount(workAmount)
+    {
+    }
+
+    void run() override {
+        for (int i = 0; i < m_numChildren; i++) {
+            m_executor->start(new BurstRunnable(m_executor, m_counter, 0, m_workAmount));
+        }
+
+        volatile quint32 value = 0;
+        for (int i = 0; i < m_workAmount; i++) {
+            value = value * 1664525 + 1013904223;
+        }
+
+        m_counter.ref();
+    }
+
+private:
+    Executor *m_executor;
+    QAtomicInt &m_counter;
+    int m_numChildren;
+    int m_workAmount;
+};
+
+}
+
+#endif /* __JOB_BURST_TESTING_UTILS_H */